@@ -42,12 +42,12 @@ void main(void)
 	
 	vec4 albedo = IN.colour;
 	
+	albedo.rgb = pow(albedo.rgb, vec3(2.2));
+	
 	if(hasTexture) {
-	 albedo *= texture(mainTex, IN.texCoord);
+	 albedo *= texture(mainTex, IN.texCoord); //sRGB textures are already linear
 	}
 	
-	albedo.rgb = pow(albedo.rgb, vec3(2.2));
-	
 	fragColor.rgb = albedo.rgb * 0.05f; //ambient
 	
 	fragColor.rgb += albedo.rgb * lightColour.rgb * lambert * shadow; //diffuse light
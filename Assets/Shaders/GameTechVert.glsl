@@ -1,6 +1,5 @@
 #version 400 core
 
-uniform mat4 modelMatrix 	= mat4(1.0f);
 uniform mat4 viewMatrix 	= mat4(1.0f);
 uniform mat4 projMatrix 	= mat4(1.0f);
 uniform mat4 shadowMatrix 	= mat4(1.0f);
@@ -10,7 +9,9 @@ layout(location = 1) in vec4 colour;
 layout(location = 2) in vec2 texCoord;
 layout(location = 3) in vec3 normal;
 
-uniform vec4 		objectColour = vec4(1,1,1,1);
+//Per instance, from the renderer's instance buffer
+layout(location = 8)  in mat4 modelMatrix;
+layout(location = 12) in vec4 objectColour;
 
 uniform bool hasVertexColours = false;
 
@@ -28,7 +29,7 @@ void main(void)
 	mat4 mvp 		  = (projMatrix * viewMatrix * modelMatrix);
 	mat3 normalMatrix = transpose ( inverse ( mat3 ( modelMatrix )));
 
-	OUT.shadowProj 	=  shadowMatrix * vec4 ( position,1);
+	OUT.shadowProj 	=  shadowMatrix * modelMatrix * vec4 ( position,1);
 	OUT.worldPos 	= ( modelMatrix * vec4 ( position ,1)). xyz ;
 	OUT.normal 		= normalize ( normalMatrix * normalize ( normal ));
 	
@@ -1,44 +1,40 @@
 #include "AppleObject.h"
+#include "GameObjectAllocator.h"
 
 using namespace NCL::CSC8503;
 
-AppleObject::AppleObject(const Vector3 position) {
+AppleObject::AppleObject(GameObjectAllocator& allocator, const Vector3 position) : GameObject(APPLE_OBJECT, LAYER_THREE) {
 	InitialiseApple();
-	SphereVolume* volume = new SphereVolume(0.7f);
+	SetParallelUpdate(true);
+	SphereVolume* volume = allocator.NewSphereVolume(0.7f);
 	SetBoundingVolume((CollisionVolume*)volume);
 	GetTransform().SetWorldScale(Vector3(4.0f, 4.0f, 4.0f));
 	GetTransform().SetWorldPosition(position);
-	SetRenderObject(new RenderObject(&GetTransform(), appleMesh, nullptr, appleShader));
-	SetPhysicsObject(new PhysicsObject(&GetTransform(), GetBoundingVolume()));
+	SetRenderObject(allocator.NewRenderObject(&GetTransform(), appleMesh, nullptr, appleShader));
+	SetPhysicsObject(allocator.NewPhysicsObject(&GetTransform(), GetBoundingVolume()));
 	GetPhysicsObject()->SetInverseMass(1.0f);
 	GetPhysicsObject()->InitSphereInertia();
 }
 
 AppleObject::~AppleObject() {
-	delete appleMesh;
-	delete appleTex;
-	delete appleShader;
 }
 
 void AppleObject::UpdateGameObject(float dt) {
 
 }
 
-void AppleObject::OnCollisionBegin(GameObject* o) {
-	if (o->GetName() == GOOSE_PLAYER) {
-		std::cout << "Hit" << std::endl;
-	}
+void AppleObject::HandleCollisions(const CollisionEventBuffer& events) {
+	events.ForEachWithTag(TAG_APPLE, [](const CollisionEvent& e, GameObjectHandle, GameObjectHandle other) {
+		uint8_t otherLayer = (other == e.b) ? e.layerB : e.layerA;
+		if (e.type == COLLISION_BEGIN && (otherLayer & LAYER_TWO)) { // The goose's layer
+			std::cout << "Hit" << std::endl;
+		}
+	});
 }
 
 void AppleObject::InitialiseApple() {
-	auto loadFunc = [](const string& name, OGLMesh** into) {
-		*into = new OGLMesh(name);
-		(*into)->SetPrimitiveType(GeometryPrimitive::Triangles);
-		(*into)->UploadToGPU();
-	};
+	appleMesh = (OGLMesh*)assets.Mesh("Apple.msh", AssetLoad::Streamed);
 
-	loadFunc("Apple.msh", &appleMesh);
-
-	appleTex = (OGLTexture*)TextureLoader::LoadAPITexture("checkerboard.png");
-	appleShader = new OGLShader("GameTechVert.glsl", "GameTechFrag.glsl");
+	appleTex = (OGLTexture*)assets.Texture("checkerboard.png", AssetLoad::Streamed);
+	appleShader = (OGLShader*)assets.Shader("GameTechVert.glsl", "GameTechFrag.glsl");
 }
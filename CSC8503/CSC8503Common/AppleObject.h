@@ -3,9 +3,11 @@
 #include "../../Plugins/OpenGLRendering/OGLShader.h"
 #include "../../Plugins/OpenGLRendering/OGLTexture.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/AssetManager.h"
 
 #include "GameObject.h"
 #include "SphereVolume.h"
+#include "CollisionEvents.h"
 #include "ObjectNames.h"
 #include "Layers.h"
 
@@ -13,15 +15,18 @@ namespace NCL {
 	namespace CSC8503 {
 		class AppleObject : public GameObject {
 		public:
-			AppleObject(const Vector3 position);
+			AppleObject(GameObjectAllocator& allocator, const Vector3 position);
 			virtual ~AppleObject();
 
 			void UpdateGameObject(float dt) override;
-			void OnCollisionBegin(GameObject* o) override;
+
+			//Looks through just the events involving an apple, rather than every apple hearing about every collision
+			static void HandleCollisions(const CollisionEventBuffer& events);
 
 		protected:
 			float size = 1.0f, inverseMass = 1.0f, movementSpeed = 20.0f;
 
+			AssetScope assets;
 			OGLMesh* appleMesh = nullptr;
 			OGLTexture* appleTex = nullptr;
 			OGLShader* appleShader = nullptr;		
@@ -0,0 +1,128 @@
+#include "ArchetypeStorage.h"
+#include "GameObject.h"
+
+#include <iostream>
+
+using namespace NCL;
+using namespace NCL::CSC8503;
+
+ComponentMask NCL::CSC8503::GetComponentMask(const GameObject& o) {
+	ComponentMask mask = COMPONENT_TRANSFORM;
+	if (o.GetBoundingVolume())	{ mask |= COMPONENT_VOLUME; }
+	if (o.GetPhysicsObject())	{ mask |= COMPONENT_PHYSICS; }
+	if (o.GetRenderObject())	{ mask |= COMPONENT_RENDER; }
+	if (o.GetNetworkObject())	{ mask |= COMPONENT_NETWORK; }
+	return mask;
+}
+
+uint32_t Archetype::PushRow(GameObject& o) {
+	uint32_t row = (uint32_t)objects.size();
+	objects.emplace_back(&o);
+	handles.emplace_back(o.GetWorldHandle());
+	transforms.emplace_back(&o.GetTransform());
+	if (mask & COMPONENT_VOLUME)	{ volumes.emplace_back(o.GetBoundingVolume()); }
+	if (mask & COMPONENT_PHYSICS)	{ physicsObjects.emplace_back(o.GetPhysicsObject()); }
+	if (mask & COMPONENT_RENDER)	{ renderObjects.emplace_back(o.GetRenderObject()); }
+	if (mask & COMPONENT_NETWORK)	{ networkObjects.emplace_back(o.GetNetworkObject()); }
+	return row;
+}
+
+/*
+Same swap-and-pop as the GameWorld's object list - the last row is moved
+into the removed one, and the object that got moved is returned so that
+its location can be updated (nullptr if the removed row was the last).
+*/
+GameObject* Archetype::SwapRemoveRow(uint32_t row) {
+	uint32_t last = (uint32_t)objects.size() - 1;
+	GameObject* moved = nullptr;
+	if (row != last) {
+		moved				= objects[last];
+		objects[row]		= objects[last];
+		handles[row]		= handles[last];
+		transforms[row]		= transforms[last];
+		if (mask & COMPONENT_VOLUME)	{ volumes[row]			= volumes[last]; }
+		if (mask & COMPONENT_PHYSICS)	{ physicsObjects[row]	= physicsObjects[last]; }
+		if (mask & COMPONENT_RENDER)	{ renderObjects[row]	= renderObjects[last]; }
+		if (mask & COMPONENT_NETWORK)	{ networkObjects[row]	= networkObjects[last]; }
+	}
+	objects.pop_back();
+	handles.pop_back();
+	transforms.pop_back();
+	if (mask & COMPONENT_VOLUME)	{ volumes.pop_back(); }
+	if (mask & COMPONENT_PHYSICS)	{ physicsObjects.pop_back(); }
+	if (mask & COMPONENT_RENDER)	{ renderObjects.pop_back(); }
+	if (mask & COMPONENT_NETWORK)	{ networkObjects.pop_back(); }
+	return moved;
+}
+
+void Archetype::ClearRows() {
+	objects.clear();
+	handles.clear();
+	transforms.clear();
+	volumes.clear();
+	physicsObjects.clear();
+	renderObjects.clear();
+	networkObjects.clear();
+}
+
+ArchetypeStorage::ArchetypeStorage() {
+}
+
+ArchetypeStorage::~ArchetypeStorage() {
+	for (Archetype* a : archetypes) {
+		delete a;
+	}
+}
+
+int ArchetypeStorage::GetArchetypeIndex(ComponentMask mask) {
+	for (size_t i = 0; i < archetypes.size(); ++i) {
+		if (archetypes[i]->GetMask() == mask) {
+			return (int)i;
+		}
+	}
+	archetypes.emplace_back(new Archetype(mask));
+	return (int)archetypes.size() - 1;
+}
+
+void ArchetypeStorage::Insert(GameObject& o) {
+	GameObjectHandle h = o.GetWorldHandle();
+	if (h.IsNull()) {
+		std::cout << __FUNCTION__ << " object " << o.GetName() << " has no world handle!" << std::endl;
+		return;
+	}
+	if (h.index >= locations.size()) {
+		locations.resize(h.index + 1, EntityLocation{ -1, 0 });
+	}
+	if (locations[h.index].archetype >= 0) {
+		Remove(h);
+	}
+	int archetypeIndex = GetArchetypeIndex(GetComponentMask(o));
+
+	locations[h.index].archetype	= archetypeIndex;
+	locations[h.index].row			= archetypes[archetypeIndex]->PushRow(o);
+}
+
+void ArchetypeStorage::Remove(GameObjectHandle h) {
+	if (h.index >= locations.size() || locations[h.index].archetype < 0) {
+		return;
+	}
+	EntityLocation& location = locations[h.index];
+	Archetype* a = archetypes[location.archetype];
+
+	GameObject* moved = a->SwapRemoveRow(location.row);
+	if (moved) {
+		locations[moved->GetWorldHandle().index].row = location.row;
+	}
+	location.archetype = -1;
+}
+
+void ArchetypeStorage::Refresh(GameObject& o) {
+	Insert(o); // Insert already takes the object out of its old archetype
+}
+
+void ArchetypeStorage::Clear() {
+	for (Archetype* a : archetypes) {
+		a->ClearRows();
+	}
+	locations.clear();
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "GameObjectHandle.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace NCL {
+	class CollisionVolume;
+
+	namespace CSC8503 {
+		class GameObject;
+		class Transform;
+		class PhysicsObject;
+		class RenderObject;
+		class NetworkObject;
+
+		enum ComponentFlags : uint32_t {
+			COMPONENT_TRANSFORM	= (1 << 0), // Every object has one
+			COMPONENT_VOLUME	= (1 << 1),
+			COMPONENT_PHYSICS	= (1 << 2),
+			COMPONENT_RENDER	= (1 << 3),
+			COMPONENT_NETWORK	= (1 << 4)
+		};
+		typedef uint32_t ComponentMask;
+
+		ComponentMask GetComponentMask(const GameObject& o);
+
+		/*
+		Every object with exactly the same set of components lives in the same
+		archetype, one row each, with a column of pointers per component type.
+		A system that only wants physics objects can then walk straight down
+		the physics column of each matching archetype, rather than going
+		through every object in the world and skipping the ones without one.
+		Columns for components outside of the archetype's mask are left empty.
+
+		Only the pointers are packed - the components themselves are still
+		owned by their GameObject and live wherever it allocated them, so
+		reading one is still a pointer chase per row.
+
+		The objects column is the adaptor back to the GameObject that owns the
+		row, so virtual behaviour (UpdateGameObject etc) still works as before.
+		*/
+		class Archetype {
+		public:
+			friend class ArchetypeStorage;
+
+			Archetype(ComponentMask mask) {
+				this->mask = mask;
+			}
+
+			ComponentMask GetMask() const { return mask; }
+
+			bool Matches(ComponentMask required) const { return (mask & required) == required; }
+
+			size_t Size() const { return objects.size(); }
+
+			const std::vector<GameObject*>&				GetObjects()		const { return objects; }
+			const std::vector<GameObjectHandle>&		GetHandles()		const { return handles; }
+			const std::vector<Transform*>&				GetTransforms()		const { return transforms; }
+			const std::vector<const CollisionVolume*>&	GetVolumes()		const { return volumes; }
+			const std::vector<PhysicsObject*>&			GetPhysicsObjects()	const { return physicsObjects; }
+			const std::vector<RenderObject*>&			GetRenderObjects()	const { return renderObjects; }
+			const std::vector<NetworkObject*>&			GetNetworkObjects()	const { return networkObjects; }
+
+		protected:
+			uint32_t	PushRow(GameObject& o);
+			GameObject* SwapRemoveRow(uint32_t row);
+			void		ClearRows();
+
+			ComponentMask mask;
+
+			std::vector<GameObject*>			objects;
+			std::vector<GameObjectHandle>		handles;
+			std::vector<Transform*>				transforms;
+			std::vector<const CollisionVolume*>	volumes;
+			std::vector<PhysicsObject*>			physicsObjects;
+			std::vector<RenderObject*>			renderObjects;
+			std::vector<NetworkObject*>			networkObjects;
+		};
+
+		/*
+		Owns the world's archetypes, and keeps track of which archetype and row
+		each object is in, indexed by its world handle. Archetypes are only ever
+		emptied, never destroyed, so their columns keep their capacity between
+		levels.
+		*/
+		class ArchetypeStorage {
+		public:
+			ArchetypeStorage();
+			~ArchetypeStorage();
+
+			//The object must already have a valid world handle
+			void Insert(GameObject& o);
+			void Remove(GameObjectHandle h);
+
+			//Moves the object to the right archetype after its components have changed
+			void Refresh(GameObject& o);
+
+			void Clear();
+
+			//Calls f(Archetype&) for every non-empty archetype with at least the required components
+			template<typename Func>
+			void ForEach(ComponentMask required, Func f) {
+				for (Archetype* a : archetypes) {
+					if (a->Size() > 0 && a->Matches(required)) {
+						f(*a);
+					}
+				}
+			}
+
+			size_t GetArchetypeCount() const { return archetypes.size(); }
+
+		protected:
+			struct EntityLocation {
+				int			archetype; // -1 if not stored
+				uint32_t	row;
+			};
+
+			int GetArchetypeIndex(ComponentMask mask);
+
+			std::vector<Archetype*>		archetypes;
+			std::vector<EntityLocation>	locations;
+		};
+	}
+}
@@ -5,14 +5,13 @@
 #include "SphereVolume.h"
 #include "../../Common/Vector2.h"
 #include "../../Common/Window.h"
+#include "../../Common/Input.h"
 #include "../../Common/Maths.h"
 
 #include <list>
 
 #include "../CSC8503Common/Simplex.h"
 
-#include "Debug.h"
-
 using namespace NCL;
 
 bool CollisionDetection::RayPlaneIntersection(const Ray&r, const Plane&p, RayCollision& collisions) {
@@ -287,9 +286,7 @@ Vector3 CollisionDetection::Unproject(const Vector3& screenPos, const Camera& ca
 	float aspect = screenSize.x / screenSize.y, fov = cam.GetFieldOfVision(), nearPlane = cam.GetNearPlane(), farPlane  = cam.GetFarPlane();
 
 	// Create our inverted matrix! Note how that to get a correct inverse matrix, the order of matrices used to form it are inverted, too.
-	Matrix4 invVP = GenerateInverseView(cam) * GenerateInverseProjection(aspect, fov, nearPlane, farPlane), test1 = GenerateInverseView(cam), 
-			test2 = cam.BuildViewMatrix().Inverse(), proj = cam.BuildProjectionMatrix(aspect), test4 = cam.BuildProjectionMatrix(aspect).Inverse(), 
-			test3 = GenerateInverseProjection(aspect, fov, nearPlane, farPlane);
+	Matrix4 invVP = GenerateInverseView(cam) * GenerateInverseProjection(aspect, fov, nearPlane, farPlane);
 
 	/* Our mouse position x and y values are in 0 to screen dimensions range, so we need to turn them into the -1 to 1 axis range of clip space.
 	We can do that by dividing the mouse values by the width and height of the screen (giving us a range of 0.0 to 1.0), multiplying by 2 (0.0 to 2.0)
@@ -304,7 +301,7 @@ Vector3 CollisionDetection::Unproject(const Vector3& screenPos, const Camera& ca
 }
 
 Ray CollisionDetection::BuildRayFromMouse(const Camera& cam) {
-	Vector2 screenMouse = Window::GetMouse()->GetAbsolutePosition(), screenSize = Window::GetWindow()->GetScreenSize();
+	Vector2 screenMouse = Input::GetMouse()->GetAbsolutePosition(), screenSize = Window::GetWindow()->GetScreenSize();
 
 	// We remove the y axis mouse position from height as OpenGL is 'upside down', and thinks the bottom left is the origin, instead of the top left!
 	Vector3 nearPos = Vector3(screenMouse.x, screenSize.y - screenMouse.y, -0.99999f);
@@ -337,9 +334,9 @@ Matrix4 CollisionDetection::GenerateInverseProjection(float aspect, float fov, f
 	return m;
 }
 
-// And here's how we generate an inverse view matrix. It's pretty much an exact inversion of the BuildViewMatrix function of the Camera class!
+// And here's how we generate an inverse view matrix. The camera keeps one cached alongside its view matrix, built with a rigid inverse!
 Matrix4 CollisionDetection::GenerateInverseView(const Camera &c) {
-	return Matrix4::Translation(c.GetPosition()) * Matrix4::Rotation(c.GetYaw(), Vector3(0, 1, 0)) * Matrix4::Rotation(c.GetPitch(), Vector3(1, 0, 0));
+	return c.GetInverseViewMatrix();
 }
 
 
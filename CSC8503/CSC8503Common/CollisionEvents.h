@@ -0,0 +1,83 @@
+#pragma once
+#include "CollisionDetection.h"
+#include "GameObjectHandle.h"
+#include "ObjectNames.h"
+
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		enum CollisionEventType : uint8_t {
+			COLLISION_BEGIN,
+			COLLISION_END
+		};
+
+		/*
+		One pair of objects starting or stopping touching. The tags and layers
+		are copied in when the event is made, so that consumers can filter out
+		the events they don't care about without looking the objects up.
+		*/
+		struct CollisionEvent {
+			GameObjectHandle	a;
+			GameObjectHandle	b;
+			ObjectTag			tagA;
+			ObjectTag			tagB;
+			uint8_t				layerA;
+			uint8_t				layerB;
+			CollisionEventType	type;
+			CollisionDetection::ContactPoint contact;
+		};
+
+		/*
+		The PhysicsSystem fills one of these in as it steps, rather than calling
+		into gameplay code from the middle of the physics update. Gameplay then
+		reads through it afterwards, as one contiguous batch. Nothing in here
+		modifies the buffer, so several consumers can read it at once.
+		*/
+		class CollisionEventBuffer {
+		public:
+			void Clear() { events.clear(); }
+
+			void Add(const CollisionDetection::CollisionInfo& info, CollisionEventType type) {
+				CollisionEvent e;
+				e.a			= info.a->GetWorldHandle();
+				e.b			= info.b->GetWorldHandle();
+				e.tagA		= info.a->GetTag();
+				e.tagB		= info.b->GetTag();
+				e.layerA	= info.a->GetLayer();
+				e.layerB	= info.b->GetLayer();
+				e.type		= type;
+				e.contact	= info.point;
+				events.emplace_back(e);
+			}
+
+			const std::vector<CollisionEvent>& GetEvents() const { return events; }
+			size_t Size() const { return events.size(); }
+
+			/*
+			Calls f(event, self, other) for every event involving an object with
+			the given tag - self is always the tagged object, whichever side of
+			the pair it was on. If both objects have the tag, f is called twice.
+			*/
+			template<typename Func>
+			void ForEachWithTag(ObjectTag tag, Func f) const {
+				for (const CollisionEvent& e : events) {
+					if (e.tagA == tag) { f(e, e.a, e.b); }
+					if (e.tagB == tag) { f(e, e.b, e.a); }
+				}
+			}
+
+			//As above, but for any object on one of the layers in the mask
+			template<typename Func>
+			void ForEachWithLayer(uint8_t layerMask, Func f) const {
+				for (const CollisionEvent& e : events) {
+					if (e.layerA & layerMask) { f(e, e.a, e.b); }
+					if (e.layerB & layerMask) { f(e, e.b, e.a); }
+				}
+			}
+
+		protected:
+			std::vector<CollisionEvent> events;
+		};
+	}
+}
@@ -4,18 +4,18 @@ using namespace NCL;
 
 OGLRenderer* Debug::renderer = nullptr;
 
-std::vector<Debug::DebugStringEntry>	Debug::stringEntries;
-std::vector<Debug::DebugLineEntry>		Debug::lineEntries;
+FrameVector<Debug::DebugStringEntry>	Debug::stringEntries;
+FrameVector<Debug::DebugLineEntry>		Debug::lineEntries;
 
 
 void Debug::Print(const std::string& text, const Vector2&pos, const Vector4& colour) {
 	DebugStringEntry newEntry;
 
-	newEntry.data		= text;
+	newEntry.data.assign(text.c_str(), text.length());
 	newEntry.position	= pos;
 	newEntry.colour		= colour;
 
-	stringEntries.emplace_back(newEntry);
+	stringEntries.emplace_back(std::move(newEntry));
 }
 
 void Debug::DrawLine(const Vector3& startpoint, const Vector3& endpoint, const Vector4& colour) {
@@ -29,17 +29,14 @@ void Debug::DrawLine(const Vector3& startpoint, const Vector3& endpoint, const V
 }
 
 void Debug::FlushRenderables() {
-	if (!renderer) {
-		return;
+	if (renderer) {
+		for (const auto& i : stringEntries) {
+			renderer->DrawString(i.data.c_str(), i.data.length(), i.position, i.colour);
+		}
+		for (const auto& i : lineEntries) {
+			renderer->DrawLine(i.start, i.end, i.colour);
+		}
 	}
-	for (const auto& i : stringEntries) {
-		renderer->DrawString(i.data, i.position);
-	}
-
-	for (const auto& i : lineEntries) {
-		renderer->DrawLine(i.start, i.end, i.colour);
-	}
-
-	stringEntries.clear();
-	lineEntries.clear();
+	ResetFrameContainer(stringEntries);
+	ResetFrameContainer(lineEntries);
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../Plugins/OpenGLRendering/OGLRenderer.h"
+#include "../../Common/FrameAllocator.h"
 #include <vector>
 #include <string>
 
@@ -18,7 +19,7 @@ namespace NCL {
 
 	protected:
 		struct DebugStringEntry {
-			std::string	data;
+			FrameString	data;
 			Vector2 position;
 			Vector4 colour;
 		};
@@ -32,8 +33,8 @@ namespace NCL {
 		Debug() {}
 		~Debug() {}
 
-		static std::vector<DebugStringEntry>	stringEntries;
-		static std::vector<DebugLineEntry>	lineEntries;
+		static FrameVector<DebugStringEntry>	stringEntries;
+		static FrameVector<DebugLineEntry>		lineEntries;
 
 		static OGLRenderer* renderer;
 	};
@@ -1,4 +1,5 @@
 #include "GameClient.h"
+#include "../../Common/Profiler.h"
 #include <iostream>
 #include <string>
 
@@ -32,6 +33,7 @@ bool GameClient::Connect(uint8_t a, uint8_t b, uint8_t c, uint8_t d, int portNum
 }
 
 void GameClient::UpdateClient() {
+	PROFILE_SCOPE("GameClient::UpdateClient");
 	if (netHandle == nullptr) { return; }
 	//Handle all incoming packets & send any packets awaiting dispatch
 	ENetEvent event;
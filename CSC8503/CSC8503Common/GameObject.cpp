@@ -1,25 +1,114 @@
 #include "GameObject.h"
 #include "CollisionDetection.h"
+#include "GameObjectAllocator.h"
+#include "GameWorld.h"
 
 using namespace NCL::CSC8503;
 
 GameObject::GameObject(string objectName, uint8_t layerNumber)	{
 	name			= objectName;
+	tag				= ObjectTagFromName(objectName.c_str());
 	layer			= layerNumber;
 	isActive		= true;
+	parallelUpdate	= false;
 	boundingVolume	= nullptr;
 	physicsObject	= nullptr;
 	renderObject	= nullptr;
 	networkObject	= nullptr;
+	allocator		= nullptr;
+	owningWorld		= nullptr;
 }
 
 GameObject::~GameObject() {
+	if (allocator) {
+		allocator->FreeComponents(*this);
+		return;
+	}
 	delete boundingVolume;
 	delete physicsObject;
 	delete renderObject;
 	delete networkObject;
 }
 
+void GameObject::SetBoundingVolume(CollisionVolume* vol) {
+	if (boundingVolume == vol) {
+		return;
+	}
+	boundingVolume = vol;
+	ComponentsChanged();
+}
+
+void GameObject::SetRenderObject(RenderObject* newObject) {
+	if (renderObject == newObject) {
+		return;
+	}
+	renderObject = newObject;
+	ComponentsChanged();
+}
+
+void GameObject::SetPhysicsObject(PhysicsObject* newObject) {
+	if (physicsObject == newObject) {
+		return;
+	}
+	physicsObject = newObject;
+	ComponentsChanged();
+}
+
+void GameObject::SetNetworkObject(NetworkObject* newObject) {
+	if (networkObject == newObject) {
+		return;
+	}
+	networkObject = newObject;
+	ComponentsChanged();
+}
+
+void GameObject::ComponentsChanged() {
+	if (owningWorld) {
+		owningWorld->OnComponentsChanged(*this);
+	}
+}
+
+namespace {
+	const uint8_t HAS_PHYSICS	= 1 << 0;
+	const uint8_t HAS_RENDER	= 1 << 1;
+}
+
+void GameObject::SaveState(WorldSnapshot& s) const {
+	uint8_t components = (physicsObject ? HAS_PHYSICS : 0) | (renderObject ? HAS_RENDER : 0);
+	s.Write(components);
+	s.Write(isActive);
+	s.Write(layer);
+	transform.SaveState(s);
+	if (physicsObject) {
+		physicsObject->SaveState(s);
+	}
+	if (renderObject) {
+		s.Write(renderObject->GetColour());
+	}
+}
+
+bool GameObject::LoadState(WorldSnapshot& s) {
+	uint8_t components = 0;
+	if (!s.Read(components) || components != ((physicsObject ? HAS_PHYSICS : 0) | (renderObject ? HAS_RENDER : 0))) {
+		return false;
+	}
+	if (!s.Read(isActive) || !s.Read(layer) || !transform.LoadState(s)) {
+		return false;
+	}
+	if (physicsObject && !physicsObject->LoadState(s)) {
+		return false;
+	}
+	if (renderObject) {
+		Vector4 colour;
+		if (!s.Read(colour)) {
+			return false;
+		}
+		renderObject->SetColour(colour);
+	}
+	UpdateBroadphaseAABB();
+	return true;
+}
+
 void GameObject::UpdateGameObject(float dt) {
 	/*std::cout << "I am a game object" << std::endl;*/
 }
@@ -5,25 +5,40 @@
 #include "PhysicsObject.h"
 #include "RenderObject.h"
 #include "NetworkObject.h"
+#include "GameObjectHandle.h"
 
 #include <vector>
 
 #include "Layers.h"
+#include "ObjectNames.h"
 
 using std::vector;
 
 namespace NCL {
 	namespace CSC8503 {
 		class NetworkObject;
+		class GameObjectAllocator;
+		class GameWorld;
 
 		class GameObject {
 		public:
+			friend class GameObjectAllocator;
+			friend class GameWorld;
+
 			GameObject(string name = "", uint8_t layerNumber = LAYER_ZERO);
-			~GameObject();
+			virtual ~GameObject();
 
 			virtual void UpdateGameObject(float dt);
 
-			void SetBoundingVolume(CollisionVolume* vol) { boundingVolume = vol; }
+			/*
+			Objects whose UpdateGameObject only writes to their own state can be
+			updated across the job threads - anything touching input, the camera,
+			or other objects must leave this off.
+			*/
+			bool CanUpdateInParallel() const { return parallelUpdate; }
+			void SetParallelUpdate(bool state) { parallelUpdate = state; }
+
+			void SetBoundingVolume(CollisionVolume* vol);
 
 			const CollisionVolume* GetBoundingVolume() const { return boundingVolume; }
 
@@ -39,18 +54,40 @@ namespace NCL {
 
 			NetworkObject* GetNetworkObject() const { return networkObject; }
 
-			void SetRenderObject(RenderObject* newObject) { renderObject = newObject; }
+			//These let the world know to move the object to its new archetype - setting
+			//the component it already has does nothing, so can be done every frame
+			void SetRenderObject(RenderObject* newObject);
+
+			void SetPhysicsObject(PhysicsObject* newObject);
+
+			void SetNetworkObject(NetworkObject* newObject);
+
+			//The pool this object was made from, or nullptr if it was made with new
+			GameObjectAllocator* GetAllocator() const { return allocator; }
 
-			void SetPhysicsObject(PhysicsObject* newObject) { physicsObject = newObject; }
+			//This object's handle in the world it was added to - null until it is added
+			GameObjectHandle GetWorldHandle() const { return worldHandle; }
 
 			uint8_t GetLayer() const { return layer; }
 
 			const string& GetName() const { return name; }
 
+			//Worked out from the name when the object is made - cheaper to compare than the name itself
+			ObjectTag GetTag() const { return tag; }
+
 			virtual void OnCollisionBegin(GameObject* otherObject) {}
 
 			virtual void OnCollisionEnd(GameObject* otherObject) {}
 
+			/*
+			Writes out everything about this object that can change during a
+			round, so that LoadState can put it back in place later. Subclasses
+			with gameplay state of their own add it after the base class's.
+			LoadState returns false if the snapshot doesn't match this object.
+			*/
+			virtual void SaveState(WorldSnapshot& s) const;
+			virtual bool LoadState(WorldSnapshot& s);
+
 			bool GetBroadphaseAABB(Vector3&outsize) const;
 
 			void UpdateBroadphaseAABB();
@@ -63,11 +100,21 @@ namespace NCL {
 			RenderObject*		renderObject;
 			NetworkObject*		networkObject;
 
+			GameObjectAllocator* allocator;
+			GameObjectHandle	worldHandle;
+
 			bool isActive;
+			bool parallelUpdate;
 			uint8_t layer;
+			ObjectTag tag;
 			string name;
 
 			Vector3 broadphaseAABB;
+
+		private:
+			void ComponentsChanged();
+
+			GameWorld* owningWorld; // Set while the object is in a world
 		};
 	}
 }
@@ -0,0 +1,129 @@
+#include "GameObjectAllocator.h"
+
+using namespace NCL;
+using namespace NCL::CSC8503;
+
+GameObjectAllocator::GameObjectAllocator() : gameObjects(256), aabbVolumes(256), sphereVolumes(64),
+	renderObjects(256), physicsObjects(256), networkObjects(32) {
+}
+
+GameObjectAllocator::~GameObjectAllocator() {
+	ReleaseAll();
+	for (auto& i : subclassPools) {
+		delete i.second;
+	}
+}
+
+GameObject* GameObjectAllocator::NewGameObject(string name, uint8_t layerNumber) {
+	GameObject* o = gameObjects.Allocate(name, layerNumber);
+	o->allocator = this;
+	return o;
+}
+
+AABBVolume* GameObjectAllocator::NewAABBVolume(const Vector3& halfDims) {
+	return aabbVolumes.Allocate(halfDims);
+}
+
+SphereVolume* GameObjectAllocator::NewSphereVolume(float radius) {
+	return sphereVolumes.Allocate(radius);
+}
+
+RenderObject* GameObjectAllocator::NewRenderObject(Transform* parentTransform, MeshGeometry* mesh, TextureBase* tex, ShaderBase* shader) {
+	return renderObjects.Allocate(parentTransform, mesh, tex, shader);
+}
+
+PhysicsObject* GameObjectAllocator::NewPhysicsObject(Transform* parentTransform, const CollisionVolume* parentVolume, bool phasing) {
+	return physicsObjects.Allocate(parentTransform, parentVolume, phasing);
+}
+
+NetworkObject* GameObjectAllocator::NewNetworkObject(GameObject& o, int id) {
+	return networkObjects.Allocate(o, id);
+}
+
+void GameObjectAllocator::FreeGameObject(GameObject* o) {
+	if (gameObjects.Owns(o)) {
+		gameObjects.Free(o); // ~GameObject calls back into FreeComponents
+		return;
+	}
+	for (auto& i : subclassPools) {
+		if (i.second->Owns(o)) {
+			i.second->Free(o);
+			return;
+		}
+	}
+	delete o;
+}
+
+bool GameObjectAllocator::Owns(const GameObject* o) const {
+	if (gameObjects.Owns(o)) {
+		return true;
+	}
+	for (auto& i : subclassPools) {
+		if (i.second->Owns(o)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+size_t GameObjectAllocator::GetLiveObjectCount() const {
+	size_t count = gameObjects.GetLiveCount();
+	for (auto& i : subclassPools) {
+		count += i.second->GetLiveCount();
+	}
+	return count;
+}
+
+/*
+Components can be swapped out after creation (ObsticalPlayer does this with its
+RenderObject), so anything not actually from one of our pools is just deleted.
+*/
+void GameObjectAllocator::FreeComponents(GameObject& o) {
+	CollisionVolume* volume = o.boundingVolume;
+	if (volume) {
+		if (volume->type == VolumeType::AABB && aabbVolumes.Owns((AABBVolume*)volume)) {
+			aabbVolumes.Free((AABBVolume*)volume);
+		}
+		else if (volume->type == VolumeType::Sphere && sphereVolumes.Owns((SphereVolume*)volume)) {
+			sphereVolumes.Free((SphereVolume*)volume);
+		}
+		else {
+			delete volume;
+		}
+	}
+	if (renderObjects.Owns(o.renderObject)) {
+		renderObjects.Free(o.renderObject);
+	}
+	else {
+		delete o.renderObject;
+	}
+	if (physicsObjects.Owns(o.physicsObject)) {
+		physicsObjects.Free(o.physicsObject);
+	}
+	else {
+		delete o.physicsObject;
+	}
+	if (networkObjects.Owns(o.networkObject)) {
+		networkObjects.Free(o.networkObject);
+	}
+	else {
+		delete o.networkObject;
+	}
+
+	o.boundingVolume	= nullptr;
+	o.renderObject		= nullptr;
+	o.physicsObject		= nullptr;
+	o.networkObject		= nullptr;
+}
+
+void GameObjectAllocator::ReleaseAll() {
+	gameObjects.ReleaseAll(); // Objects first, so their components are handed back
+	for (auto& i : subclassPools) {
+		i.second->ReleaseAll();
+	}
+	aabbVolumes.ReleaseAll();
+	sphereVolumes.ReleaseAll();
+	renderObjects.ReleaseAll();
+	physicsObjects.ReleaseAll();
+	networkObjects.ReleaseAll();
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "../../Common/ObjectPool.h"
+
+#include "GameObject.h"
+#include "AABBVolume.h"
+#include "SphereVolume.h"
+#include "RenderObject.h"
+#include "PhysicsObject.h"
+#include "NetworkObject.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Hands out GameObjects and their components from typed pools, instead of
+		each one being a separate trip to the heap. Objects made here remember
+		which allocator they came from, and give their components back to it
+		when destroyed. The GameWorld keeps one of these per level, and releases
+		the whole lot in one go when the level is cleared.
+		*/
+		class GameObjectAllocator {
+		public:
+			GameObjectAllocator();
+			~GameObjectAllocator();
+
+			GameObjectAllocator(const GameObjectAllocator&) = delete;
+			GameObjectAllocator& operator=(const GameObjectAllocator&) = delete;
+
+			GameObject*		NewGameObject(string name = "", uint8_t layerNumber = LAYER_ZERO);
+
+			/*
+			GameObject subclasses get a pool per type. Their constructors take
+			this allocator first, so that they can make their components from
+			it too.
+			*/
+			template<class T, typename... Args>
+			T* NewGameObject(Args&&... args) {
+				T* o = GetSubclassPool<T>().Allocate(*this, std::forward<Args>(args)...);
+				o->allocator = this;
+				return o;
+			}
+
+			AABBVolume*		NewAABBVolume(const Vector3& halfDims);
+			SphereVolume*	NewSphereVolume(float radius);
+			RenderObject*	NewRenderObject(Transform* parentTransform, MeshGeometry* mesh, TextureBase* tex, ShaderBase* shader);
+			PhysicsObject*	NewPhysicsObject(Transform* parentTransform, const CollisionVolume* parentVolume, bool phasing = false);
+			NetworkObject*	NewNetworkObject(GameObject& o, int id);
+
+			//Destroys a GameObject made by this allocator, along with its components
+			void FreeGameObject(GameObject* o);
+
+			//Used by GameObject's destructor to hand its components back
+			void FreeComponents(GameObject& o);
+
+			//Destroys everything made by this allocator, keeping the memory for reuse
+			void ReleaseAll();
+
+			bool Owns(const GameObject* o) const;
+
+			size_t GetLiveObjectCount() const;
+
+		protected:
+			struct SubclassPoolBase {
+				virtual ~SubclassPoolBase() {}
+				virtual bool	Owns(const GameObject* o) const = 0;
+				virtual void	Free(GameObject* o)		= 0;
+				virtual void	ReleaseAll()			= 0;
+				virtual size_t	GetLiveCount() const	= 0;
+			};
+
+			template<class T>
+			struct SubclassPool : public SubclassPoolBase {
+				SubclassPool() : pool(16) {}
+
+				bool	Owns(const GameObject* o) const override { return pool.Owns((const T*)o); }
+				void	Free(GameObject* o)			override { pool.Free((T*)o); }
+				void	ReleaseAll()				override { pool.ReleaseAll(); }
+				size_t	GetLiveCount() const		override { return pool.GetLiveCount(); }
+
+				ObjectPool<T> pool;
+			};
+
+			//The address of a static local is unique per type, so it makes a cheap key
+			template<class T>
+			static const void* SubclassKey() {
+				static const char key = 0;
+				return &key;
+			}
+
+			template<class T>
+			ObjectPool<T>& GetSubclassPool() {
+				const void* key = SubclassKey<T>();
+				for (auto& i : subclassPools) {
+					if (i.first == key) {
+						return ((SubclassPool<T>*)i.second)->pool;
+					}
+				}
+				SubclassPool<T>* p = new SubclassPool<T>();
+				subclassPools.emplace_back(key, p);
+				return p->pool;
+			}
+
+			std::vector<std::pair<const void*, SubclassPoolBase*>> subclassPools;
+
+			ObjectPool<GameObject>		gameObjects;
+			ObjectPool<AABBVolume>		aabbVolumes;
+			ObjectPool<SphereVolume>	sphereVolumes;
+			ObjectPool<RenderObject>	renderObjects;
+			ObjectPool<PhysicsObject>	physicsObjects;
+			ObjectPool<NetworkObject>	networkObjects;
+		};
+	}
+}
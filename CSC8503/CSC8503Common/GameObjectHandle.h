@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		A weak reference to an object in the GameWorld. The index picks a slot in
+		the world's slot table, and the generation must match the slot's current
+		generation for the handle to still be valid - every time a slot's object
+		is removed, its generation goes up, so any handles still pointing at it
+		go stale rather than dangling. Generation 0 is never handed out, so a
+		default constructed handle is always null.
+		*/
+		struct GameObjectHandle {
+			uint32_t index;
+			uint32_t generation;
+
+			GameObjectHandle() {
+				index		= 0;
+				generation	= 0;
+			}
+
+			GameObjectHandle(uint32_t index, uint32_t generation) {
+				this->index			= index;
+				this->generation	= generation;
+			}
+
+			bool IsNull() const { return generation == 0; }
+
+			bool operator==(const GameObjectHandle& other) const {
+				return index == other.index && generation == other.generation;
+			}
+
+			bool operator!=(const GameObjectHandle& other) const {
+				return !(*this == other);
+			}
+		};
+	}
+}
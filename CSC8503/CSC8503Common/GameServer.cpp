@@ -1,5 +1,6 @@
 #include "GameServer.h"
 #include "GameWorld.h"
+#include "../../Common/Profiler.h"
 #include <iostream>
 
 using namespace NCL;
@@ -60,6 +61,7 @@ bool GameServer::SendGlobalPacket(GamePacket& packet) {
 }
 
 void GameServer::UpdateServer() {
+	PROFILE_SCOPE("GameServer::UpdateServer");
 	if (!netHandle) {
 		return;
 	}
@@ -3,7 +3,9 @@
 #include "Constraint.h"
 #include "CollisionDetection.h"
 #include "../../Common/Camera.h"
+#include "../../Common/Profiler.h"
 #include <algorithm>
+#include <cassert>
 
 using namespace NCL;
 using namespace NCL::CSC8503;
@@ -14,6 +16,9 @@ GameWorld::GameWorld()	{
 
 	shuffleConstraints	= false;
 	shuffleObjects		= false;
+
+	jobSystem = nullptr;
+	commandBuffers.resize(1);
 }
 
 GameWorld::~GameWorld()	{
@@ -21,44 +26,164 @@ GameWorld::~GameWorld()	{
 }
 
 void GameWorld::Clear() {
+	for (auto& i : gameObjects) {
+		i->owningWorld = nullptr;
+		i->worldHandle = GameObjectHandle();
+	}
 	gameObjects.clear();
-	additionStorage.clear();
+	for (auto& buffer : commandBuffers) {
+		buffer.additions.clear();
+		buffer.removals.clear();
+		buffer.pendingRemovals.clear();
+	}
 	constraints.clear();
+	componentChanges.clear();
+	archetypes.Clear();
+
+	// Every slot goes back on the free list, and any handles still out there go stale
+	freeSlots.clear();
+	for (size_t i = objectSlots.size(); i > 0; --i) {
+		ObjectSlot& slot = objectSlots[i - 1];
+		if (slot.object) {
+			slot.object = nullptr;
+			if (++slot.generation == 0) { slot.generation = 1; }
+		}
+		freeSlots.emplace_back((uint32_t)(i - 1));
+	}
 }
 
 void GameWorld::ClearAndErase() {
-	for (auto& i : gameObjects) { delete i; }
+	for (auto& i : gameObjects) { 
+		if (!i->GetAllocator()) { delete i; } // Pooled objects go all at once below
+	}
 	for (auto& i : constraints) { delete i; }
+	levelAllocator.ReleaseAll();
+	gameObjects.clear(); // Nothing left in here to detach
 	Clear();
 }
 
-void GameWorld::AddGameObject(GameObject* o) {
+GameObjectHandle GameWorld::AddGameObject(GameObject* o) {
+	if (GetGameObject(o->worldHandle) == o) {
+		return o->worldHandle; // Already in this world
+	}
+	uint32_t index;
+	if (!freeSlots.empty()) {
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else {
+		index = (uint32_t)objectSlots.size();
+		objectSlots.emplace_back(ObjectSlot{ nullptr, 1, 0 });
+	}
+	ObjectSlot& slot	= objectSlots[index];
+	slot.object			= o;
+	slot.denseIndex		= (uint32_t)gameObjects.size();
 	gameObjects.emplace_back(o);
+
+	o->worldHandle = GameObjectHandle(index, slot.generation);
+	o->owningWorld = this;
+	archetypes.Insert(*o);
+	return o->worldHandle;
+}
+
+GameObject* GameWorld::GetGameObject(GameObjectHandle h) const {
+	if (h.IsNull() || h.index >= objectSlots.size()) {
+		return nullptr;
+	}
+	const ObjectSlot& slot = objectSlots[h.index];
+	return slot.generation == h.generation ? slot.object : nullptr;
+}
+
+/*
+Removes the object in O(1) - the last object in the dense array is moved
+into the removed object's place, and its slot is pointed at its new index.
+The removed slot's generation is bumped so that old handles to it go stale,
+and the object itself is destroyed. Returns false for a stale handle, which
+makes removing the same object twice harmless.
+*/
+bool GameWorld::RemoveGameObject(GameObjectHandle h) {
+	GameObject* o = GetGameObject(h);
+	if (!o) {
+		return false;
+	}
+	archetypes.Remove(h);
+
+	ObjectSlot& slot	= objectSlots[h.index];
+	uint32_t gap		= slot.denseIndex;
+	GameObject* last	= gameObjects.back();
+
+	gameObjects[gap] = last;
+	objectSlots[last->worldHandle.index].denseIndex = gap;
+	gameObjects.pop_back();
+
+	slot.object = nullptr;
+	if (++slot.generation == 0) { slot.generation = 1; }
+	freeSlots.emplace_back(h.index);
+
+	o->worldHandle = GameObjectHandle();
+	o->owningWorld = nullptr;
+	DeleteGameObject(o);
+	return true;
 }
 
 void GameWorld::RemoveGameObject(GameObject* o) {
-	for (size_t i = 0; i < gameObjects.size(); ++i) {
-		if (gameObjects.at(i) == o) {
-			gameObjects.erase(gameObjects.begin() + i);			
-			break;
+	if (!RemoveGameObject(o->worldHandle)) {
+		DeleteGameObject(o); // Was never added to this world
+	}
+}
+
+void GameWorld::DeleteGameObject(GameObject* o) {
+	if (o->GetAllocator()) {
+		o->GetAllocator()->FreeGameObject(o);
+	}
+	else {
+		delete o;
+	}
+}
+
+void GameWorld::OnComponentsChanged(GameObject& o) {
+	componentChanges.emplace_back(o.worldHandle);
+}
+
+void GameWorld::FlushComponentChanges() {
+	for (auto& h : componentChanges) {
+		GameObject* o = GetGameObject(h);
+		if (o) {
+			archetypes.Refresh(*o);
 		}
 	}
-	delete o;
+	componentChanges.clear();
+}
+
+void GameWorld::SetJobSystem(JobSystem* jobs) {
+	jobSystem = jobs;
+	commandBuffers.resize(jobs ? jobs->GetThreadCount() : 1);
+}
+
+GameWorld::ObjectCommandBuffer& GameWorld::GetCommandBuffer() {
+	bool ownThread = jobSystem && jobSystem->IsRegisteredThread();
+	return commandBuffers[ownThread ? JobSystem::GetThreadIndex() : 0];
 }
 
 void GameWorld::AddAdditionStorage(GameObject* o) {
-	additionStorage.emplace_back(o);
+	GetCommandBuffer().additions.emplace_back(o);
 }
 
 void GameWorld::AddRemovalStorage(GameObject* o) {
-	removalStorage.emplace_back(o);
+	if (o->GetWorldHandle().IsNull()) {
+		GetCommandBuffer().pendingRemovals.emplace_back(o); // Added and removed in the same frame
+	}
+	else {
+		GetCommandBuffer().removals.emplace_back(o->GetWorldHandle());
+	}
 }
 
 void GameWorld::EraseStorage() {
-	//for (auto& i : additionStorage) { delete i; }
-	//for (auto& i : removalStorage) { delete i; }
-	additionStorage.clear();
-	removalStorage.clear();
+	for (auto& buffer : commandBuffers) {
+		buffer.additions.clear();
+		buffer.removals.clear();
+		buffer.pendingRemovals.clear();
+	}
 }
 
 void GameWorld::GetObjectIterators(GameObjectIterator& first, GameObjectIterator& last) const {
@@ -66,36 +191,108 @@ void GameWorld::GetObjectIterators(GameObjectIterator& first, GameObjectIterator
 	last  = gameObjects.end();
 }
 
-void GameWorld::OperateOnContents(GameObjectFunc f) {
-	for (GameObject* g : gameObjects) { f(g); }
-}
-
 void GameWorld::UpdateWorld(float dt) {	
+	PROFILE_SCOPE("GameWorld::UpdateWorld");
 	UpdateTransforms();		
 	UpdateGameObjects(dt);
 	UpdateObjectList();
 }
 
+/*
+Objects removed since the event was made just have stale handles by now,
+so their events are skipped rather than calling into freed memory.
+*/
+void GameWorld::DispatchCollisionEvents(const CollisionEventBuffer& events) {
+	for (const CollisionEvent& e : events.GetEvents()) {
+		GameObject* a = GetGameObject(e.a);
+		GameObject* b = GetGameObject(e.b);
+		if (!a || !b) {
+			continue;
+		}
+		if (e.type == COLLISION_BEGIN) {
+			a->OnCollisionBegin(b);
+			b->OnCollisionBegin(a);
+		}
+		else {
+			a->OnCollisionEnd(b);
+			b->OnCollisionEnd(a);
+		}
+	}
+}
+
+/*
+Objects that have said they only touch their own state are updated in
+parallel, after everything else has been updated on this thread - so
+they can safely read (but not write) the objects updated serially.
+*/
 void GameWorld::UpdateGameObjects(float dt) {
+	PROFILE_SCOPE("GameWorld::UpdateGameObjects");
+	parallelUpdates.clear();
 	for (auto& i : gameObjects) {
+		if (jobSystem && i->CanUpdateInParallel()) {
+			parallelUpdates.emplace_back(i);
+			continue;
+		}
 		i->UpdateGameObject(dt); 
 	}
+	if (!parallelUpdates.empty()) {
+		jobSystem->ParallelFor(parallelUpdates.size(), 8, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				parallelUpdates[i]->UpdateGameObject(dt);
+			}
+		});
+	}
 }
 
+// Nothing is parented yet - a child's matrix would need its parent's to be finished first
 void GameWorld::UpdateTransforms() {
-	for (auto& i : gameObjects) { 
-		i->GetTransform().UpdateMatrices(); 
-	}
+	PROFILE_SCOPE("GameWorld::UpdateTransforms");
+	QueryArchetypes(COMPONENT_TRANSFORM, [&](Archetype& a) {
+		const std::vector<Transform*>& transforms = a.GetTransforms();
+		if (!jobSystem) {
+			for (Transform* t : transforms) {
+				t->UpdateMatrices();
+			}
+			return;
+		}
+		jobSystem->ParallelFor(transforms.size(), 256, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				transforms[i]->UpdateMatrices();
+			}
+		});
+	});
 }
 
+/*
+Applies the frame's deferred additions and removals as one batch, going
+through each thread's command buffer in turn so the result doesn't depend
+on which thread got there first. Removals are queued as handles, so an
+object that was queued more than once only gets removed (and freed) the
+first time - after that, its handle is stale and is skipped. Objects that
+were removed before their addition was applied only get a handle once the
+additions are done, so they're turned into handles before anything is freed.
+*/
 void GameWorld::UpdateObjectList() {
-	for (auto& i : additionStorage) {
-		AddGameObject(i);
+	PROFILE_SCOPE("GameWorld::UpdateObjectList");
+	for (auto& buffer : commandBuffers) {
+		gameObjects.reserve(gameObjects.size() + buffer.additions.size());
+		for (auto& i : buffer.additions) {
+			AddGameObject(i);
+		}
+	}
+	for (auto& buffer : commandBuffers) {
+		for (auto& o : buffer.pendingRemovals) {
+			assert(!o->GetWorldHandle().IsNull() && "Object queued for removal was never queued for addition");
+			buffer.removals.emplace_back(o->GetWorldHandle());
+		}
 	}
-	for (auto& i : removalStorage) {
-		RemoveGameObject(i);
+	for (auto& buffer : commandBuffers) {
+		for (auto& h : buffer.removals) {
+			RemoveGameObject(h);
+		}
 	}
 	EraseStorage();
+	FlushComponentChanges();
 }
 
 void GameWorld::UpdateQuadTree() {
@@ -169,24 +366,17 @@ string GameWorld::OutputLevelToFile() {
 	int locationX, locationZ;
 
 	for (auto& i : gameObjects) {
-		if (i->GetName() != FLOOR_OBJECT && i->GetName() != BARRIER_OBJECT && 
-			i->GetName() != GOOSE_PLAYER && i->GetName() != OBSTICAL_PLAYER) {
-			locationX = (int)(i->GetTransform().GetWorldPosition().x + positionShift + 5.0f) / 10 - 1;
-			locationZ = (int)(i->GetTransform().GetWorldPosition().z + positionShift + 5.0f) / 10 - 1;
-
-			if (i->GetName() == CUBE_OBJECT) {
-				outputLocations[locationX][locationZ] = CUBE_SHORT;
-			}
-			else if (i->GetName() == SPHERE_OBJECT) {
-				outputLocations[locationX][locationZ] = SPHERE_SHORT;
-			}
-			else if (i->GetName() == APPLE_OBJECT) {
-				outputLocations[locationX][locationZ] = APPLE_SHORT;
-			}
-			else if (i->GetName() == KEEPER_AI) {
-				outputLocations[locationX][locationZ] = KEEPER_SHORT;
-			}
+		char shorthand;
+		switch (i->GetTag()) {
+			case TAG_CUBE:		shorthand = CUBE_SHORT;		break;
+			case TAG_SPHERE:	shorthand = SPHERE_SHORT;	break;
+			case TAG_APPLE:		shorthand = APPLE_SHORT;	break;
+			case TAG_KEEPER:	shorthand = KEEPER_SHORT;	break;
+			default:			continue; // Players, floor, barriers etc aren't saved
 		}
+		locationX = (int)(i->GetTransform().GetWorldPosition().x + positionShift + 5.0f) / 10 - 1;
+		locationZ = (int)(i->GetTransform().GetWorldPosition().z + positionShift + 5.0f) / 10 - 1;
+		outputLocations[locationX][locationZ] = shorthand;
 	}
 
 	locationX = (int)(spawnPoint.x + positionShift + 5.0f) / 10 - 1;
@@ -206,4 +396,90 @@ string GameWorld::OutputLevelToFile() {
 
 	std::cout << outputFile << std::endl;
 	return outputFile;
-}
\ No newline at end of file
+}
+
+namespace {
+	const char		SNAPSHOT_MAGIC[4]	= { 'N', 'C', 'L', 'S' };
+	const uint32_t	SNAPSHOT_VERSION	= 1;
+}
+
+/*
+Each object's state is written after its handle and the size of its state,
+so that restoring can step over an object that no longer matches.
+*/
+void GameWorld::SaveSnapshot(WorldSnapshot& snapshot) {
+	PROFILE_SCOPE("GameWorld::SaveSnapshot");
+	UpdateObjectList();
+	snapshot.Clear();
+	snapshot.WriteBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	snapshot.Write(SNAPSHOT_VERSION);
+	snapshot.Write(spawnPoint);
+	snapshot.Write(roamingPoint);
+	snapshot.Write(mainCamera->GetPosition());
+	snapshot.Write(mainCamera->GetPitch());
+	snapshot.Write(mainCamera->GetYaw());
+	snapshot.Write((uint32_t)gameObjects.size());
+
+	for (GameObject* o : gameObjects) {
+		snapshot.Write(o->GetWorldHandle());
+		size_t sizeAt = snapshot.GetSize();
+		snapshot.Write((uint32_t)0);
+		o->SaveState(snapshot);
+		uint32_t stateSize = (uint32_t)(snapshot.GetSize() - sizeAt - sizeof(uint32_t));
+		snapshot.Overwrite(sizeAt, stateSize);
+	}
+}
+
+bool GameWorld::RestoreSnapshot(WorldSnapshot& snapshot) {
+	PROFILE_SCOPE("GameWorld::RestoreSnapshot");
+	UpdateObjectList();
+	snapshot.BeginRead();
+
+	char		magic[4];
+	uint32_t	version		= 0;
+	uint32_t	objectCount	= 0;
+	Vector3		cameraPosition;
+	float		cameraPitch	= 0.0f;
+	float		cameraYaw	= 0.0f;
+	if (!snapshot.ReadBytes(magic, sizeof(magic)) || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+		!snapshot.Read(version) || version != SNAPSHOT_VERSION) {
+		std::cout << __FUNCTION__ << " snapshot isn't from this version!" << std::endl;
+		return false;
+	}
+	if (!snapshot.Read(spawnPoint) || !snapshot.Read(roamingPoint) ||
+		!snapshot.Read(cameraPosition) || !snapshot.Read(cameraPitch) || !snapshot.Read(cameraYaw) ||
+		!snapshot.Read(objectCount)) {
+		return false;
+	}
+	mainCamera->SetPosition(cameraPosition);
+	mainCamera->SetPitch(cameraPitch);
+	mainCamera->SetYaw(cameraYaw);
+
+	// Anything left in here once the snapshot has been read wasn't in it
+	unrestoredObjects.clear();
+	for (GameObject* o : gameObjects) {
+		unrestoredObjects.emplace_back(o->GetWorldHandle());
+	}
+
+	bool complete = true;
+	for (uint32_t i = 0; i < objectCount; ++i) {
+		GameObjectHandle	handle;
+		uint32_t			stateSize = 0;
+		if (!snapshot.Read(handle) || !snapshot.Read(stateSize)) {
+			return false;
+		}
+		size_t		stateEnd	= snapshot.GetReadOffset() + stateSize;
+		GameObject* o			= GetGameObject(handle);
+		if (!o || !o->LoadState(snapshot) || snapshot.GetReadOffset() != stateEnd) {
+			complete = false;
+			snapshot.SetReadOffset(stateEnd);
+			continue;
+		}
+		ObjectSlot& slot = objectSlots[handle.index];
+		unrestoredObjects[slot.denseIndex] = GameObjectHandle();
+	}
+	for (auto& h : unrestoredObjects) {
+		RemoveGameObject(h); // Null handles are skipped
+	}
+	return complete;
+}
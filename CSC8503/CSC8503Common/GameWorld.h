@@ -3,6 +3,12 @@
 #include "CollisionDetection.h"
 #include "QuadTree.h"
 #include "GameObject.h"
+#include "GameObjectAllocator.h"
+#include "GameObjectHandle.h"
+#include "ArchetypeStorage.h"
+#include "../../Common/JobSystem.h"
+#include "CollisionEvents.h"
+#include "WorldSnapshot.h"
 #include "ObjectNames.h"
 #include "Layers.h"
 
@@ -28,18 +34,41 @@ namespace NCL {
 			void Clear();
 			void ClearAndErase();
 
-			void AddGameObject(GameObject* o);
+			GameObjectHandle AddGameObject(GameObject* o);
 			void RemoveGameObject(GameObject* o);
+			bool RemoveGameObject(GameObjectHandle h);
 
+			//Returns nullptr if the handle is null, or its object has since been removed
+			GameObject* GetGameObject(GameObjectHandle h) const;
+			bool IsValid(GameObjectHandle h) const { return GetGameObject(h) != nullptr; }
+
+			//Called by GameObject when one of its components is set
+			void OnComponentsChanged(GameObject& o);
+
+			//Calls f(Archetype&) on every archetype that has at least the required components
+			template<typename Func>
+			void QueryArchetypes(ComponentMask required, Func f) {
+				FlushComponentChanges();
+				archetypes.ForEach(required, f);
+			}
+
+			//Safe to call from inside a job - each thread queues into its own buffer
 			void AddAdditionStorage(GameObject* o);
 			void AddRemovalStorage(GameObject* o);
 			void EraseStorage();
 
+			//Spreads the world update across the job system's threads, nullptr to run serially
+			void SetJobSystem(JobSystem* jobs);
+			JobSystem* GetJobSystem() const { return jobSystem; }
+
 			void AddConstraint(Constraint* c);
 			void RemoveConstraint(Constraint* c);			
 
 			Camera* GetMainCamera() const { return mainCamera; }
 
+			//Pooled storage for the current level's objects - released by ClearAndErase
+			GameObjectAllocator& GetLevelAllocator() { return levelAllocator; }
+
 			void ShuffleConstraints(bool state) { shuffleConstraints = state; }
 			void ShuffleObjects(bool state) { shuffleObjects = state; }
 
@@ -47,7 +76,13 @@ namespace NCL {
 
 			virtual void UpdateWorld(float dt);
 
-			void OperateOnContents(GameObjectFunc f);
+			//Passes a physics update's collision events on to the objects' OnCollisionBegin / End
+			void DispatchCollisionEvents(const CollisionEventBuffer& events);
+
+			template<typename Func>
+			void OperateOnContents(Func f) {
+				for (GameObject* g : gameObjects) { f(g); }
+			}
 
 			void GetObjectIterators(GameObjectIterator& first, GameObjectIterator& last) const;
 
@@ -61,14 +96,42 @@ namespace NCL {
 
 			string OutputLevelToFile();
 
+			/*
+			Saves every object's state, plus the camera and level points, in one
+			pass. Restoring writes it all back over the same objects - nothing is
+			reallocated, so a level can be reset in a fraction of a frame. Objects
+			added since the snapshot are removed. Returns false if an object in the
+			snapshot has since been removed, as that needs the level rebuilding.
+			*/
+			void SaveSnapshot(WorldSnapshot& snapshot);
+			bool RestoreSnapshot(WorldSnapshot& snapshot);
+
 		protected:
+			struct ObjectSlot {
+				GameObject* object;
+				uint32_t	generation;
+				uint32_t	denseIndex; //Where object currently sits in gameObjects
+			};
+
 			bool shuffleConstraints, shuffleObjects;
-			std::vector<GameObject*> gameObjects;
-			std::vector<GameObject*> additionStorage;
-			std::vector<GameObject*> removalStorage;
+			std::vector<GameObject*> gameObjects;	//Dense - removal swaps the last object into the gap
+			std::vector<ObjectSlot>	objectSlots;
+			std::vector<uint32_t>	freeSlots;
+			struct ObjectCommandBuffer {
+				std::vector<GameObject*> additions;
+				std::vector<GameObjectHandle> removals; // Taken when queued, as the object may be gone by the time it's applied
+				std::vector<GameObject*> pendingRemovals; // Still waiting in additions, so no handle until the batch is applied
+			};
+			std::vector<ObjectCommandBuffer> commandBuffers; // One per job thread
+			std::vector<GameObject*> parallelUpdates;
+			JobSystem* jobSystem;
+			std::vector<GameObjectHandle> componentChanges;
+			std::vector<GameObjectHandle> unrestoredObjects;
+			ArchetypeStorage archetypes;
 			std::vector<Constraint*> constraints;
 			QuadTree<GameObject*>* quadTree;
 			Camera* mainCamera;
+			GameObjectAllocator levelAllocator;
 
 			Vector3 spawnPoint;	
 			Vector3 roamingPoint;
@@ -76,6 +139,9 @@ namespace NCL {
 			void UpdateGameObjects(float dt);
 			void UpdateTransforms();
 			void UpdateObjectList();
+			void DeleteGameObject(GameObject* o);
+			void FlushComponentChanges();
+			ObjectCommandBuffer& GetCommandBuffer();
 			void UpdateQuadTree();			
 		};
 	}
@@ -3,6 +3,7 @@
 #include "../../Plugins/OpenGLRendering/OGLShader.h"
 #include "../../Plugins/OpenGLRendering/OGLTexture.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/AssetManager.h"
 #include "../../Common/Maths.h"
 
 #include "GameWorld.h"
@@ -14,10 +15,13 @@ namespace NCL {
 	namespace CSC8503 {
 		class GoosePlayer : public GameObject {
 		public:
-			GoosePlayer(Camera* camera, const Vector3 position = Vector3(-85.0f, 7.5f, 85.0f));
+			GoosePlayer(GameObjectAllocator& allocator, Camera* camera, const Vector3 position = Vector3(-85.0f, 7.5f, 85.0f));
 			virtual ~GoosePlayer();
 
 			void UpdateGameObject(float dt) override;
+
+			void SaveState(WorldSnapshot& s) const override;
+			bool LoadState(WorldSnapshot& s) override;
 			
 			void SetCameraPostion(const Vector3 position); 
 
@@ -25,6 +29,7 @@ namespace NCL {
 			void SetActive(bool active) { this->active = active; }
 
 		protected:
+			AssetScope	assets;
 			OGLMesh*	gooseMesh	= nullptr;
 			OGLTexture* gooseTex	= nullptr;
 			OGLShader*	gooseShader	= nullptr;
@@ -1,9 +1,11 @@
 #include "KeeperAI.h"
+#include "GameObjectAllocator.h"
 
 using namespace NCL::CSC8503;
 
-KeeperAI::KeeperAI(const Vector3 position, const Vector3 roamTo, const std::string& filename, GoosePlayer* goose) : GameObject(KEEPER_AI, LAYER_FOUR) {
+KeeperAI::KeeperAI(GameObjectAllocator& allocator, const Vector3 position, const Vector3 roamTo, const std::string& filename, GoosePlayer* goose) : GameObject(KEEPER_AI, LAYER_FOUR) {
 	InitialiseParkKeeper();
+	SetParallelUpdate(true); // Only reads the goose, and pathfinds on its own grid
 	spawnLocation = position;
 	roamingLocation = roamTo;
 
@@ -99,23 +101,20 @@ KeeperAI::KeeperAI(const Vector3 position, const Vector3 roamTo, const std::stri
 	state->AddTransition(huntToPatrolTran);
 	state->AddTransition(patrolToHuntTran);
 
-	AABBVolume* volume = new AABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
+	AABBVolume* volume = allocator.NewAABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
 	SetBoundingVolume((CollisionVolume*)volume);
 
 	GetTransform().SetWorldScale(Vector3(meshSize, meshSize, meshSize));
 	GetTransform().SetWorldPosition(position);
 
-	SetRenderObject(new RenderObject(&GetTransform(), keeperMesh, nullptr, keeperShader));
-	SetPhysicsObject(new PhysicsObject(&GetTransform(), GetBoundingVolume()));
+	SetRenderObject(allocator.NewRenderObject(&GetTransform(), keeperMesh, nullptr, keeperShader));
+	SetPhysicsObject(allocator.NewPhysicsObject(&GetTransform(), GetBoundingVolume()));
 
 	GetPhysicsObject()->SetInverseMass(inverseMass);
 	GetPhysicsObject()->InitCubeInertia();
 }
 
 KeeperAI::~KeeperAI() {
-	delete keeperMesh;
-	delete keeperTex;
-	delete keeperShader;
 }
 
 void KeeperAI::UpdateGameObject(float dt) {	
@@ -124,17 +123,47 @@ void KeeperAI::UpdateGameObject(float dt) {
 	MoveParkKeeper();
 }
 
-void KeeperAI::InitialiseParkKeeper() {
-	auto loadFunc = [](const string& name, OGLMesh** into) {
-		*into = new OGLMesh(name);
-		(*into)->SetPrimitiveType(GeometryPrimitive::Triangles);
-		(*into)->UploadToGPU();
-	};
+//The grid only depends on the level file, so it isn't saved
+void KeeperAI::SaveState(WorldSnapshot& s) const {
+	GameObject::SaveState(s);
+	s.Write(time);
+	s.Write(reverse);
+	s.Write(navigationPoint);
+	s.Write(spawnLocation);
+	s.Write(roamingLocation);
+	s.Write(state->GetActiveStateIndex());
+
+	const std::vector<Vector3>& waypoints = path->GetWaypoints();
+	s.Write((uint32_t)waypoints.size());
+	s.WriteBytes(waypoints.data(), waypoints.size() * sizeof(Vector3));
+}
 
-	loadFunc("CharacterA.msh", &keeperMesh);
+bool KeeperAI::LoadState(WorldSnapshot& s) {
+	int			activeState		= -1;
+	uint32_t	waypointCount	= 0;
+	if (!GameObject::LoadState(s) || !s.Read(time) || !s.Read(reverse) ||
+		!s.Read(navigationPoint) || !s.Read(spawnLocation) || !s.Read(roamingLocation) ||
+		!s.Read(activeState) || !s.Read(waypointCount)) {
+		return false;
+	}
+	state->SetActiveStateIndex(activeState);
+
+	path->Clear();
+	for (uint32_t i = 0; i < waypointCount; ++i) {
+		Vector3 waypoint;
+		if (!s.Read(waypoint)) {
+			return false;
+		}
+		path->PushWaypoint(waypoint);
+	}
+	return true;
+}
+
+void KeeperAI::InitialiseParkKeeper() {
+	keeperMesh = (OGLMesh*)assets.Mesh("CharacterA.msh", AssetLoad::Streamed);
 
-	keeperTex = (OGLTexture*)TextureLoader::LoadAPITexture("checkerboard.png");
-	keeperShader = new OGLShader("GameTechVert.glsl", "GameTechFrag.glsl");
+	keeperTex = (OGLTexture*)assets.Texture("checkerboard.png", AssetLoad::Streamed);
+	keeperShader = (OGLShader*)assets.Shader("GameTechVert.glsl", "GameTechFrag.glsl");
 }
 
 void KeeperAI::MoveParkKeeper() {
@@ -3,6 +3,7 @@
 #include "../../Plugins/OpenGLRendering/OGLShader.h"
 #include "../../Plugins/OpenGLRendering/OGLTexture.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/AssetManager.h"
 
 #include "../CSC8503Common/StateMachine.h"
 #include "../CSC8503Common/StateTransition.h"
@@ -21,10 +22,13 @@ namespace NCL {
 	namespace CSC8503 {
 		class KeeperAI : public GameObject {
 		public:
-			KeeperAI(const Vector3 position, const Vector3 roamTo, const std::string& filename, GoosePlayer* goose);
+			KeeperAI(GameObjectAllocator& allocator, const Vector3 position, const Vector3 roamTo, const std::string& filename, GoosePlayer* goose);
 			virtual ~KeeperAI();
 
 			void UpdateGameObject(float dt) override;
+
+			void SaveState(WorldSnapshot& s) const override;
+			bool LoadState(WorldSnapshot& s) override;
 			
 			NavigationGrid* GetGrid() const { return grid; }
 			NavigationPath* GetPath() const { return path; }
@@ -53,6 +57,7 @@ namespace NCL {
 			Vector3 spawnLocation;
 			Vector3 roamingLocation;
 
+			AssetScope assets;
 			OGLMesh* keeperMesh = nullptr;
 			OGLTexture* keeperTex = nullptr;
 			OGLShader* keeperShader = nullptr;					   	
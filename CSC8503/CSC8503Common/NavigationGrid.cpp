@@ -1,4 +1,5 @@
 #include "../../Common/Assets.h"
+#include "../../Common/Profiler.h"
 
 #include "NavigationGrid.h"
 
@@ -88,6 +89,7 @@ NavigationGrid::~NavigationGrid()	{
 }
 
 bool NavigationGrid::FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) {
+	PROFILE_SCOPE("NavigationGrid::FindPath");
 	// Positioning
 	const float offset = 90.0f;
 	const float dimension = (float)nodeSize / 2.0f;
@@ -106,7 +108,7 @@ bool NavigationGrid::FindPath(const Vector3& from, const Vector3& to, Navigation
 	GridNode* startNode = &allNodes[(fromZ * gridWidth) + fromX];
 	GridNode* endNode = &allNodes[(toZ * gridWidth) + toX];
 
-	std::vector<GridNode*> openList, closedList;
+	FrameVector<GridNode*> openList, closedList; // Per-frame memory - nothing here outlives the search
 
 	openList.emplace_back(startNode);
 
@@ -162,13 +164,13 @@ bool NavigationGrid::FindPath(const Vector3& from, const Vector3& to, Navigation
 	return false; // Open list emptied out with no path !
 }
 
-bool NavigationGrid::NodeInList(GridNode* n, std::vector<GridNode*>& list) const {
-	std::vector <GridNode*>::iterator i = std::find(list.begin(), list.end(), n);
+bool NavigationGrid::NodeInList(GridNode* n, FrameVector<GridNode*>& list) const {
+	FrameVector<GridNode*>::iterator i = std::find(list.begin(), list.end(), n);
 	return i == list.end() ? false : true;
 }
 
-GridNode* NavigationGrid::RemoveBestNode(std::vector<GridNode*>& list) const {
-	std::vector <GridNode*>::iterator bestI = list.begin();
+GridNode* NavigationGrid::RemoveBestNode(FrameVector<GridNode*>& list) const {
+	FrameVector<GridNode*>::iterator bestI = list.begin();
 	GridNode* bestNode = *list.begin();
 
 	for (auto i = list.begin(); i != list.end(); ++i) {
@@ -1,5 +1,6 @@
 #pragma once
 #include "NavigationMap.h"
+#include "../../Common/FrameAllocator.h"
 #include <string>
 namespace NCL {
 	namespace CSC8503 {
@@ -29,8 +30,8 @@ namespace NCL {
 			bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) override;
 				
 		protected:
-			bool		NodeInList(GridNode* n, std::vector<GridNode*>& list) const;
-			GridNode*	RemoveBestNode(std::vector<GridNode*>& list) const;
+			bool		NodeInList(GridNode* n, FrameVector<GridNode*>& list) const;
+			GridNode*	RemoveBestNode(FrameVector<GridNode*>& list) const;
 			float		Heuristic(GridNode* hNode, GridNode* endNode) const;
 
 			int nodeSize, gridWidth, gridHeight;
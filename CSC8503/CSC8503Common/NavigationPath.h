@@ -31,6 +31,8 @@ namespace NCL {
 				return true;
 			}
 
+			const std::vector<Vector3>& GetWaypoints() const { return waypoints; }
+
 		protected:
 			std::vector <Vector3> waypoints;
 		};
@@ -1,7 +1,10 @@
 #pragma once
+#ifdef _WIN32
 #include <winsock2.h>
+#endif
 #include <enet/enet.h>
 #include <map>
+#include <cstring>
 #include <string>
 
 enum BasicNetworkMessages {
@@ -1,3 +1,6 @@
+#pragma once
+#include <cstdint>
+
 // Object Names
 #define GOOSE_PLAYER		"GOOSE_PLAYER"
 #define OBSTICAL_PLAYER		"OBSTICAL_PLAYER"
@@ -19,4 +22,47 @@
 #define APPLE_SHORT		'A'
 #define KEEPER_SHORT	'K'
 #define ROAM_SHORT		'R'
-#define SPAWN_POINT		'X'
\ No newline at end of file
+#define SPAWN_POINT		'X'
+
+namespace NCL {
+	namespace CSC8503 {
+		// Object Tags - small integer stand-ins for the names above, for comparing and switching on
+		enum ObjectTag : uint8_t {
+			TAG_NONE,
+			TAG_GOOSE_PLAYER,
+			TAG_OBSTICAL_PLAYER,
+			TAG_CUBE,
+			TAG_SPHERE,
+			TAG_APPLE,
+			TAG_KEEPER,
+			TAG_ROAM,
+			TAG_FLOOR,
+			TAG_BARRIER,
+			TAG_OBSTICAL_MODE,
+			TAG_GOOSE_MODE,
+			TAG_COUNT
+		};
+
+		constexpr bool ObjectNamesMatch(const char* a, const char* b) {
+			return *a == *b && (*a == '\0' || ObjectNamesMatch(a + 1, b + 1));
+		}
+
+		// Works out an object's tag from its name - at compile time, when the name is a constant
+		constexpr ObjectTag ObjectTagFromName(const char* name) {
+			return	ObjectNamesMatch(name, GOOSE_PLAYER)	? TAG_GOOSE_PLAYER		:
+					ObjectNamesMatch(name, OBSTICAL_PLAYER)	? TAG_OBSTICAL_PLAYER	:
+					ObjectNamesMatch(name, CUBE_OBJECT)		? TAG_CUBE				:
+					ObjectNamesMatch(name, SPHERE_OBJECT)	? TAG_SPHERE			:
+					ObjectNamesMatch(name, APPLE_OBJECT)	? TAG_APPLE				:
+					ObjectNamesMatch(name, KEEPER_AI)		? TAG_KEEPER			:
+					ObjectNamesMatch(name, ROAM_LOCATION)	? TAG_ROAM				:
+					ObjectNamesMatch(name, FLOOR_OBJECT)	? TAG_FLOOR				:
+					ObjectNamesMatch(name, BARRIER_OBJECT)	? TAG_BARRIER			:
+					ObjectNamesMatch(name, OBSTICAL_MODE)	? TAG_OBSTICAL_MODE		:
+					ObjectNamesMatch(name, GOOSE_MODE)		? TAG_GOOSE_MODE		:
+					TAG_NONE;
+		}
+
+		static_assert(ObjectTagFromName(GOOSE_MODE) == TAG_GOOSE_MODE, "Object tags are out of step with the object names!");
+	}
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ObsticalPlayer.h"
+#include "../../Common/Input.h"
 
 using namespace NCL::CSC8503;
 
@@ -20,36 +21,35 @@ ObsticalPlayer::ObsticalPlayer(GameWorld* world, PhysicsSystem* physics) : GameO
 }
 
 ObsticalPlayer::~ObsticalPlayer() {
-	delete cubeMesh;
-	delete sphereMesh;
-	delete gooseMesh;
-	delete keeperMesh;
-	delete appleMesh;
-
-	delete basicTex;
-	delete basicShader;
-
 	world = nullptr;
 	physics = nullptr;
 	camera = nullptr;
 }
 
+void ObsticalPlayer::SaveState(WorldSnapshot& s) const {
+	GameObject::SaveState(s);
+	s.Write(active);
+	s.Write(deleteMode);
+	s.Write(colliding);
+	s.Write(collidedObject);
+	s.Write(objectPosition);
+}
+
+bool ObsticalPlayer::LoadState(WorldSnapshot& s) {
+	return	GameObject::LoadState(s) && s.Read(active) && s.Read(deleteMode) &&
+			s.Read(colliding) && s.Read(collidedObject) && s.Read(objectPosition);
+}
+
 void ObsticalPlayer::InitialiseAssets() {
-	auto loadFunc = [](const string& name, OGLMesh** into) {
-		*into = new OGLMesh(name);
-		(*into)->SetPrimitiveType(GeometryPrimitive::Triangles);
-		(*into)->UploadToGPU();
-	};
-
-	loadFunc("cube.msh"		  , &cubeMesh);
-	loadFunc("sphere.msh"	  , &sphereMesh);
-	loadFunc("goose.msh"	  , &gooseMesh);
-	loadFunc("CharacterA.msh" , &keeperMesh);
-	loadFunc("CharacterM.msh" , &roamMesh);
-	loadFunc("Apple.msh"	  , &appleMesh);
-
-	basicTex = (OGLTexture*)TextureLoader::LoadAPITexture("checkerboard.png");
-	basicShader = new OGLShader("GameTechVert.glsl", "GameTechFrag.glsl");
+	cubeMesh	= (OGLMesh*)assets.Mesh("cube.msh");
+	sphereMesh	= (OGLMesh*)assets.Mesh("sphere.msh");
+	gooseMesh	= (OGLMesh*)assets.Mesh("goose.msh", AssetLoad::Streamed);
+	keeperMesh	= (OGLMesh*)assets.Mesh("CharacterA.msh", AssetLoad::Streamed);
+	roamMesh	= (OGLMesh*)assets.Mesh("CharacterM.msh", AssetLoad::Streamed);
+	appleMesh	= (OGLMesh*)assets.Mesh("Apple.msh", AssetLoad::Streamed);
+
+	basicTex = (OGLTexture*)assets.Texture("checkerboard.png", AssetLoad::Streamed);
+	basicShader = (OGLShader*)assets.Shader("GameTechVert.glsl", "GameTechFrag.glsl");
 }
 
 void ObsticalPlayer::UpdateGameObject(float dt) {
@@ -58,7 +58,7 @@ void ObsticalPlayer::UpdateGameObject(float dt) {
 			SetRenderObject(new RenderObject(&GetTransform(), cubeMesh, basicTex, basicShader));
 		}
 
-		if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::T)) {
+		if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::T)) {
 			toggleDeleteMode();
 		}
 
@@ -70,7 +70,7 @@ void ObsticalPlayer::UpdateGameObject(float dt) {
 		ManipulateObject();
 		AddObjectToWorld();
 
-		if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::RETURN)) {
+		if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::RETURN)) {
 			world->OutputLevelToFile();
 		}
 	}	
@@ -84,22 +84,22 @@ void ObsticalPlayer::OnCollisionEnd(GameObject* otherObject) {
 }
 
 void ObsticalPlayer::ManipulateObject() {
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::W)) {		
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::W)) {		
 		if (!(objectPosition.z >= 85.0f)) {
 			objectPosition += Vector3(0.0f, 0.0f, 10.0f);
 		}
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::S)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::S)) {
 		if (!(objectPosition.z <= -85.0f)) {
 			objectPosition -= Vector3(0.0f, 0.0f, 10.0f);
 		}
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::A)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::A)) {
 		if (!(objectPosition.x >= 85.0f)) {
 			objectPosition += Vector3(10.0f, 0.0f, 0.0f);
 		}
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::D)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::D)) {
 		if (!(objectPosition.x <= -85.0f)) {
 			objectPosition -= Vector3(10.0f, 0.0f, 0.0f);			
 		}
@@ -108,28 +108,29 @@ void ObsticalPlayer::ManipulateObject() {
 }
 
 void ObsticalPlayer::AddObjectToWorld() {
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM1)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM1)) {
 		SetRenderObject(new RenderObject(&GetTransform(), cubeMesh, basicTex, basicShader));
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM2)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM2)) {
 		SetRenderObject(new RenderObject(&GetTransform(), sphereMesh, basicTex, basicShader));
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM3)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM3)) {
 		SetRenderObject(new RenderObject(&GetTransform(), appleMesh, basicTex, basicShader));
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM4)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM4)) {
 		SetRenderObject(new RenderObject(&GetTransform(), keeperMesh, basicTex, basicShader));
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM5)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM5)) {
 		SetRenderObject(new RenderObject(&GetTransform(), roamMesh, basicTex, basicShader));
 	}
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM6)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::NUM6)) {
 		SetRenderObject(new RenderObject(&GetTransform(), gooseMesh, basicTex, basicShader));
 	}
 
-	if (Window::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::E)) {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::E)) {
+		GameObject* collided = GetCollidedObject(); // nullptr if it's been removed or reset away since
 		if (!deleteMode) {
-			if (!GetCollidedObject() || GetCollidedObject()->GetTransform().GetWorldPosition() != objectPosition) {
+			if (!collided || collided->GetTransform().GetWorldPosition() != objectPosition) {
 				if (GetRenderObject()->GetMesh() == cubeMesh) {
 					world->AddAdditionStorage(AddCubeToWorld(objectPosition));
 				}
@@ -152,10 +153,10 @@ void ObsticalPlayer::AddObjectToWorld() {
 			}			
 		}
 		else {
-			if (GetCollidedObject()) {
-				if (GetCollidedObject()->GetName() != FLOOR_OBJECT && GetCollidedObject()->GetName() != BARRIER_OBJECT &&
-					GetCollidedObject()->GetName() != GOOSE_PLAYER && GetCollidedObject()->GetName() != OBSTICAL_PLAYER) {
-					world->AddRemovalStorage(GetCollidedObject());
+			if (collided) {
+				ObjectTag tag = collided->GetTag();
+				if (tag != TAG_FLOOR && tag != TAG_BARRIER && tag != TAG_GOOSE_PLAYER && tag != TAG_OBSTICAL_PLAYER) {
+					world->AddRemovalStorage(collided);
 					SetCollidedObject(nullptr);
 					physics->Clear();
 				}
@@ -165,30 +166,32 @@ void ObsticalPlayer::AddObjectToWorld() {
 }
 
 GameObject* ObsticalPlayer::AddCubeToWorld(const Vector3& position) {
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
 	Vector3 cubeDims = Vector3(5.0f, 5.0f, 5.0f);
-	GameObject* cube = new GameObject(CUBE_OBJECT, LAYER_ONE);
-	AABBVolume* volume = new AABBVolume(cubeDims);
+	GameObject* cube = allocator.NewGameObject(CUBE_OBJECT, LAYER_ONE);
+	AABBVolume* volume = allocator.NewAABBVolume(cubeDims);
 	cube->SetBoundingVolume((CollisionVolume*)volume);
 	cube->GetTransform().SetWorldPosition(position);
 	cube->GetTransform().SetWorldScale(cubeDims);
-	cube->SetRenderObject(new RenderObject(&cube->GetTransform(), cubeMesh, basicTex, basicShader));
-	cube->SetPhysicsObject(new PhysicsObject(&cube->GetTransform(), cube->GetBoundingVolume()));
+	cube->SetRenderObject(allocator.NewRenderObject(&cube->GetTransform(), cubeMesh, basicTex, basicShader));
+	cube->SetPhysicsObject(allocator.NewPhysicsObject(&cube->GetTransform(), cube->GetBoundingVolume()));
 	cube->GetPhysicsObject()->SetInverseMass(0.0f);
 	return cube;
 }
 
 GameObject* ObsticalPlayer::AddSphereToWorld(const Vector3& position, float inverseMass) {
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
 	float sphereRadius = 5.0f;
-	GameObject* sphere = new GameObject(SPHERE_OBJECT, LAYER_ONE);
+	GameObject* sphere = allocator.NewGameObject(SPHERE_OBJECT, LAYER_ONE);
 
 	Vector3 sphereSize = Vector3(sphereRadius, sphereRadius, sphereRadius);
-	SphereVolume* volume = new SphereVolume(sphereRadius);
+	SphereVolume* volume = allocator.NewSphereVolume(sphereRadius);
 	sphere->SetBoundingVolume((CollisionVolume*)volume);
 	sphere->GetTransform().SetWorldScale(sphereSize);
 	sphere->GetTransform().SetWorldPosition(position);
 
-	sphere->SetRenderObject(new RenderObject(&sphere->GetTransform(), sphereMesh, basicTex, basicShader));
-	sphere->SetPhysicsObject(new PhysicsObject(&sphere->GetTransform(), sphere->GetBoundingVolume()));
+	sphere->SetRenderObject(allocator.NewRenderObject(&sphere->GetTransform(), sphereMesh, basicTex, basicShader));
+	sphere->SetPhysicsObject(allocator.NewPhysicsObject(&sphere->GetTransform(), sphere->GetBoundingVolume()));
 
 	sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
 	sphere->GetPhysicsObject()->InitSphereInertia();
@@ -197,15 +200,16 @@ GameObject* ObsticalPlayer::AddSphereToWorld(const Vector3& position, float inve
 }
 
 GameObject* ObsticalPlayer::AddAppleToWorld(const Vector3& position) {
-	GameObject* apple = new GameObject(APPLE_OBJECT, LAYER_THREE);
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
+	GameObject* apple = allocator.NewGameObject(APPLE_OBJECT, LAYER_THREE);
 
-	SphereVolume* volume = new SphereVolume(0.7f);
+	SphereVolume* volume = allocator.NewSphereVolume(0.7f);
 	apple->SetBoundingVolume((CollisionVolume*)volume);
 	apple->GetTransform().SetWorldScale(Vector3(4.0f, 4.0f, 4.0f));
 	apple->GetTransform().SetWorldPosition(position);
 
-	apple->SetRenderObject(new RenderObject(&apple->GetTransform(), appleMesh, nullptr, basicShader));
-	apple->SetPhysicsObject(new PhysicsObject(&apple->GetTransform(), apple->GetBoundingVolume()));
+	apple->SetRenderObject(allocator.NewRenderObject(&apple->GetTransform(), appleMesh, nullptr, basicShader));
+	apple->SetPhysicsObject(allocator.NewPhysicsObject(&apple->GetTransform(), apple->GetBoundingVolume()));
 
 	apple->GetPhysicsObject()->SetInverseMass(1.0f);
 	apple->GetPhysicsObject()->InitSphereInertia();
@@ -214,16 +218,17 @@ GameObject* ObsticalPlayer::AddAppleToWorld(const Vector3& position) {
 }
 
 GameObject* ObsticalPlayer::AddKeeperToWorld(const Vector3& position) {
-	GameObject* keeper = new GameObject(KEEPER_AI, LAYER_FOUR);
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
+	GameObject* keeper = allocator.NewGameObject(KEEPER_AI, LAYER_FOUR);
 	float meshSize = 4.0f, inverseMass = 0.5f, movementSpeed = 20.0f;
-	AABBVolume* volume = new AABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
+	AABBVolume* volume = allocator.NewAABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
 	keeper->SetBoundingVolume((CollisionVolume*)volume);
 
 	keeper->GetTransform().SetWorldScale(Vector3(meshSize, meshSize, meshSize));
 	keeper->GetTransform().SetWorldPosition(position);
 
-	keeper->SetRenderObject(new RenderObject(&keeper->GetTransform(), keeperMesh, nullptr, basicShader));
-	keeper->SetPhysicsObject(new PhysicsObject(&keeper->GetTransform(), keeper->GetBoundingVolume()));
+	keeper->SetRenderObject(allocator.NewRenderObject(&keeper->GetTransform(), keeperMesh, nullptr, basicShader));
+	keeper->SetPhysicsObject(allocator.NewPhysicsObject(&keeper->GetTransform(), keeper->GetBoundingVolume()));
 
 	keeper->GetPhysicsObject()->SetInverseMass(inverseMass);
 	keeper->GetPhysicsObject()->InitCubeInertia();
@@ -231,16 +236,17 @@ GameObject* ObsticalPlayer::AddKeeperToWorld(const Vector3& position) {
 }
 
 GameObject* ObsticalPlayer::AddRoamToWorld(const Vector3& position) {
-	GameObject* roam = new GameObject(ROAM_LOCATION, LAYER_FOUR);
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
+	GameObject* roam = allocator.NewGameObject(ROAM_LOCATION, LAYER_FOUR);
 	float meshSize = 4.0f, inverseMass = 0.5f, movementSpeed = 20.0f;
-	AABBVolume* volume = new AABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
+	AABBVolume* volume = allocator.NewAABBVolume(Vector3(0.3f, 0.9f, 0.3f) * meshSize);
 	roam->SetBoundingVolume((CollisionVolume*)volume);
 
 	roam->GetTransform().SetWorldScale(Vector3(meshSize, meshSize, meshSize));
 	roam->GetTransform().SetWorldPosition(position);
 
-	roam->SetRenderObject(new RenderObject(&roam->GetTransform(), roamMesh, nullptr, basicShader));
-	roam->SetPhysicsObject(new PhysicsObject(&roam->GetTransform(), roam->GetBoundingVolume()));
+	roam->SetRenderObject(allocator.NewRenderObject(&roam->GetTransform(), roamMesh, nullptr, basicShader));
+	roam->SetPhysicsObject(allocator.NewPhysicsObject(&roam->GetTransform(), roam->GetBoundingVolume()));
 
 	roam->GetPhysicsObject()->SetInverseMass(inverseMass);
 	roam->GetPhysicsObject()->InitCubeInertia();
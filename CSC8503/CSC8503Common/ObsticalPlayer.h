@@ -3,6 +3,7 @@
 #include "../../Plugins/OpenGLRendering/OGLShader.h"
 #include "../../Plugins/OpenGLRendering/OGLTexture.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/AssetManager.h"
 
 #include "GameWorld.h"
 #include "PhysicsSystem.h"
@@ -22,6 +23,9 @@ namespace NCL {
 			//void OnCollisionBegin(GameObject* otherObject) override;
 			void OnCollisionEnd(GameObject* otherObject) override;
 
+			void SaveState(WorldSnapshot& s) const override;
+			bool LoadState(WorldSnapshot& s) override;
+
 			bool GetActive() const { return active; }
 			void SetActive(bool active) { this->active = active; }
 
@@ -30,8 +34,9 @@ namespace NCL {
 			bool GetColliding() const { return colliding; }
 			void SetColliding(bool collide) { colliding = collide; }
 
-			GameObject* GetCollidedObject() const { return collidedObject; }
-			void SetCollidedObject(GameObject* object) { collidedObject = object; }
+			//Held as a handle, so it reads as nullptr once the object has been removed
+			GameObject* GetCollidedObject() const { return world->GetGameObject(collidedObject); }
+			void SetCollidedObject(GameObject* object) { collidedObject = object ? object->GetWorldHandle() : GameObjectHandle(); }
 
 		protected:
 			bool active = false;
@@ -42,9 +47,10 @@ namespace NCL {
 			bool deleteMode = false;
 			
 			bool colliding = false;
-			GameObject* collidedObject = nullptr;
+			GameObjectHandle collidedObject;
 
 			// Meshes
+			AssetScope	assets;
 			OGLMesh*	cubeMesh	= nullptr;
 			OGLMesh*	sphereMesh	= nullptr;
 			OGLMesh*	gooseMesh	= nullptr;
@@ -58,4 +58,25 @@ void PhysicsObject::UpdateInertiaTensor() {
 	Quaternion q = transform->GetWorldOrientation();	
 	Matrix3 invOrientation = Matrix3(q.Conjugate()), orientation = Matrix3(q);
 	inverseInteriaTensor = orientation * Matrix3::Scale(inverseInertia) *invOrientation;
-}
\ No newline at end of file
+}
+
+void PhysicsObject::SaveState(WorldSnapshot& s) const {
+	s.Write(phasingObject);
+	s.Write(inverseMass);
+	s.Write(elasticity);
+	s.Write(friction);
+	s.Write(linearVelocity);
+	s.Write(force);
+	s.Write(angularVelocity);
+	s.Write(torque);
+	s.Write(inverseInertia);
+	s.Write(inverseInteriaTensor);
+}
+
+bool PhysicsObject::LoadState(WorldSnapshot& s) {
+	return	s.Read(phasingObject) && s.Read(inverseMass) &&
+			s.Read(elasticity) && s.Read(friction) &&
+			s.Read(linearVelocity) && s.Read(force) &&
+			s.Read(angularVelocity) && s.Read(torque) &&
+			s.Read(inverseInertia) && s.Read(inverseInteriaTensor);
+}
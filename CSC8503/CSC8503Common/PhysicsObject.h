@@ -1,6 +1,7 @@
 #pragma once
 #include "../../Common/Vector3.h"
 #include "../../Common/Matrix3.h"
+#include "WorldSnapshot.h"
 
 using namespace NCL::Maths;
 
@@ -51,6 +52,9 @@ namespace NCL {
 
 			Matrix3 GetInertiaTensor() const { return inverseInteriaTensor; }
 
+			void SaveState(WorldSnapshot& s) const;
+			bool LoadState(WorldSnapshot& s);
+
 		protected:
 			bool phasingObject;
 
@@ -3,11 +3,10 @@
 #include "GameObject.h"
 #include "CollisionDetection.h"
 #include "../../Common/Quaternion.h"
+#include "../../Common/Profiler.h"
 
 #include "Constraint.h"
 
-#include "Debug.h"
-
 #include <functional>
 
 using namespace NCL;
@@ -18,6 +17,7 @@ PhysicsSystem::PhysicsSystem(GameWorld& g) : gameWorld(g)	{
 	useBroadPhase	= false;	
 	dTOffset		= 0.0f;
 	globalDamping	= 0.95f;
+	statistics		= PhysicsStatistics();
 	SetGravity(Vector3(0.0f, -9.8f, 0.0f));
 }
 
@@ -38,16 +38,17 @@ any collisions they are in.
 */
 void PhysicsSystem::Clear() {
 	allCollisions.clear();
+	collisionEvents.Clear();
 }
 
 /*
 This is the core of the physics engine update
 */
 void PhysicsSystem::Update(float dt) {
-	GameTimer testTimer;
-	testTimer.GetTimeDeltaSeconds();
-
+	PROFILE_SCOPE("Physics::Update");
 	frameDT = dt;
+	collisionEvents.Clear();
+	statistics = PhysicsStatistics();
 
 	dTOffset += dt; // We accumulate time delta here - there might be remainders from previous frame!
 
@@ -90,21 +91,21 @@ void PhysicsSystem::Update(float dt) {
 		//we just run things multiple times, slowly moving things forward
 		//and then rechecking that the constraints have been met		
 		float constraintDt = iterationDt /  (float)constraintIterationCount;
-
-		for (uint8_t i = 0; i < constraintIterationCount; ++i) {
-			UpdateConstraints(constraintDt);	
+		{
+			PROFILE_SCOPE("Physics::UpdateConstraints");
+			for (uint8_t i = 0; i < constraintIterationCount; ++i) {
+				UpdateConstraints(constraintDt);	
+			}
 		}
 		
 		IntegrateVelocity(iterationDt); //update positions from new velocity changes
 
 		dTOffset -= iterationDt; 
+		statistics.steps++;
 	}
 	ClearForces();	//Once we've finished with the forces, reset them to zero
 
 	UpdateCollisionList(); // Remove any old collisions
-	//std::cout << iteratorCount << " , " << iterationDt << std::endl;
-	float time = testTimer.GetTimeDeltaSeconds();
-	//std::cout << "Physics time taken: " << time << std::endl;
 }
 
 /*
@@ -117,19 +118,22 @@ The frame they are to be removed, we tell them they're no longer colliding.
 From this simple mechanism, we we build up gameplay interactions inside the
 OnCollisionBegin / OnCollisionEnd functions (removing health when hit by a 
 rocket launcher, gaining a point when the player hits the gold coin, and so on).
+
+Rather than calling those here, in the middle of the physics update, each
+begin / end is written into the collision event buffer, and the gameplay
+code reads through that once the physics update has finished.
 */
 void PhysicsSystem::UpdateCollisionList() {
+	PROFILE_SCOPE("Physics::UpdateCollisionList");
 	for (std::set < CollisionDetection::CollisionInfo >::iterator i = allCollisions.begin(); i != allCollisions.end(); ) {
 		if ((*i).framesLeft == numCollisionFrames) {
-			i->a->OnCollisionBegin(i->b);
-			i->b->OnCollisionBegin(i->a);
+			collisionEvents.Add(*i, COLLISION_BEGIN);
 		}
 
 		(*i).framesLeft = (*i).framesLeft - 1;
 
 		if ((*i).framesLeft < 0) {
-			i->a->OnCollisionEnd(i->b);
-			i->b->OnCollisionEnd(i->a);
+			collisionEvents.Add(*i, COLLISION_END);
 			i = allCollisions.erase(i);
 		}
 		else {
@@ -139,6 +143,7 @@ void PhysicsSystem::UpdateCollisionList() {
 }
 
 void PhysicsSystem::UpdateObjectAABBs() {
+	PROFILE_SCOPE("Physics::UpdateObjectAABBs");
 	std::vector<GameObject*>::const_iterator first;
 	std::vector<GameObject*>::const_iterator last;
 	gameWorld.GetObjectIterators(first, last);
@@ -157,6 +162,7 @@ a particular pair will only be added once, so objects colliding for
 multiple frames won't flood the set with duplicates.
 */
 void PhysicsSystem::BasicCollisionDetection() {
+	PROFILE_SCOPE("Physics::BasicCollisionDetection");
 	std::vector < GameObject* >::const_iterator first;
 	std::vector < GameObject* >::const_iterator last;
 	gameWorld.GetObjectIterators(first, last);
@@ -170,8 +176,10 @@ void PhysicsSystem::BasicCollisionDetection() {
 				continue;
 			}
 
+			statistics.pairsTested++;
 			CollisionDetection::CollisionInfo info;
 			if (CollisionDetection::ObjectIntersection(*i, *j, info)) {
+				statistics.contacts++;
 				//std::cout << " Collision between " << (*i)->GetName() << " and " << (*j)->GetName() << std::endl;
 				ImpulseResolveCollision(*info.a, *info.b, info.point);
 				info.framesLeft = numCollisionFrames;
@@ -231,7 +239,8 @@ split the world up using an acceleration structure, so that we can only
 compare the collisions that we absolutely need to. 
 */
 void PhysicsSystem::BroadPhase() {
-
+	PROFILE_SCOPE("Physics::BroadPhase");
+	ResetFrameContainer(broadphaseCollisionsVec);
 }
 
 /*
@@ -239,6 +248,7 @@ The broadphase will now only give us likely collisions, so we can now go through
 and work out if they are truly colliding, and if so, add them into the main collision list
 */
 void PhysicsSystem::NarrowPhase() {
+	PROFILE_SCOPE("Physics::NarrowPhase");
 
 }
 
@@ -252,37 +262,32 @@ based on any forces that have been accumulated in the objects during
 the course of the previous game frame.
 */
 void PhysicsSystem::IntegrateAccel(float dt) {
-	std::vector <GameObject*>::const_iterator first;
-	std::vector <GameObject*>::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
-
-	for (auto i = first; i != last; ++i) {
-		PhysicsObject* object = (*i)->GetPhysicsObject();
-
-		if (object == nullptr) { continue; } // No physics object for this GameObject!
-
-		float inverseMass = object->GetInverseMass();
+	PROFILE_SCOPE("Physics::IntegrateAccel");
+	gameWorld.QueryArchetypes(COMPONENT_PHYSICS, [&](Archetype& a) {
+		for (PhysicsObject* object : a.GetPhysicsObjects()) {
+			float inverseMass = object->GetInverseMass();
 
-		Vector3 linearVel = object->GetLinearVelocity();
-		Vector3 force = object->GetForce();
-		Vector3 accel = force * inverseMass;
+			Vector3 linearVel = object->GetLinearVelocity();
+			Vector3 force = object->GetForce();
+			Vector3 accel = force * inverseMass;
 
-		if (applyGravity && inverseMass > 0) { accel += gravity; } // Don't move infinitely heavy things
+			if (applyGravity && inverseMass > 0) { accel += gravity; } // Don't move infinitely heavy things
 
-		linearVel += accel * dt; // integrate accel !
-		object->SetLinearVelocity(linearVel);
+			linearVel += accel * dt; // integrate accel !
+			object->SetLinearVelocity(linearVel);
 
-		// Angular stuff
-		Vector3 torque = object->GetTorque();
-		Vector3 angVel = object->GetAngularVelocity();
+			// Angular stuff
+			Vector3 torque = object->GetTorque();
+			Vector3 angVel = object->GetAngularVelocity();
 
-		object->UpdateInertiaTensor(); // update tensor vs orientation
+			object->UpdateInertiaTensor(); // update tensor vs orientation
 
-		Vector3 angAccel = object->GetInertiaTensor() * torque;
+			Vector3 angAccel = object->GetInertiaTensor() * torque;
 
-		angVel += angAccel * dt; // integrate angular accel !
-		object->SetAngularVelocity(angVel);
-	}
+			angVel += angAccel * dt; // integrate angular accel !
+			object->SetAngularVelocity(angVel);
+		}
+	});
 }
 
 /*
@@ -292,42 +297,43 @@ throughout a physics update, to slowly move the objects through
 the world, looking for collisions.
 */
 void PhysicsSystem::IntegrateVelocity(float dt) {
-	std::vector <GameObject*>::const_iterator first;
-	std::vector <GameObject*>::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
+	PROFILE_SCOPE("Physics::IntegrateVelocity");
 	float dampingFactor = 1.0f - 0.95f;
 	float frameDamping = powf(dampingFactor, dt);
 
-	for (auto i = first; i != last; ++i) {
-		PhysicsObject* object = (*i)->GetPhysicsObject();
-		if (object == nullptr) { continue; }
+	gameWorld.QueryArchetypes(COMPONENT_PHYSICS, [&](Archetype& a) {
+		const std::vector<PhysicsObject*>&	objects		= a.GetPhysicsObjects();
+		const std::vector<Transform*>&		transforms	= a.GetTransforms();
 
-		Transform& transform = (*i)->GetTransform();
+		for (size_t i = 0; i < objects.size(); ++i) {
+			PhysicsObject* object = objects[i];
+			Transform& transform = *transforms[i];
 
-		// Position Stuff
-		Vector3 position = transform.GetLocalPosition();
-		Vector3 linearVel = object->GetLinearVelocity();
-		position += linearVel * dt;
-		transform.SetLocalPosition(position);
-		transform.SetWorldPosition(position);
+			// Position Stuff
+			Vector3 position = transform.GetLocalPosition();
+			Vector3 linearVel = object->GetLinearVelocity();
+			position += linearVel * dt;
+			transform.SetLocalPosition(position);
+			transform.SetWorldPosition(position);
 
-		// Linear Damping
-		linearVel = linearVel * frameDamping;
-		object->SetLinearVelocity(linearVel);
+			// Linear Damping
+			linearVel = linearVel * frameDamping;
+			object->SetLinearVelocity(linearVel);
 
-		// Orientation Stuff
-		Quaternion orientation = transform.GetLocalOrientation();
-		Vector3 angVel = object->GetAngularVelocity();
+			// Orientation Stuff
+			Quaternion orientation = transform.GetLocalOrientation();
+			Vector3 angVel = object->GetAngularVelocity();
 
-		orientation = orientation + (Quaternion(angVel * dt * 0.5f, 0.0f) * orientation);
-		orientation.Normalise();
+			orientation = orientation + (Quaternion(angVel * dt * 0.5f, 0.0f) * orientation);
+			orientation.Normalise();
 
-		transform.SetLocalOrientation(orientation);
+			transform.SetLocalOrientation(orientation);
 
-		// Damp the angular velocity too
-		angVel = angVel * frameDamping;
-		object->SetAngularVelocity(angVel);
-	}
+			// Damp the angular velocity too
+			angVel = angVel * frameDamping;
+			object->SetAngularVelocity(angVel);
+		}
+	});
 }
 
 /*
@@ -336,12 +342,11 @@ clear out any accumulated forces, ready to receive new
 ones in the next 'game' frame.
 */
 void PhysicsSystem::ClearForces() {
-	std::vector<GameObject*>::const_iterator first;
-	std::vector<GameObject*>::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
-
-	// Clear our object's forces for the next frame
-	for (auto i = first; i != last; ++i) { (*i)->GetPhysicsObject()->ClearForces(); }
+	PROFILE_SCOPE("Physics::ClearForces");
+	// Only archetypes with a physics column, so objects without physics are never touched
+	gameWorld.QueryArchetypes(COMPONENT_PHYSICS, [](Archetype& a) {
+		for (PhysicsObject* object : a.GetPhysicsObjects()) { object->ClearForces(); }
+	});
 }
 
 
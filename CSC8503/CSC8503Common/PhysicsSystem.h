@@ -1,9 +1,18 @@
 #pragma once
 #include "../CSC8503Common/GameWorld.h"
+#include "../../Common/FrameAllocator.h"
+#include "CollisionEvents.h"
 #include <set>
 
 namespace NCL {
 	namespace CSC8503 {
+		//Counters for the last Update, for benchmarking the collision detection
+		struct PhysicsStatistics {
+			uint32_t steps;			// Iterations the update was split into
+			uint32_t pairsTested;	// Pairs handed to the intersection tests
+			uint32_t contacts;		// Pairs found to be intersecting
+		};
+
 		class PhysicsSystem	{
 		public:
 			PhysicsSystem(GameWorld& g);
@@ -22,6 +31,11 @@ namespace NCL {
 			}
 
 			void SetGravity(const Vector3& g);
+
+			//Everything that started or stopped colliding during the last Update
+			const CollisionEventBuffer& GetCollisionEvents() const { return collisionEvents; }
+
+			const PhysicsStatistics& GetStatistics() const { return statistics; }
 		protected:
 			void BasicCollisionDetection();
 			void BroadPhase();
@@ -48,8 +62,10 @@ namespace NCL {
 			float	frameDT;
 
 			std::set<CollisionDetection::CollisionInfo>		allCollisions;
+			CollisionEventBuffer							collisionEvents;
+			PhysicsStatistics								statistics;
 			std::set<CollisionDetection::CollisionInfo>		broadphaseCollisions;
-			std::vector<CollisionDetection::CollisionInfo>	broadphaseCollisionsVec;
+			FrameVector<CollisionDetection::CollisionInfo>	broadphaseCollisionsVec;
 			bool useBroadPhase		= true;
 			int numCollisionFrames	= 1;
 		};
@@ -2,6 +2,7 @@
 #include "../../Common/Vector3.h"
 #include "../../Common/Plane.h"
 #include "Layers.h"
+#include <cfloat>
 
 namespace NCL {
 	namespace Maths {
@@ -10,6 +10,8 @@ RenderObject::RenderObject(Transform* parentTransform, MeshGeometry* mesh, Textu
 	this->texture	= tex;
 	this->shader	= shader;
 	this->colour	= Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	this->occluder	= false;
+	this->isStatic	= false;
 }
 
 RenderObject::~RenderObject() {
@@ -46,12 +46,37 @@ namespace NCL {
 				return colour;
 			}
 
+			//Drawn after everything opaque, blended, from back to front
+			bool IsTransparent() const {
+				return colour.w < 1.0f;
+			}
+
+			//Solid enough, and big enough, to hide whatever is behind its mesh bounds
+			void SetOccluder(bool state) {
+				occluder = state;
+			}
+
+			bool IsOccluder() const {
+				return occluder;
+			}
+
+			//Not expected to move, so its shadow can be drawn once and kept
+			void SetStatic(bool state) {
+				isStatic = state;
+			}
+
+			bool IsStatic() const {
+				return isStatic;
+			}
+
 		protected:
 			MeshGeometry*	mesh;
 			TextureBase*	texture;
 			ShaderBase*		shader;
 			Transform*		transform;
 			Vector4			colour;
+			bool			occluder;
+			bool			isStatic;
 		};
 	}
 }
@@ -34,4 +34,17 @@ void StateMachine::Update() {
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+int StateMachine::GetActiveStateIndex() const {
+	for (size_t i = 0; i < allStates.size(); ++i) {
+		if (allStates[i] == activeState) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+void StateMachine::SetActiveStateIndex(int index) {
+	activeState = (index >= 0 && index < (int)allStates.size()) ? allStates[index] : nullptr;
+}
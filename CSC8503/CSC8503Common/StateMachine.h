@@ -21,6 +21,10 @@ namespace NCL {
 
 			void Update();
 
+			//Position of the active state in the order they were added, or -1 if there isn't one
+			int GetActiveStateIndex() const;
+			void SetActiveStateIndex(int index);
+
 		protected:
 			State * activeState;
 
@@ -56,4 +56,19 @@ void Transform::SetWorldScale(const Vector3& worldScale) {
 
 void Transform::SetLocalScale(const Vector3& newScale) {
 	localScale = newScale;
-}
\ No newline at end of file
+}
+
+void Transform::SaveState(WorldSnapshot& s) const {
+	s.Write(localMatrix);
+	s.Write(worldMatrix);
+	s.Write(localPosition);
+	s.Write(localScale);
+	s.Write(localOrientation);
+	s.Write(worldOrientation);
+}
+
+bool Transform::LoadState(WorldSnapshot& s) {
+	return	s.Read(localMatrix) && s.Read(worldMatrix) &&
+			s.Read(localPosition) && s.Read(localScale) &&
+			s.Read(localOrientation) && s.Read(worldOrientation);
+}
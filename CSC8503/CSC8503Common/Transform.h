@@ -3,6 +3,7 @@
 #include "../../Common/Matrix3.h"
 #include "../../Common/Vector3.h"
 #include "../../Common/Quaternion.h"
+#include "WorldSnapshot.h"
 
 #include <vector>
 
@@ -71,6 +72,10 @@ namespace NCL {
 
 			void UpdateMatrices();
 
+			//Position, orientation and scale - the parent and children are left alone
+			void SaveState(WorldSnapshot& s) const;
+			bool LoadState(WorldSnapshot& s);
+
 		protected:
 			Matrix4		localMatrix;
 			Matrix4		worldMatrix;
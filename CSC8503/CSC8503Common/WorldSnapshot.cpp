@@ -0,0 +1,29 @@
+#include "WorldSnapshot.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace NCL::CSC8503;
+
+bool WorldSnapshot::SaveToFile(const std::string& filename) const {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	file.write(data.data(), data.size());
+	return true;
+}
+
+bool WorldSnapshot::LoadFromFile(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	data.resize((size_t)file.tellg());
+	file.seekg(0);
+	file.read(data.data(), data.size());
+	readOffset = 0;
+	return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		A flat binary copy of a GameWorld's state, written by
+		GameWorld::SaveSnapshot and put back by GameWorld::RestoreSnapshot.
+		Values are copied in and out as raw bytes, so only plain data
+		(floats, vectors, matrices, handles...) can go through it - never
+		pointers.
+
+		Clearing it keeps its memory, so a snapshot that's saved over and over
+		stops allocating once it's big enough.
+		*/
+		class WorldSnapshot {
+		public:
+			/*
+			The maths classes all have empty user-written destructors, which
+			stops them counting as trivially copyable, even though they are
+			only ever a handful of floats - so this settles for standard layout.
+			*/
+			template<typename T>
+			static constexpr bool IsPlainData() {
+				return std::is_standard_layout<T>::value && !std::is_pointer<T>::value;
+			}
+
+			WorldSnapshot() : readOffset(0) {}
+
+			void Clear() {
+				data.clear();
+				readOffset = 0;
+			}
+
+			template<typename T>
+			void Write(const T& value) {
+				static_assert(IsPlainData<T>(), "Snapshots can only hold plain data");
+				WriteBytes(&value, sizeof(T));
+			}
+
+			void WriteBytes(const void* from, size_t bytes) {
+				size_t at = data.size();
+				data.resize(at + bytes);
+				memcpy(data.data() + at, from, bytes);
+			}
+
+			//Fills in a value written earlier, such as a size only known afterwards
+			template<typename T>
+			void Overwrite(size_t offset, const T& value) {
+				static_assert(IsPlainData<T>(), "Snapshots can only hold plain data");
+				if (offset + sizeof(T) <= data.size()) {
+					memcpy(data.data() + offset, &value, sizeof(T));
+				}
+			}
+
+			//Returns false, and leaves value alone, if the snapshot has run out
+			template<typename T>
+			bool Read(T& value) {
+				static_assert(IsPlainData<T>(), "Snapshots can only hold plain data");
+				return ReadBytes(&value, sizeof(T));
+			}
+
+			bool ReadBytes(void* into, size_t bytes) {
+				if (readOffset + bytes > data.size()) {
+					return false;
+				}
+				memcpy(into, data.data() + readOffset, bytes);
+				readOffset += bytes;
+				return true;
+			}
+
+			void	BeginRead()					{ readOffset = 0; }
+			size_t	GetReadOffset() const		{ return readOffset; }
+			void	SetReadOffset(size_t offset){ readOffset = offset < data.size() ? offset : data.size(); }
+
+			size_t	GetSize() const { return data.size(); }
+
+			bool SaveToFile(const std::string& filename) const;
+			bool LoadFromFile(const std::string& filename);
+
+		protected:
+			std::vector<char>	data;
+			size_t				readOffset;
+		};
+	}
+}
@@ -0,0 +1,206 @@
+#include "GameSimulation.h"
+#include "../../Common/Input.h"
+
+#include <fstream>
+
+using namespace NCL::CSC8503;
+
+GameSimulation::GameSimulation() : useGravity(true) {
+	jobSystem = new JobSystem();
+	world = new GameWorld();
+	world->SetJobSystem(jobSystem);
+	physics = new PhysicsSystem(*world);
+	physics->UseGravity(useGravity);
+
+	InitialiseCamera();
+}
+
+GameSimulation::~GameSimulation() {
+	world->ClearAndErase(); // Objects hold asset references too, and the level allocator only frees them with the world
+	assets.ReleaseAll();
+	delete physics;
+	delete world;
+	delete jobSystem;
+}
+
+/*
+The physics is stepped after the objects have updated, so it sees where they
+want to move this frame, and collision events go out once it's finished.
+*/
+void GameSimulation::UpdateSimulation(float dt) {
+	world->UpdateWorld(dt);
+	physics->Update(dt);
+	world->DispatchCollisionEvents(physics->GetCollisionEvents());
+	AppleObject::HandleCollisions(physics->GetCollisionEvents());
+}
+
+void GameSimulation::UpdateRoundControls() {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::F5)) {
+		RestartRound();
+	}
+}
+
+void GameSimulation::InitialiseAssets() {
+	cubeMesh	= (OGLMesh*)assets.Mesh("cube.msh");
+	sphereMesh	= (OGLMesh*)assets.Mesh("sphere.msh");
+
+	basicTex	= (OGLTexture*)assets.Texture("checkerboard.png");
+	basicShader = (OGLShader*)assets.Shader("GameTechVert.glsl", "GameTechFrag.glsl");
+
+	AssetManager::SetPlaceholders(cubeMesh, basicTex);
+
+	// Held for the whole game, so they aren't unloaded and reloaded with each level.
+	// They stream in while the menu is up, rather than holding up the first frame
+	assets.Mesh("Apple.msh", AssetLoad::Streamed);
+	assets.Mesh("goose.msh", AssetLoad::Streamed);
+	assets.Mesh("CharacterA.msh", AssetLoad::Streamed);
+}
+
+void GameSimulation::InitialisePlayers(char controlled) {
+	if (controlled == 'G') {
+		goosePlayer = world->GetLevelAllocator().NewGameObject<GoosePlayer>(world->GetMainCamera());
+		world->AddGameObject(goosePlayer);
+	}
+	if (controlled == 'O') {
+		obsticalPlayer = new ObsticalPlayer(world, physics);
+		world->AddGameObject(obsticalPlayer);
+	}	
+}
+
+void GameSimulation::InitialiseWorld(char controlled) {
+	physics->Clear();
+	world->ClearAndErase();
+	currentMode = controlled;
+
+	if (controlled != ' ') {
+		InitialisePlayers(controlled);
+
+		if (controlled == 'G') {
+			controlledPlayer = goosePlayer;
+			goosePlayer->SetActive(true);
+		}
+		else if (controlled == 'O') {
+			controlledPlayer = obsticalPlayer;
+			obsticalPlayer->SetActive(true);
+		}
+	}
+
+	world->AddGameObject(AddCubeToWorld(Vector3(0.0f, -2.0f, 0.0f), Vector3(100.0f, 2.0f, 100.0f), 0.0f, FLOOR_OBJECT, LAYER_ONE)); // Floor
+	AddBarriersToWorld();
+
+	const string file = "test.txt";
+	if (controlledPlayer && controlledPlayer == goosePlayer) {
+		GenerateLevelFromFile(file);
+		goosePlayer->GetTransform().SetWorldPosition(world->GetSpawnPoint());
+	}
+	world->SaveSnapshot(levelSnapshot);
+}
+
+void GameSimulation::InitialiseCamera() {
+	world->GetMainCamera()->SetNearPlane(0.5f);
+	world->GetMainCamera()->SetFarPlane(500.0f);
+	world->GetMainCamera()->SetPitch(-15.0f);
+	world->GetMainCamera()->SetYaw(315.0f);
+	world->GetMainCamera()->SetPosition(Vector3(-60.0f, 40.0f, 60.0f));
+}
+
+/*
+Puts the level back the way InitialiseWorld left it, by restoring the
+snapshot taken at the end of it over the live objects. If anything from
+the snapshot has been deleted since, the level is built again instead.
+*/
+void GameSimulation::RestartRound() {
+	physics->Clear();
+	if (!world->RestoreSnapshot(levelSnapshot)) {
+		InitialiseWorld(currentMode);
+	}
+}
+
+void GameSimulation::AddBarriersToWorld() {
+	Vector3 horizontalBarrierSize = Vector3(90.0f, 5.0f, 5.0f);
+	Vector3 verticalBarrierSize = Vector3(5.0f, 5.0f, 100.0f);
+
+	world->AddGameObject(AddCubeToWorld(Vector3(0.0f, 5.0f, -95.0f), horizontalBarrierSize, 0.0f, BARRIER_OBJECT, LAYER_ZERO));	// North Barrier
+	world->AddGameObject(AddCubeToWorld(Vector3(0.0f, 5.0f,  95.0f), horizontalBarrierSize, 0.0f, BARRIER_OBJECT, LAYER_ZERO));	// South Barrier
+	world->AddGameObject(AddCubeToWorld(Vector3( 95.0f, 5.0f, 0.0f), verticalBarrierSize,	0.0f, BARRIER_OBJECT, LAYER_ZERO));	// East Barrier
+	world->AddGameObject(AddCubeToWorld(Vector3(-95.0f, 5.0f, 0.0f), verticalBarrierSize,	0.0f, BARRIER_OBJECT, LAYER_ZERO));	// West Barrier
+}
+
+GameObject* GameSimulation::AddCubeToWorld(const Vector3& position, Vector3 dimensions, float inverseMass, string name, uint8_t layer) {
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
+	GameObject* cube = allocator.NewGameObject(name, layer);
+	AABBVolume* volume = allocator.NewAABBVolume(dimensions);
+	cube->SetBoundingVolume((CollisionVolume*)volume);
+	cube->GetTransform().SetWorldPosition(position);
+	cube->GetTransform().SetWorldScale(dimensions);
+	cube->SetRenderObject(allocator.NewRenderObject(&cube->GetTransform(), cubeMesh, basicTex, basicShader));
+	cube->GetRenderObject()->SetOccluder(inverseMass == 0.0f); //The floor, walls and barriers
+	cube->GetRenderObject()->SetStatic(inverseMass == 0.0f);
+	cube->SetPhysicsObject(allocator.NewPhysicsObject(&cube->GetTransform(), cube->GetBoundingVolume()));
+	cube->GetPhysicsObject()->SetInverseMass(inverseMass);
+	cube->GetPhysicsObject()->InitCubeInertia();
+	return cube;
+}
+
+GameObject* GameSimulation::AddSphereToWorld(const Vector3& position, float radius, float inverseMass) {
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
+	GameObject* sphere = allocator.NewGameObject("sphere", LAYER_ONE);
+	Vector3 sphereSize = Vector3(radius, radius, radius);
+	SphereVolume* volume = allocator.NewSphereVolume(radius);
+	sphere->SetBoundingVolume((CollisionVolume*)volume);
+	sphere->GetTransform().SetWorldScale(sphereSize);
+	sphere->GetTransform().SetWorldPosition(position);
+	sphere->SetRenderObject(allocator.NewRenderObject(&sphere->GetTransform(), sphereMesh, basicTex, basicShader));
+	sphere->SetPhysicsObject(allocator.NewPhysicsObject(&sphere->GetTransform(), sphere->GetBoundingVolume()));
+	sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
+	sphere->GetPhysicsObject()->InitSphereInertia();
+	return sphere;
+}
+
+void GameSimulation::GenerateLevelFromFile(const std::string& filename) {
+	std::ifstream infile(Assets::DATADIR + filename);
+
+	infile >> nodeSize;
+	infile >> gridWidth;
+	infile >> gridHeight;
+
+	// Positioning
+	const float offset = 90.0f;
+	const float dimension = nodeSize / 2;	
+
+	Vector3 keeperPos;
+
+	for (size_t z = 0; z < gridWidth; ++z) {
+		for (size_t x = 0; x < gridHeight; ++x) {
+			char type;
+			infile >> type;
+
+			float positionX = ((float)x + 1.0f) * nodeSize - (offset + dimension);
+			float positionY = 5.0f;
+			float positionZ = ((float)z + 1.0f) * nodeSize - (offset + dimension);
+
+			Vector3 position = Vector3(positionX, positionY, positionZ);
+
+			if (type == 'C') {
+				world->AddAdditionStorage(AddCubeToWorld(position, Vector3(5.0f, 5.0f, 5.0f), 0.0f, CUBE_OBJECT, LAYER_ONE));
+			}
+			else if (type == 'S') {
+				world->AddAdditionStorage(AddSphereToWorld(position, 5.0f, 10.0f));
+			}
+			else if (type == 'A') {
+				world->AddAdditionStorage(world->GetLevelAllocator().NewGameObject<AppleObject>(position));
+			}
+			else if (type == 'K') {				
+				keeperPos = position;
+			}
+			else if (type == 'R') {
+				world->SetRoamingPoint(position);
+			}
+			else if (type == 'X') {
+				world->SetSpawnPoint(position);			
+			}
+		}
+	}
+
+	world->AddAdditionStorage(world->GetLevelAllocator().NewGameObject<KeeperAI>(keeperPos, world->GetRoamingPoint(), filename, goosePlayer));
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../CSC8503Common/GoosePlayer.h"
+#include "../CSC8503Common/ObsticalPlayer.h"
+#include "../CSC8503Common/KeeperAI.h"
+#include "../CSC8503Common/AppleObject.h"
+#include "../CSC8503Common/WorldSnapshot.h"
+#include "../CSC8503Common/ObjectNames.h"
+#include "../CSC8503Common/Layers.h"
+
+#include "../../Common/Assets.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/AssetManager.h"
+
+#include <string>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Everything about the game that isn't drawing it - the world, physics,
+		players and level - so that it can be run without a window. The game
+		itself is a TutorialGame, which adds the renderer, menu and network on
+		top; InputReplay runs one of these on its own, to play back recorded
+		input with nothing else in the way.
+
+		Assets still come from the AssetManager, so whoever makes one must
+		register the asset functions (the renderer does this) before calling
+		InitialiseAssets.
+		*/
+		class GameSimulation {
+		public:
+			GameSimulation();
+			virtual ~GameSimulation();
+
+			void InitialiseAssets();
+
+			//Clears the world and builds the level - 'G' for the goose, 'O' for the obstacle editor
+			void InitialiseWorld(char controlled = ' ');
+
+			//Everything a frame does to the world, in the order TutorialGame::UpdateGame does it
+			void UpdateSimulation(float dt);
+
+			//F5 puts the level back how it started
+			void UpdateRoundControls();
+
+			GameWorld*		GetWorld()		const { return world; }
+			PhysicsSystem*	GetPhysics()	const { return physics; }
+
+		protected:
+			bool useGravity;
+
+			// Round Restarting
+			char			currentMode = ' ';
+			WorldSnapshot	levelSnapshot;
+
+			// World Controllers
+			PhysicsSystem*	  physics  = nullptr;
+			GameWorld*		  world	   = nullptr;
+			JobSystem*		  jobSystem = nullptr;
+
+			// Players
+			GameObject*		controlledPlayer = nullptr;
+			GoosePlayer*	goosePlayer		 = nullptr;
+			ObsticalPlayer* obsticalPlayer	 = nullptr;
+
+			// World Assets
+			AssetScope	assets;
+			OGLMesh*	cubeMesh	= nullptr;
+			OGLMesh*	sphereMesh	= nullptr;
+			OGLTexture* basicTex	= nullptr;
+			OGLShader*	basicShader	= nullptr;
+
+			// World Building
+			int nodeSize, gridWidth, gridHeight;
+			string worldFile;
+
+			void InitialisePlayers(char controlled);
+			void InitialiseCamera();
+
+			void RestartRound();
+
+			void AddBarriersToWorld();
+			GameObject* AddCubeToWorld(const Vector3& position, Vector3 dimensions, float inverseMass, string name, uint8_t layer);
+			GameObject* AddSphereToWorld(const Vector3& position, float radius, float inverseMass);
+
+			void GenerateLevelFromFile(const std::string& filename);
+		};
+	}
+}
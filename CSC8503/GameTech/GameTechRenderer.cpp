@@ -1,41 +1,58 @@
 #include "GameTechRenderer.h"
 #include "../CSC8503Common/GameObject.h"
+#include "../../Common/AssetManager.h"
 #include "../../Common/Camera.h"
+#include "../../Common/Profiler.h"
 #include "../../Common/Vector2.h"
 #include "../../Common/Vector3.h"
+
+#include <algorithm>
+#include <cmath>
+
 using namespace NCL;
 using namespace Rendering;
 using namespace CSC8503;
 
 #define SHADOWSIZE 4096
 
+//How long each frame can spend uploading streamed meshes and textures
+const float STREAMING_BUDGET_MSEC = 2.0f;
+
+//Camera command buffers recorded per job thread - a few each, to even out uneven chunks
+const size_t RECORD_CHUNKS_PER_THREAD = 4;
+
 Matrix4 biasMatrix = Matrix4::Translation(Vector3(0.5, 0.5, 0.5)) * Matrix4::Scale(Vector3(0.5, 0.5, 0.5));
 
+namespace {
+	const uint64_t FNV_OFFSET	= 14695981039346656037ull;
+	const uint64_t FNV_PRIME	= 1099511628211ull;
+
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t length) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < length; ++i) {
+			hash = (hash ^ bytes[i]) * FNV_PRIME;
+		}
+		return hash;
+	}
+}
+
 GameTechRenderer::GameTechRenderer(GameWorld& world) : OGLRenderer(*Window::GetWindow()), gameWorld(world)	{
 	glEnable(GL_DEPTH_TEST);
 
 	shadowShader = new OGLShader("GameTechShadowVert.glsl", "GameTechShadowFrag.glsl");
 
-	glGenTextures(1, &shadowTex);
-	glBindTexture(GL_TEXTURE_2D, shadowTex);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
-			     SHADOWSIZE, SHADOWSIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-	
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_R_TO_TEXTURE);
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	glGenFramebuffers(1, &shadowFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,GL_TEXTURE_2D, shadowTex, 0);
-	glDrawBuffer(GL_NONE);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	CreateShadowMap(shadowTex, shadowFBO);
+	CreateShadowMap(staticShadowTex, staticShadowFBO);
+	staticShadowHash	= 0;
+	staticShadowsDirty	= true;
+	currentShadowTex	= shadowTex;
 
 	glClearColor(1, 1, 1, 1);
 
+	glGenBuffers(1, &instanceBuffer);
+	instanceBufferSize = 0;
+	occludedCount		= 0;
+
 	//Set up the light properties
 	lightColour = Vector4(0.8f, 0.8f, 0.5f, 1.0f);
 	lightRadius = 1000.0f;
@@ -45,144 +62,510 @@ GameTechRenderer::GameTechRenderer(GameWorld& world) : OGLRenderer(*Window::GetW
 GameTechRenderer::~GameTechRenderer()	{
 	glDeleteTextures(1, &shadowTex);
 	glDeleteFramebuffers(1, &shadowFBO);
+	glDeleteTextures(1, &staticShadowTex);
+	glDeleteFramebuffers(1, &staticShadowFBO);
+	glDeleteBuffers(1, &instanceBuffer);
+}
+
+void GameTechRenderer::CreateShadowMap(GLuint& texture, GLuint& fbo) {
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
+			     SHADOWSIZE, SHADOWSIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_R_TO_TEXTURE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,GL_TEXTURE_2D, texture, 0);
+	glDrawBuffer(GL_NONE);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void GameTechRenderer::RenderFrame() {
-	glEnable(GL_CULL_FACE);
+	PROFILE_SCOPE("Renderer::RenderFrame");
 	glClearColor(1, 1, 1, 1);
+	AssetManager::UpdateStreaming(STREAMING_BUDGET_MSEC);
+	glState.Invalidate(); //Uploads bind whatever they're uploading to
+	glState.SetCullFace(true);
 	BuildObjectList();
 	SortObjectList();
+	BuildInstanceBatches();
 	RenderShadowMap();
 	RenderCamera();
-	glDisable(GL_CULL_FACE); //Todo - text indices are going the wrong way...
+	glState.SetCullFace(false); //Todo - text indices are going the wrong way...
 }
 
+/*
+Every active object's mesh bounds are moved into world space, then culled
+against the camera's and the light's frustums, giving each pass its own
+list. Objects that aren't seen by either never reach the GPU at all.
+
+Whatever the camera can see is then tested against the occluders it can
+see, drawn into a small depth buffer on the CPU. The shadow pass skips
+this, as what's hidden from the camera can still cast a shadow into view.
+
+Shadow casters are kept in two lists, static and moving, and the static
+ones are hashed to tell whether the cached shadow map needs redrawing.
+*/
 void GameTechRenderer::BuildObjectList() {
-	std::vector<GameObject*>::const_iterator first;
-	std::vector<GameObject*>::const_iterator last;
+	PROFILE_SCOPE("Renderer::BuildObjectList");
+	ResetFrameContainer(activeObjects);
+	ResetFrameContainer(shadowCasters);
+	ResetFrameContainer(staticShadowCasters);
+	cullObjects.clear();
+	cullBounds.Clear();
+	cullOccluders.clear();
+
+	gameWorld.QueryArchetypes(COMPONENT_RENDER, [&](Archetype& a) {
+		const std::vector<GameObject*>&		objects = a.GetObjects();
+		const std::vector<RenderObject*>&	renders = a.GetRenderObjects();
+
+		for (size_t i = 0; i < objects.size(); ++i) {
+			if (!objects[i]->IsActive()) {
+				continue;
+			}
+			MeshGeometry* mesh = AssetManager::DrawableMesh(renders[i]->GetMesh());
+			if (!mesh) {
+				continue;
+			}
+			Matrix4 modelMatrix = renders[i]->GetTransform()->GetWorldMatrix();
+			Vector3 centre;
+			Vector3 halfSize;
+			if (mesh->GetVertexCount() > 0) {
+				//The box around the transformed mesh box
+				const float* m	= modelMatrix.array;
+				Vector3 c		= mesh->GetBoundsCentre();
+				Vector3 h		= mesh->GetBoundsHalfSize();
+				centre		= Vector3(m[0] * c.x + m[4] * c.y + m[8] * c.z + m[12],
+										m[1] * c.x + m[5] * c.y + m[9] * c.z + m[13],
+										m[2] * c.x + m[6] * c.y + m[10] * c.z + m[14]);
+				halfSize	= Vector3(fabsf(m[0]) * h.x + fabsf(m[4]) * h.y + fabsf(m[8]) * h.z,
+										fabsf(m[1]) * h.x + fabsf(m[5]) * h.y + fabsf(m[9]) * h.z,
+										fabsf(m[2]) * h.x + fabsf(m[6]) * h.y + fabsf(m[10]) * h.z);
+			}
+			else if (objects[i]->GetBroadphaseAABB(halfSize)) {
+				centre = modelMatrix.GetPositionVector();
+			}
+			else {
+				activeObjects.emplace_back(renders[i]); //Nothing to cull it by
+				(renders[i]->IsStatic() ? staticShadowCasters : shadowCasters).emplace_back(renders[i]);
+				continue;
+			}
+			if (renders[i]->IsOccluder() && mesh->GetVertexCount() > 0) {
+				cullOccluders.emplace_back(cullObjects.size());
+			}
+			cullObjects.emplace_back(renders[i]);
+			cullBounds.Add(centre, halfSize);
+		}
+	});
 
-	gameWorld.GetObjectIterators(first, last);
+	float screenAspect	= (float)currentWidth / (float)currentHeight;
+	Camera* camera		= gameWorld.GetMainCamera();
+	Matrix4 cameraViewProj	= camera->BuildProjectionMatrix(screenAspect) * camera->BuildViewMatrix();
+	Frustum cameraFrustum(cameraViewProj);
 
-	activeObjects.clear();
+	Matrix4 shadowViewMatrix = Matrix4::BuildViewMatrix(lightPosition, Vector3(0, 0, 0), Vector3(0, 1, 0));
+	Matrix4 shadowProjMatrix = Matrix4::Perspective(100.0f, 500.0f, 1, 45.0f);
+	shadowViewProjMatrix	= shadowProjMatrix * shadowViewMatrix;
+	shadowMatrix			= biasMatrix * shadowViewProjMatrix;
+	Frustum shadowFrustum(shadowViewProjMatrix);
+
+	cameraVisible.resize(cullObjects.size());
+	shadowVisible.resize(cullObjects.size());
+	if (!cullObjects.empty()) {
+		cameraFrustum.CullBoxes(cullBounds, cameraVisible.data());
+		shadowFrustum.CullBoxes(cullBounds, shadowVisible.data());
+	}
 
-	for (std::vector<GameObject*>::const_iterator i = first; i != last; ++i) {
-		if ((*i)->IsActive()) {
-			const RenderObject*g = (*i)->GetRenderObject();
-			if (g) {
-				activeObjects.emplace_back(g);
+	occludedCount = 0;
+	if (!cullOccluders.empty()) {
+		PROFILE_SCOPE("Renderer::OcclusionCull");
+		occlusionCuller.Clear(cameraViewProj);
+		for (size_t i : cullOccluders) {
+			if (cameraVisible[i]) {
+				MeshGeometry* mesh = AssetManager::DrawableMesh(cullObjects[i]->GetMesh());
+				occlusionCuller.AddOccluder(cullObjects[i]->GetTransform()->GetWorldMatrix(), mesh->GetBoundsCentre(), mesh->GetBoundsHalfSize());
 			}
 		}
+		JobSystem* jobs = gameWorld.GetJobSystem();
+		occlusionCuller.Rasterise(jobs);
+		for (uint8_t v : cameraVisible) {
+			occludedCount += v;
+		}
+		occlusionCuller.CullBoxes(cullBounds, cameraVisible.data(), jobs);
+		for (uint8_t v : cameraVisible) {
+			occludedCount -= v;
+		}
+	}
+	for (size_t i = 0; i < cullObjects.size(); ++i) {
+		if (cameraVisible[i]) {
+			activeObjects.emplace_back(cullObjects[i]);
+		}
+		if (shadowVisible[i]) {
+			(cullObjects[i]->IsStatic() ? staticShadowCasters : shadowCasters).emplace_back(cullObjects[i]);
+		}
+	}
+
+	//Anything static being added, removed, moved or finishing streaming in changes this
+	uint64_t staticHash = HashBytes(FNV_OFFSET, &shadowViewProjMatrix, sizeof(Matrix4));
+	for (const RenderObject* o : staticShadowCasters) {
+		const MeshGeometry* mesh = AssetManager::DrawableMesh(o->GetMesh());
+		Matrix4 modelMatrix = o->GetTransform()->GetWorldMatrix();
+		staticHash = HashBytes(staticHash, &o, sizeof(o));
+		staticHash = HashBytes(staticHash, &mesh, sizeof(mesh));
+		staticHash = HashBytes(staticHash, &modelMatrix, sizeof(Matrix4));
+	}
+	if (staticHash != staticShadowHash) {
+		staticShadowHash	= staticHash;
+		staticShadowsDirty	= true;
 	}
 }
 
-void GameTechRenderer::SortObjectList() {
+/*
+Sort keys, from the most significant bit down:
+
+	Opaque:			0 | shader | texture | mesh | depth
+	Transparent:	1 | inverted depth | shader | texture | mesh
+
+so everything opaque comes first, grouped to keep program, texture and
+vertex array changes down, and front to back within each group so early
+depth testing throws away as much as it can. Transparent objects have to
+blend over whatever is behind them, so distance is all that matters.
+
+IDs are the GL object names, which are small and handed out in order;
+any that don't fit are wrapped, which only costs a few extra switches.
+*/
+namespace {
+	const int		DEPTH_BITS		= 24;
+	const int		ID_BITS			= 13;
+	const int		SHADER_BITS		= 12;
+	const uint64_t	DEPTH_MAX		= (1ull << DEPTH_BITS) - 1;
+	const uint64_t	ID_MASK			= (1ull << ID_BITS) - 1;
+	const uint64_t	SHADER_MASK		= (1ull << SHADER_BITS) - 1;
+	const uint64_t	TRANSPARENT_BIT = 1ull << 63;
+
+	/*
+	Least significant byte first, flipping between the two buffers. Any
+	byte that's the same in every key is skipped, which for keys like these
+	is usually most of them.
+	*/
+	template<class T>
+	void RadixSort(std::vector<T>& items, std::vector<T>& scratch) {
+		const size_t count = items.size();
+		scratch.resize(count);
+
+		size_t histograms[8][256] = { 0 };
+		for (const T& item : items) {
+			for (int b = 0; b < 8; ++b) {
+				histograms[b][(item.key >> (b * 8)) & 0xFF]++;
+			}
+		}
+		T* from = items.data();
+		T* to	= scratch.data();
+		for (int b = 0; b < 8; ++b) {
+			size_t* histogram = histograms[b];
+			if (histogram[(from[0].key >> (b * 8)) & 0xFF] == count) {
+				continue;
+			}
+			size_t offset = 0;
+			for (int i = 0; i < 256; ++i) {
+				size_t n		= histogram[i];
+				histogram[i]	= offset;
+				offset += n;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				to[histogram[(from[i].key >> (b * 8)) & 0xFF]++] = from[i];
+			}
+			std::swap(from, to);
+		}
+		if (from != items.data()) {
+			items.swap(scratch);
+		}
+	}
+}
+
+uint64_t GameTechRenderer::BuildSortKey(const RenderObject& o, const Matrix4& viewMatrix, float depthScale) const {
+	MeshGeometry*	mesh	= AssetManager::DrawableMesh(o.GetMesh());
+	TextureBase*	texture	= AssetManager::DrawableTexture(o.GetDefaultTexture());
+
+	uint64_t shaderID	= ((OGLShader*)o.GetShader())->GetProgramID() & SHADER_MASK;
+	uint64_t textureID	= texture	? ((OGLTexture*)texture)->GetObjectID() & ID_MASK	: 0;
+	uint64_t meshID		= mesh		? ((OGLMesh*)mesh)->GetVAO() & ID_MASK				: 0;
 
+	//Distance along the view direction, from the view matrix's third row
+	Vector3 position	= o.GetTransform()->GetWorldPosition();
+	const float* m		= viewMatrix.array;
+	float viewDepth		= -(m[2] * position.x + m[6] * position.y + m[10] * position.z + m[14]);
+	float scaledDepth	= viewDepth * depthScale;
+	uint64_t depth		= scaledDepth <= 0.0f ? 0 : (scaledDepth >= (float)DEPTH_MAX ? DEPTH_MAX : (uint64_t)scaledDepth);
+
+	if (o.IsTransparent()) {
+		return TRANSPARENT_BIT | ((DEPTH_MAX - depth) << (SHADER_BITS + ID_BITS * 2)) |
+			(shaderID << (ID_BITS * 2)) | (textureID << ID_BITS) | meshID;
+	}
+	return (shaderID << (ID_BITS * 2 + DEPTH_BITS)) | (textureID << (ID_BITS + DEPTH_BITS)) | (meshID << DEPTH_BITS) | depth;
 }
 
-void GameTechRenderer::RenderShadowMap() {
-	glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
-	glClear(GL_DEPTH_BUFFER_BIT);	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);	glViewport(0, 0, SHADOWSIZE, SHADOWSIZE);
+/*
+Shadow casters all use the same shader and no texture, so they're only
+sorted by mesh, which is all their batches are split by.
+*/
+void GameTechRenderer::SortObjectList() {
+	PROFILE_SCOPE("Renderer::SortObjectList");
+	Camera* camera		= gameWorld.GetMainCamera();
+	Matrix4 viewMatrix	= camera->BuildViewMatrix();
+	float	depthScale	= DEPTH_MAX / camera->GetFarPlane();
+
+	if (!activeObjects.empty()) {
+		sortItems.resize(activeObjects.size());
+		for (size_t i = 0; i < activeObjects.size(); ++i) {
+			sortItems[i] = { BuildSortKey(*activeObjects[i], viewMatrix, depthScale), activeObjects[i] };
+		}
+		RadixSort(sortItems, sortScratch);
+		for (size_t i = 0; i < sortItems.size(); ++i) {
+			activeObjects[i] = sortItems[i].object;
+		}
+	}
+	SortByMesh(shadowCasters);
+	if (staticShadowsDirty) {
+		SortByMesh(staticShadowCasters);
+	}
+}
 
-	glCullFace(GL_FRONT);
+void GameTechRenderer::SortByMesh(FrameVector<const RenderObject*>& objects) {
+	if (objects.empty()) {
+		return;
+	}
+	sortItems.resize(objects.size());
+	for (size_t i = 0; i < objects.size(); ++i) {
+		OGLMesh* mesh = (OGLMesh*)AssetManager::DrawableMesh(objects[i]->GetMesh());
+		sortItems[i] = { mesh ? (uint64_t)mesh->GetVAO() : 0, objects[i] };
+	}
+	RadixSort(sortItems, sortScratch);
+	for (size_t i = 0; i < sortItems.size(); ++i) {
+		objects[i] = sortItems[i].object;
+	}
+}
 
-	BindShader(shadowShader);
-	int mvpLocation = glGetUniformLocation(shadowShader->GetProgramID(), "mvpMatrix");
+/*
+The lists are already sorted, so a batch is just a run of neighbours that
+match; transparent objects only batch with their neighbours too, so they
+stay in back to front order. Shadow casters get batches of their own, in
+the same instance buffer after the camera's.
+*/
+void GameTechRenderer::AddInstanceBatches(const FrameVector<const RenderObject*>& objects, FrameVector<InstanceBatch>& batches, bool meshOnly) {
+	for (const RenderObject* o : objects) {
+		//Anything still streaming in is drawn with the placeholders, or not at all
+		OGLMesh*	mesh		= (OGLMesh*)AssetManager::DrawableMesh(o->GetMesh());
+		OGLTexture*	texture		= meshOnly ? nullptr : (OGLTexture*)AssetManager::DrawableTexture(o->GetDefaultTexture());
+		OGLShader*	shader		= meshOnly ? nullptr : (OGLShader*)o->GetShader();
+		bool		transparent = meshOnly ? false : o->IsTransparent();
+		if (!mesh) {
+			continue;
+		}
+		if (batches.empty() || batches.back().mesh != mesh || batches.back().texture != texture ||
+			batches.back().shader != shader || batches.back().transparent != transparent) {
+			batches.push_back({ mesh, shader, texture, (int)instanceData.size(), 0, transparent });
+		}
+		batches.back().instanceCount++;
+		instanceData.push_back({ o->GetTransform()->GetWorldMatrix(), o->GetColour() });
+	}
+}
 
-	Matrix4 shadowViewMatrix = Matrix4::BuildViewMatrix(lightPosition, Vector3(0, 0, 0), Vector3(0,1,0));
-	Matrix4 shadowProjMatrix = Matrix4::Perspective(100.0f, 500.0f, 1, 45.0f);
+void GameTechRenderer::BuildInstanceBatches() {
+	PROFILE_SCOPE("Renderer::BuildInstanceBatches");
+	ResetFrameContainer(instanceBatches);
+	ResetFrameContainer(shadowBatches);
+	ResetFrameContainer(staticShadowBatches);
+	instanceData.clear();
+
+	AddInstanceBatches(activeObjects, instanceBatches, false);
+	AddInstanceBatches(shadowCasters, shadowBatches, true);
+	if (staticShadowsDirty) {
+		AddInstanceBatches(staticShadowCasters, staticShadowBatches, true);
+	}
+
+	if (instanceData.empty()) {
+		return;
+	}
+	//Orphaned every frame, so the driver never has to wait on last frame's draws
+	size_t bytes = instanceData.size() * sizeof(InstanceData);
+	if (bytes > instanceBufferSize) {
+		instanceBufferSize = bytes * 2;
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, instanceBufferSize, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instanceData.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	const OGLMesh::InstanceAttribute attributes[] = {
+		{ 8,  4, 0  },	// Model matrix, one column per slot
+		{ 9,  4, 16 },
+		{ 10, 4, 32 },
+		{ 11, 4, 48 },
+		{ 12, 4, 64 }	// Colour
+	};
+	bool vaoChanged = false;
+	for (FrameVector<InstanceBatch>* batches : { &instanceBatches, &shadowBatches, &staticShadowBatches }) {
+		for (const InstanceBatch& b : *batches) {
+			if (b.mesh->GetInstanceBuffer() != instanceBuffer) {
+				b.mesh->SetInstanceBuffer(instanceBuffer, sizeof(InstanceData), attributes, 5);
+				vaoChanged = true;
+			}
+		}
+	}
+	if (vaoChanged) {
+		glState.Invalidate();
+	}
+}
 
-	Matrix4 mvMatrix = shadowProjMatrix * shadowViewMatrix;
+void GameTechRenderer::RenderShadowMap() {
+	PROFILE_SCOPE("Renderer::RenderShadowMap");
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glViewport(0, 0, SHADOWSIZE, SHADOWSIZE);
 
-	shadowMatrix = biasMatrix * mvMatrix; //we'll use this one later on
+	glState.SetCullFace(true, GL_FRONT);
 
-	for (const auto&i : activeObjects) {
-		Matrix4 modelMatrix = (*i).GetTransform()->GetWorldMatrix();
-		Matrix4 mvpMatrix	= mvMatrix * modelMatrix;
-		glUniformMatrix4fv(mvpLocation, 1, false, (float*)&mvpMatrix);
-		BindMesh((*i).GetMesh());
-		DrawBoundMesh();
+	BindShader(shadowShader);
+	glUniformMatrix4fv(shadowShader->GetUniformLocation(ShaderUniform::ViewProjMatrix), 1, false, (float*)&shadowViewProjMatrix);
+
+	if (staticShadowsDirty) {
+		PROFILE_SCOPE("Renderer::RenderStaticShadows");
+		glBindFramebuffer(GL_FRAMEBUFFER, staticShadowFBO);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		DrawShadowBatches(staticShadowBatches);
+		staticShadowsDirty = false;
+	}
+	if (shadowBatches.empty()) {
+		currentShadowTex = staticShadowTex;
+	}
+	else {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, staticShadowFBO);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, shadowFBO);
+		glBlitFramebuffer(0, 0, SHADOWSIZE, SHADOWSIZE, 0, 0, SHADOWSIZE, SHADOWSIZE, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
+		DrawShadowBatches(shadowBatches);
+		currentShadowTex = shadowTex;
 	}
 
 	glViewport(0, 0, currentWidth, currentHeight);
 	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-	glCullFace(GL_BACK);
+	glState.SetCullFace(true, GL_BACK);
+}
+
+void GameTechRenderer::DrawShadowBatches(const FrameVector<InstanceBatch>& batches) {
+	for (const InstanceBatch& b : batches) {
+		BindMesh(b.mesh);
+		DrawBoundMesh(0, b.instanceCount, b.firstInstance);
+	}
 }
 
 void GameTechRenderer::RenderCamera() {
+	PROFILE_SCOPE("Renderer::RenderCamera");
 	float screenAspect = (float)currentWidth / (float)currentHeight;
 	Matrix4 viewMatrix = gameWorld.GetMainCamera()->BuildViewMatrix();
 	Matrix4 projMatrix = gameWorld.GetMainCamera()->BuildProjectionMatrix(screenAspect);
-
-	OGLShader* activeShader = nullptr;
-	int projLocation	= 0;
-	int viewLocation	= 0;
-	int modelLocation	= 0;
-	int colourLocation  = 0;
-	int hasVColLocation = 0;
-	int hasTexLocation  = 0;
-	int shadowLocation  = 0;
-
-	int lightPosLocation	= 0;
-	int lightColourLocation = 0;
-	int lightRadiusLocation = 0;
-
-	int cameraLocation = 0;
-
-	//TODO - PUT IN FUNCTION
-	glActiveTexture(GL_TEXTURE0 + 1);
-	glBindTexture(GL_TEXTURE_2D, shadowTex);
-
-	for (const auto&i : activeObjects) {
-		OGLShader* shader = (OGLShader*)(*i).GetShader();
-		BindShader(shader);
-
-		BindTextureToShader((OGLTexture*)(*i).GetDefaultTexture(), "mainTex", 0);
-
-		if (activeShader != shader) {
-			projLocation	= glGetUniformLocation(shader->GetProgramID(), "projMatrix");
-			viewLocation	= glGetUniformLocation(shader->GetProgramID(), "viewMatrix");
-			modelLocation	= glGetUniformLocation(shader->GetProgramID(), "modelMatrix");
-			shadowLocation  = glGetUniformLocation(shader->GetProgramID(), "shadowMatrix");
-			colourLocation  = glGetUniformLocation(shader->GetProgramID(), "objectColour");
-			hasVColLocation = glGetUniformLocation(shader->GetProgramID(), "hasVertexColours");
-			hasTexLocation  = glGetUniformLocation(shader->GetProgramID(), "hasTexture");
-
-			lightPosLocation	= glGetUniformLocation(shader->GetProgramID(), "lightPos");
-			lightColourLocation = glGetUniformLocation(shader->GetProgramID(), "lightColour");
-			lightRadiusLocation = glGetUniformLocation(shader->GetProgramID(), "lightRadius");
-
-			cameraLocation = glGetUniformLocation(shader->GetProgramID(), "cameraPos");
-			glUniform3fv(cameraLocation, 1, (float*)&gameWorld.GetMainCamera()->GetPosition());
-
-			glUniformMatrix4fv(projLocation, 1, false, (float*)&projMatrix);
-			glUniformMatrix4fv(viewLocation, 1, false, (float*)&viewMatrix);
-
-			glUniform3fv(lightPosLocation	, 1, (float*)&lightPosition);
-			glUniform4fv(lightColourLocation, 1, (float*)&lightColour);
-			glUniform1f(lightRadiusLocation , lightRadius);
-
-			int shadowTexLocation = glGetUniformLocation(shader->GetProgramID(), "shadowTex");
-			glUniform1i(shadowTexLocation, 1);
-
-			activeShader = shader;
+	Vector3 cameraPos  = gameWorld.GetMainCamera()->GetPosition();
+	int		shadowUnit = 1;
+
+	const UniformValue frameUniforms[] = {
+		{ (int)ShaderUniform::CameraPos,	UniformType::Vector3, &cameraPos },
+		{ (int)ShaderUniform::ProjMatrix,	UniformType::Matrix4, &projMatrix },
+		{ (int)ShaderUniform::ViewMatrix,	UniformType::Matrix4, &viewMatrix },
+		{ (int)ShaderUniform::ShadowMatrix, UniformType::Matrix4, &shadowMatrix },
+		{ (int)ShaderUniform::LightPos,		UniformType::Vector3, &lightPosition },
+		{ (int)ShaderUniform::LightColour,	UniformType::Vector4, &lightColour },
+		{ (int)ShaderUniform::LightRadius,	UniformType::Float, &lightRadius },
+		{ (int)ShaderUniform::ShadowTex,	UniformType::Int, &shadowUnit }
+	};
+	const int frameUniformCount = sizeof(frameUniforms) / sizeof(frameUniforms[0]);
+
+	/*
+	Split by the number of threads rather than a fixed size, so that even a
+	few dozen batches are spread across them. Each chunk sends the frame
+	uniforms again, so there are only ever a few chunks per thread.
+	*/
+	JobSystem*	jobs		= gameWorld.GetJobSystem();
+	size_t		parts		= jobs ? jobs->GetThreadCount() * RECORD_CHUNKS_PER_THREAD : 1;
+	size_t		chunkSize	= std::max((size_t)1, instanceBatches.size() / parts);
+	size_t		chunks		= (instanceBatches.size() + chunkSize - 1) / chunkSize;
+	if (cameraCommands.size() < chunks) {
+		cameraCommands.resize(chunks);
+	}
+	for (size_t i = 0; i < chunks; ++i) {
+		cameraCommands[i].Reset();
+	}
+	{
+		PROFILE_SCOPE("Renderer::RecordCamera");
+		auto record = [&](size_t begin, size_t end) {
+			for (size_t chunk = begin; chunk < end; ++chunk) {
+				size_t first	= chunk * chunkSize;
+				size_t last		= std::min(first + chunkSize, instanceBatches.size());
+				RecordCameraBatches(cameraCommands[chunk], first, last, frameUniforms, frameUniformCount);
+			}
+		};
+		if (jobs) {
+			jobs->ParallelFor(chunks, 1, record);
 		}
+		else {
+			record(0, chunks);
+		}
+	}
 
-		Matrix4 modelMatrix = (*i).GetTransform()->GetWorldMatrix();
-		glUniformMatrix4fv(modelLocation, 1, false, (float*)&modelMatrix);			
-		
-		Matrix4 fullShadowMat = shadowMatrix * modelMatrix;
-		glUniformMatrix4fv(shadowLocation, 1, false, (float*)&fullShadowMat);
+	glState.BindTexture(shadowUnit, currentShadowTex);
 
-		glUniform4fv(colourLocation, 1, (float*)&i->GetColour());
+	for (size_t i = 0; i < chunks; ++i) {
+		ExecuteCommandBuffer(cameraCommands[i]);
+	}
+	glState.SetBlend(false);
+}
 
-		glUniform1i(hasVColLocation, !(*i).GetMesh()->GetColourData().empty());
+/*
+Uniforms belong to the shader, so the per-frame ones only need sending
+the first time each shader is met - once per chunk, as chunks don't know
+what the others have sent. The list is sorted, so once the transparent
+batches start it's all of them.
+*/
+void GameTechRenderer::RecordCameraBatches(RenderCommandBuffer& buffer, size_t first, size_t last, const UniformValue* frameUniforms, int frameUniformCount) const {
+	const int MAX_SHADERS = 16;
+	const ShaderBase*	shadersSent[MAX_SHADERS];
+	int					shadersSentCount = 0;
+
+	const InstanceBatch* previous = nullptr;
+	for (size_t i = first; i < last; ++i) {
+		const InstanceBatch& b = instanceBatches[i];
+
+		if (!previous || previous->shader != b.shader || previous->transparent != b.transparent) {
+			buffer.SetPipeline({ b.shader, b.transparent ? BlendMode::Alpha : BlendMode::Opaque, CullMode::Back, true });
+		}
+		buffer.BindTexture(b.texture, (int)ShaderUniform::MainTex, 0);
 
-		glUniform1i(hasTexLocation, (OGLTexture*)(*i).GetDefaultTexture() ? 1:0);
+		if (std::find(shadersSent, shadersSent + shadersSentCount, b.shader) == shadersSent + shadersSentCount) {
+			buffer.SetUniforms(frameUniforms, frameUniformCount);
+			if (shadersSentCount < MAX_SHADERS) {
+				shadersSent[shadersSentCount++] = b.shader;
+			}
+		}
 
-		BindMesh((*i).GetMesh());
-		DrawBoundMesh();
+		int hasVertexColours	= b.mesh->HasChunk(GeometryChunkTypes::VColors) ? 1 : 0;
+		int hasTexture			= b.texture ? 1 : 0;
+		const UniformValue batchUniforms[] = {
+			{ (int)ShaderUniform::HasVertexColours, UniformType::Int, &hasVertexColours },
+			{ (int)ShaderUniform::HasTexture,		UniformType::Int, &hasTexture }
+		};
+		buffer.SetUniforms(batchUniforms, 2);
+
+		buffer.BindMesh(b.mesh);
+		buffer.DrawInstanced(b.instanceCount, b.firstInstance);
+		previous = &b;
 	}
 }
 
@@ -193,7 +576,7 @@ void GameTechRenderer::SetupDebugMatrix(OGLShader*s) {
 
 	Matrix4 vp = projMatrix * viewMatrix;
 
-	int matLocation = glGetUniformLocation(s->GetProgramID(), "viewProjMatrix");
+	int matLocation = s->GetUniformLocation(ShaderUniform::ViewProjMatrix);
 
 	glUniformMatrix4fv(matLocation, 1, false, (float*)&vp);
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include "../../Plugins/OpenGLRendering/OGLMesh.h"
 
 #include "../CSC8503Common/GameWorld.h"
+#include "../../Common/Frustum.h"
+#include "../../Common/OcclusionCuller.h"
+#include "../../Common/RenderCommandBuffer.h"
 
 namespace NCL {
 	class Maths::Vector3;
@@ -17,6 +20,11 @@ namespace NCL {
 			GameTechRenderer(GameWorld& world);
 			~GameTechRenderer();
 
+			//Objects inside the camera's frustum that were hidden behind occluders last frame
+			int GetOccludedCount() const {
+				return occludedCount;
+			}
+
 		protected:
 			void RenderFrame()	override;
 
@@ -26,18 +34,100 @@ namespace NCL {
 
 			void BuildObjectList();
 			void SortObjectList();
+			void SortByMesh(FrameVector<const RenderObject*>& objects);
+			void BuildInstanceBatches();
 			void RenderShadowMap();
+			void CreateShadowMap(GLuint& texture, GLuint& fbo);
 			void RenderCamera(); 
 
 			void SetupDebugMatrix(OGLShader*s) override;
 
-			vector<const RenderObject*> activeObjects;
+			//What the camera and the shadow casting light can each see
+			FrameVector<const RenderObject*> activeObjects;
+			FrameVector<const RenderObject*> shadowCasters;
+			FrameVector<const RenderObject*> staticShadowCasters;
+
+			//World space bounds of every active object, culled against both frustums
+			std::vector<const RenderObject*>	cullObjects;
+			BoxList								cullBounds;
+			std::vector<uint8_t>				cameraVisible;
+			std::vector<uint8_t>				shadowVisible;
+
+			//Indices into cullObjects of those marked as occluders
+			std::vector<size_t>					cullOccluders;
+			OcclusionCuller						occlusionCuller;
+			int									occludedCount;
+
+			/*
+			Each object's place in the draw order, packed into one integer so the
+			whole list can be radix sorted. The buffers live as long as the
+			renderer, so sorting doesn't allocate once they've grown to fit.
+			*/
+			struct SortItem {
+				uint64_t			key;
+				const RenderObject* object;
+			};
+			uint64_t BuildSortKey(const RenderObject& o, const Matrix4& viewMatrix, float depthScale) const;
+
+			std::vector<SortItem>	sortItems;
+			std::vector<SortItem>	sortScratch;
+
+			/*
+			Runs of sorted objects sharing a mesh, shader and texture, drawn
+			with a single instanced call. Each object's model matrix and colour
+			go into one instance buffer, shared by every batch, so a batch is
+			just a range of it.
+			*/
+			struct InstanceData {
+				Matrix4 modelMatrix;
+				Vector4 colour;
+			};
+			struct InstanceBatch {
+				OGLMesh*	mesh;
+				OGLShader*	shader;
+				OGLTexture*	texture;
+				int			firstInstance;
+				int			instanceCount;
+				bool		transparent;
+			};
+			void AddInstanceBatches(const FrameVector<const RenderObject*>& objects, FrameVector<InstanceBatch>& batches, bool meshOnly);
+			void DrawShadowBatches(const FrameVector<InstanceBatch>& batches);
+
+			/*
+			The camera's batches are split into chunks, each recorded into its own
+			command buffer by whichever thread the JobSystem hands it to, then
+			replayed in order. Recording only reads the batches, so it can run
+			away from the GL context.
+			*/
+			void RecordCameraBatches(RenderCommandBuffer& buffer, size_t first, size_t last, const UniformValue* frameUniforms, int frameUniformCount) const;
+
+			std::vector<RenderCommandBuffer> cameraCommands;
+
+			std::vector<InstanceData>		instanceData;
+			FrameVector<InstanceBatch>		instanceBatches;
+			FrameVector<InstanceBatch>		shadowBatches;
+			FrameVector<InstanceBatch>		staticShadowBatches;
+			GLuint							instanceBuffer;
+			size_t							instanceBufferSize;
 
 			//shadow mapping things
 			OGLShader*	shadowShader;
 			GLuint		shadowTex;
 			GLuint		shadowFBO;
+
+			/*
+			Static casters are drawn into a map of their own, which is only
+			redrawn when the hash of what's in it changes, and copied into the
+			main map each frame before the moving casters are added. With nothing
+			moving in the light's view, the cached map is sampled directly.
+			*/
+			GLuint		staticShadowTex;
+			GLuint		staticShadowFBO;
+			uint64_t	staticShadowHash;
+			bool		staticShadowsDirty;
+			GLuint		currentShadowTex;
 			Matrix4     shadowMatrix;
+			Matrix4		shadowViewProjMatrix;
 
 			Vector4		lightColour;
 			float		lightRadius;
@@ -1,4 +1,5 @@
 #include "../../Common/Window.h"
+#include "../../Common/Input.h"
 
 #include "../CSC8503Common/StateMachine.h"
 #include "../CSC8503Common/StateTransition.h"
@@ -92,6 +93,31 @@ void DisplayPathfinding() {
 
 
 
+/*
+Sets up recording or playback of the game's input, from the command line:
+	-record <file>	writes every frame's keyboard, mouse and dt to the file
+	-replay <file>	plays a recording back instead of the real input, using
+					its dt for each frame, and prints how long each took
+	-mode <G|O>		skips the menu and goes straight into the goose or
+					obstacle level - record with this to replay in InputReplay
+*/
+bool ReadInputArguments(int argc, char** argv, char& mode) {
+	bool ok = true;
+	for (int i = 1; i + 1 < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "-record") {
+			ok = ok && Input::StartRecording(argv[i + 1]);
+		}
+		else if (arg == "-replay") {
+			ok = ok && Input::StartPlayback(argv[i + 1]);
+		}
+		else if (arg == "-mode") {
+			mode = argv[i + 1][0];
+		}
+	}
+	return ok;
+}
+
 /* 
 The main function should look pretty familar to you!
 We make a window, and then go into a while loop that repeatedly
@@ -99,11 +125,14 @@ runs our 'game' until we press escape. Instead of making a 'renderer'
 and updating it, we instead make a whole game, and repeatedly update that, instead. 
 This time, we've added some extra functionality to the window class - we can hide or show the 
 */
-int main() {
+int main(int argc, char** argv) {
 	Window* w = Window::CreateGameWindow("CSC8503 Game Technology!", 1720, 1000);
 
 	if (!w->HasInitialised()) { return -1; }	
 
+	char startMode = ' ';
+	if (!ReadInputArguments(argc, argv, startMode)) { return -1; }
+
 	//TestStateMachine();
 	//TestNetworking();
 	//TestPathfinding();
@@ -112,12 +141,19 @@ int main() {
 	w->LockMouseToWindow(true);
 
 	TutorialGame* g = new TutorialGame();	
+	if (startMode == 'G' || startMode == 'O') {
+		g->EnterLevel(startMode);
+	}
+
+	GameTimer frameTimer;
+	double totalUpdateMSec	= 0.0;
+	float maxUpdateMSec		= 0.0f;
 
 	w->GetTimer()->GetTimeDeltaSeconds();
-	while (w->UpdateWindow() && !Window::GetKeyboard()->KeyDown(KeyboardKeys::ESCAPE)) {
+	while (w->UpdateWindow() && !Window::GetKeyboard()->KeyDown(KeyboardKeys::ESCAPE) && !Input::PlaybackFinished()) {
 		float dt = w->GetTimer()->GetTimeDeltaSeconds();
 
-		if (dt > 0.1f) {
+		if (dt > 0.1f && !Input::IsPlayingBack()) {
 			std::cout << "Skipping large time delta" << std::endl;
 			continue; // Must have hit a breakpoint or something to have a 1 second frame time!
 		}
@@ -127,12 +163,30 @@ int main() {
 		if (Window::GetKeyboard()->KeyPressed(KeyboardKeys::NEXT)) {
 			w->ShowConsole(false);
 		}
+		if (!Input::UpdateFrame(dt)) {
+			break; // The recording has run out
+		}
 
 		//DisplayPathfinding();
 
-		w->SetTitle("Gametech frame time:" + std::to_string(1000.0f * dt));
+		w->SetTitle("Gametech frame time:" + std::to_string(1000.0f * dt) +
+			" frame allocator overflows:" + std::to_string(FrameAllocator::Get().GetHeapAllocations()));
 
+		frameTimer.Tick();
 		g->UpdateGame(dt);
+		frameTimer.Tick();
+
+		if (Input::IsPlayingBack()) {
+			float updateMSec = frameTimer.GetTimeDeltaMSec();
+			totalUpdateMSec += updateMSec;
+			maxUpdateMSec	= std::max(maxUpdateMSec, updateMSec);
+			std::cout << "Frame " << Input::GetFrameNumber() << " dt " << (1000.0f * dt) << "ms update " << updateMSec << "ms" << std::endl;
+		}
+	}
+	if (Input::IsPlayingBack() && Input::GetFrameNumber() > 0) {
+		std::cout << "Replayed " << Input::GetFrameNumber() << " frames, update mean " << (totalUpdateMSec / Input::GetFrameNumber())
+			<< "ms max " << maxUpdateMSec << "ms" << std::endl;
 	}
+	Input::Stop();
 	Window::DestroyGameWindow();
 }
\ No newline at end of file
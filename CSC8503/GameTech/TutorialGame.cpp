@@ -2,55 +2,46 @@
 
 using namespace NCL::CSC8503;
 
-TutorialGame::TutorialGame() : forceMagnitude(10.0f), useGravity(true) {
-	world = new GameWorld();
+TutorialGame::TutorialGame() : forceMagnitude(10.0f) {
 	renderer = new GameTechRenderer(*world);
-	physics = new PhysicsSystem(*world);
-	physics->UseGravity(useGravity);
+	Debug::SetRenderer(renderer);
 
-	InitialiseAssets();
-	InitialiseCamera();
+	InitialiseAssets(); // Once the renderer has registered how to make them
 	InitialiseNetwork();
 	InitialiseMenu();
 }
 
 TutorialGame::~TutorialGame() {
-	delete cubeMesh;
-	delete sphereMesh;
-	delete basicTex;
-	delete basicShader;
-	delete physics;
+	AssetManager::StopStreaming();
+	AssetManager::SetPlaceholders(nullptr, nullptr);
+	world->ClearAndErase(); // Objects hold asset references too, and the level allocator only frees them with the world
+	assets.ReleaseAll(); // While the renderer is still around to delete them
 	delete renderer;
-	delete world;
+	Debug::SetRenderer(nullptr);
 
 	NetworkBase::Destroy();
 }
 
 void TutorialGame::UpdateGame(float dt) {
-	world->UpdateWorld(dt);
+	FrameAllocator::Get().BeginFrame();
+	Profiler::NewFrame();
+	PROFILE_SCOPE("TutorialGame::UpdateGame");
+
+	UpdateSimulation(dt);
 	renderer->Update(dt);
-	physics->Update(dt);
+	UpdateProfiler();
+	Debug::FlushRenderables();
 	renderer->Render();
 
 	if (selectMode) {
 		LockedMenuCamera();
 		char mode = SelectObject();
-		if (mode != ' ') {
-			if (mode == 'G') {
-				selectMode = false;
-				Window::GetWindow()->ShowOSPointer(false);
-				Window::GetWindow()->LockMouseToWindow(true);
-				InitialiseWorld(mode);
-			}
-			else if (mode == 'O') {
-				selectMode = false;
-				Window::GetWindow()->ShowOSPointer(false);
-				Window::GetWindow()->LockMouseToWindow(true);
-				InitialiseWorld(mode);
-			}
+		if (mode == 'G' || mode == 'O') {
+			EnterLevel(mode);
 		}
 	}	
 	else {
+		UpdateRoundControls();
 		server->SendGlobalPacket(StringPacket("Server says hello!")); // Message Server
 		client->SendPacket(StringPacket("Client says hello!")); // Message Client
 		server->UpdateServer();
@@ -58,18 +49,60 @@ void TutorialGame::UpdateGame(float dt) {
 	}
 }
 
-void TutorialGame::InitialiseAssets() {
-	auto loadFunc = [](const string& name, OGLMesh** into) {
-		*into = new OGLMesh(name);
-		(*into)->SetPrimitiveType(GeometryPrimitive::Triangles);
-		(*into)->UploadToGPU();
-	};
-
-	loadFunc("cube.msh", &cubeMesh);
-	loadFunc("sphere.msh", &sphereMesh);
+/*
+Leaves the menu for a level. Main calls this straight away when given -mode,
+so that a recording made that way starts where InputReplay starts from.
+*/
+void TutorialGame::EnterLevel(char mode) {
+	selectMode = false;
+	Window::GetWindow()->ShowOSPointer(false);
+	Window::GetWindow()->LockMouseToWindow(true);
+	InitialiseWorld(mode);
+}
 
-	basicTex	= (OGLTexture*)TextureLoader::LoadAPITexture("checkerboard.png");
-	basicShader = new OGLShader("GameTechVert.glsl", "GameTechFrag.glsl");
+/*
+F1 toggles the per-scope timings overlay, and F2 saves a Chrome trace of
+the last few frames next to the executable.
+*/
+void TutorialGame::UpdateProfiler() {
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::F1)) {
+		showProfiler = !showProfiler;
+	}
+	if (Input::GetKeyboard()->KeyPressed(NCL::KeyboardKeys::F2)) {
+		if (Profiler::WriteChromeTrace("profile.json")) {
+			std::cout << "Saved profile.json" << std::endl;
+		}
+	}
+	if (!showProfiler) {
+		return;
+	}
+	Profiler::GetStatistics(profilerStats);
+
+	//Debug::Print positions are in pixels from the bottom left, so this works down from the top
+	const float lineHeight	= 20.0f;
+	float		y			= Window::GetWindow()->GetScreenSize().y - lineHeight;
+	char		line[128];
+
+	const OGLStateTracker::Counters& glCalls = renderer->GetStateCounters();
+	snprintf(line, sizeof(line), "GL state calls  %d issued / %d elided, %d draws", glCalls.issued, glCalls.elided, renderer->GetDrawCallCount());
+	Debug::Print(line, Vector2(10.0f, y));
+	y -= lineHeight;
+	snprintf(line, sizeof(line), "Occluded objects  %d", renderer->GetOccludedCount());
+	Debug::Print(line, Vector2(10.0f, y));
+	y -= lineHeight;
+
+	Debug::Print("Scope  avg ms / max ms / calls", Vector2(10.0f, y));
+	for (size_t i = 0; i < profilerStats.size(); ++i) {
+		y -= lineHeight;
+		if (y < lineHeight && i + 1 < profilerStats.size()) {
+			snprintf(line, sizeof(line), "...and %d more", (int)(profilerStats.size() - i));
+			Debug::Print(line, Vector2(10.0f, y));
+			break;
+		}
+		const Profiler::ScopeStatistics& s = profilerStats[i];
+		snprintf(line, sizeof(line), "%s  %.3f / %.3f / %.1f", s.name, s.averageMSec, s.maxMSec, s.callsPerFrame);
+		Debug::Print(line, Vector2(10.0f, y));
+	}
 }
 
 void TutorialGame::InitialiseNetwork() {
@@ -84,78 +117,31 @@ void TutorialGame::InitialiseNetwork() {
 	client->Connect(127, 0, 0, 1, port);
 }
 
-void TutorialGame::InitialisePlayers(char controlled) {
-	if (controlled == 'G') {
-		goosePlayer = new GoosePlayer(world->GetMainCamera());
-		world->AddGameObject(goosePlayer);
-	}
-	if (controlled == 'O') {
-		obsticalPlayer = new ObsticalPlayer(world, physics);
-		world->AddGameObject(obsticalPlayer);
-	}	
-}
-
 void TutorialGame::InitialiseMenu() {
+	GameObjectAllocator& allocator = world->GetLevelAllocator();
 	Vector3 dimensions = Vector3(15.0f, 15.0f, 15.0f);
-	AABBVolume* cubeVolume = new AABBVolume(dimensions);
-	SphereVolume* sphereVolume = new SphereVolume(5.0f);
 
-	GameObject* gooseMode	 = new GameObject(GOOSE_MODE, LAYER_ONE);	
-	gooseMode->SetBoundingVolume((CollisionVolume*)cubeVolume);
+	GameObject* gooseMode	 = allocator.NewGameObject(GOOSE_MODE, LAYER_ONE);	
+	gooseMode->SetBoundingVolume((CollisionVolume*)allocator.NewAABBVolume(dimensions));
 	gooseMode->GetTransform().SetWorldPosition(Vector3(25.0f, 5.0f, 5.0f));
 	gooseMode->GetTransform().SetWorldScale(dimensions);
-	gooseMode->SetRenderObject(new RenderObject(&gooseMode->GetTransform(), cubeMesh, basicTex, basicShader));
-	gooseMode->SetPhysicsObject(new PhysicsObject(&gooseMode->GetTransform(), gooseMode->GetBoundingVolume()));
+	gooseMode->SetRenderObject(allocator.NewRenderObject(&gooseMode->GetTransform(), cubeMesh, basicTex, basicShader));
+	gooseMode->SetPhysicsObject(allocator.NewPhysicsObject(&gooseMode->GetTransform(), gooseMode->GetBoundingVolume()));
 	gooseMode->GetPhysicsObject()->SetInverseMass(0.0f);
 	gooseMode->GetPhysicsObject()->InitCubeInertia();
 	world->AddGameObject(gooseMode);
 
-	GameObject* obsticalMode = new GameObject(OBSTICAL_MODE, LAYER_ONE);
-	obsticalMode->SetBoundingVolume((CollisionVolume*)sphereVolume);
+	GameObject* obsticalMode = allocator.NewGameObject(OBSTICAL_MODE, LAYER_ONE);
+	obsticalMode->SetBoundingVolume((CollisionVolume*)allocator.NewSphereVolume(5.0f));
 	obsticalMode->GetTransform().SetWorldPosition(Vector3(-25.0f, 5.0f, 5.0f));
 	obsticalMode->GetTransform().SetWorldScale(dimensions);
-	obsticalMode->SetRenderObject(new RenderObject(&obsticalMode->GetTransform(), sphereMesh, basicTex, basicShader));
-	obsticalMode->SetPhysicsObject(new PhysicsObject(&obsticalMode->GetTransform(), obsticalMode->GetBoundingVolume()));
+	obsticalMode->SetRenderObject(allocator.NewRenderObject(&obsticalMode->GetTransform(), sphereMesh, basicTex, basicShader));
+	obsticalMode->SetPhysicsObject(allocator.NewPhysicsObject(&obsticalMode->GetTransform(), obsticalMode->GetBoundingVolume()));
 	obsticalMode->GetPhysicsObject()->SetInverseMass(0.0f);
 	obsticalMode->GetPhysicsObject()->InitSphereInertia();
 	world->AddGameObject(obsticalMode);
 }
 
-void TutorialGame::InitialiseWorld(char controlled) {
-	physics->Clear();
-	world->ClearAndErase();
-
-	if (controlled != ' ') {
-		InitialisePlayers(controlled);
-
-		if (controlled == 'G') {
-			controlledPlayer = goosePlayer;
-			goosePlayer->SetActive(true);
-		}
-		else if (controlled == 'O') {
-			controlledPlayer = obsticalPlayer;
-			obsticalPlayer->SetActive(true);
-		}
-	}
-
-	world->AddGameObject(AddCubeToWorld(Vector3(0.0f, -2.0f, 0.0f), Vector3(100.0f, 2.0f, 100.0f), 0.0f, FLOOR_OBJECT, LAYER_ONE)); // Floor
-	AddBarriersToWorld();
-
-	const string file = "test.txt";
-	if (controlledPlayer && controlledPlayer == goosePlayer) {
-		GenerateLevelFromFile(file);
-		goosePlayer->GetTransform().SetWorldPosition(world->GetSpawnPoint());
-	}
-}
-
-void TutorialGame::InitialiseCamera() {
-	world->GetMainCamera()->SetNearPlane(0.5f);
-	world->GetMainCamera()->SetFarPlane(500.0f);
-	world->GetMainCamera()->SetPitch(-15.0f);
-	world->GetMainCamera()->SetYaw(315.0f);
-	world->GetMainCamera()->SetPosition(Vector3(-60.0f, 40.0f, 60.0f));
-}
-
 void TutorialGame::LockedMenuCamera() {
 	Window::GetWindow()->ShowOSPointer(true);
 	Window::GetWindow()->LockMouseToWindow(false);
@@ -167,146 +153,19 @@ void TutorialGame::LockedMenuCamera() {
 }
 
 char TutorialGame::SelectObject() {
-	if (Window::GetMouse()->ButtonDown(NCL::MouseButtons::LEFT)) {
+	if (Input::GetMouse()->ButtonDown(NCL::MouseButtons::LEFT)) {
 		Ray ray = CollisionDetection::BuildRayFromMouse(*world->GetMainCamera());
 
 		RayCollision closestCollision;
 		if (world->Raycast(ray, closestCollision, true)) {
 			GameObject* selectionObject = (GameObject*)closestCollision.node;
 			
-			if (selectionObject->GetName() == OBSTICAL_MODE) {
-				return 'O';
-			}
-			else if (selectionObject->GetName() == GOOSE_MODE) {
-				return 'G';
+			switch (selectionObject->GetTag()) {
+				case TAG_OBSTICAL_MODE:	return 'O';
+				case TAG_GOOSE_MODE:	return 'G';
+				default:				break;
 			}
 		}
 	}
 	return ' ';
 }
-
-void TutorialGame::AddBarriersToWorld() {
-	Vector3 horizontalBarrierSize = Vector3(90.0f, 5.0f, 5.0f);
-	Vector3 verticalBarrierSize = Vector3(5.0f, 5.0f, 100.0f);
-	AABBVolume* horizontalVolume = new AABBVolume(horizontalBarrierSize);
-	AABBVolume* verticalVolume = new AABBVolume(verticalBarrierSize);
-
-	// North Barrier
-	GameObject* barrierNorth = new GameObject(BARRIER_OBJECT, LAYER_ZERO);
-	barrierNorth->SetBoundingVolume((CollisionVolume*)horizontalVolume);
-	barrierNorth->GetTransform().SetWorldScale(horizontalBarrierSize);
-	barrierNorth->GetTransform().SetWorldPosition(Vector3(0.0f, 5.0f, -95.0f));
-	barrierNorth->SetRenderObject(new RenderObject(&barrierNorth->GetTransform(), cubeMesh, basicTex, basicShader));
-	barrierNorth->SetPhysicsObject(new PhysicsObject(&barrierNorth->GetTransform(), barrierNorth->GetBoundingVolume()));
-	barrierNorth->GetPhysicsObject()->SetInverseMass(0.0f);
-	barrierNorth->GetPhysicsObject()->InitCubeInertia();
-	world->AddGameObject(barrierNorth);
-
-	// South Barrier
-	GameObject* barrierSouth = new GameObject(BARRIER_OBJECT, LAYER_ZERO);
-	barrierSouth->SetBoundingVolume((CollisionVolume*)horizontalVolume);
-	barrierSouth->GetTransform().SetWorldScale(horizontalBarrierSize);
-	barrierSouth->GetTransform().SetWorldPosition(Vector3(0.0f, 5.0f, 95.0f));
-	barrierSouth->SetRenderObject(new RenderObject(&barrierSouth->GetTransform(), cubeMesh, basicTex, basicShader));
-	barrierSouth->SetPhysicsObject(new PhysicsObject(&barrierSouth->GetTransform(), barrierSouth->GetBoundingVolume()));
-	barrierSouth->GetPhysicsObject()->SetInverseMass(0.0f);
-	barrierSouth->GetPhysicsObject()->InitCubeInertia();
-	world->AddGameObject(barrierSouth);
-
-	// East Barrier	   
-	GameObject* barrierEast = new GameObject(BARRIER_OBJECT, LAYER_ZERO);
-	barrierEast->SetBoundingVolume((CollisionVolume*)verticalVolume);
-	barrierEast->GetTransform().SetWorldScale(verticalBarrierSize);
-	barrierEast->GetTransform().SetWorldPosition(Vector3(95.0f, 5.0f, 0.0f));
-	barrierEast->SetRenderObject(new RenderObject(&barrierEast->GetTransform(), cubeMesh, basicTex, basicShader));
-	barrierEast->SetPhysicsObject(new PhysicsObject(&barrierEast->GetTransform(), barrierEast->GetBoundingVolume()));
-	barrierEast->GetPhysicsObject()->SetInverseMass(0.0f);
-	barrierEast->GetPhysicsObject()->InitCubeInertia();
-	world->AddGameObject(barrierEast);
-
-	// West Barrier
-	GameObject* barrierWest = new GameObject(BARRIER_OBJECT, LAYER_ZERO);
-	barrierWest->SetBoundingVolume((CollisionVolume*)verticalVolume);
-	barrierWest->GetTransform().SetWorldScale(verticalBarrierSize);
-	barrierWest->GetTransform().SetWorldPosition(Vector3(-95.0f, 5.0f, 0.0f));
-	barrierWest->SetRenderObject(new RenderObject(&barrierWest->GetTransform(), cubeMesh, basicTex, basicShader));
-	barrierWest->SetPhysicsObject(new PhysicsObject(&barrierWest->GetTransform(), barrierWest->GetBoundingVolume()));
-	barrierWest->GetPhysicsObject()->SetInverseMass(0.0f);
-	barrierWest->GetPhysicsObject()->InitCubeInertia();
-	world->AddGameObject(barrierWest);
-}
-
-GameObject* TutorialGame::AddCubeToWorld(const Vector3& position, Vector3 dimensions, float inverseMass, string name, uint8_t layer) {
-	GameObject* cube = new GameObject(name, layer);
-	AABBVolume* volume = new AABBVolume(dimensions);
-	cube->SetBoundingVolume((CollisionVolume*)volume);
-	cube->GetTransform().SetWorldPosition(position);
-	cube->GetTransform().SetWorldScale(dimensions);
-	cube->SetRenderObject(new RenderObject(&cube->GetTransform(), cubeMesh, basicTex, basicShader));
-	cube->SetPhysicsObject(new PhysicsObject(&cube->GetTransform(), cube->GetBoundingVolume()));
-	cube->GetPhysicsObject()->SetInverseMass(inverseMass);
-	cube->GetPhysicsObject()->InitCubeInertia();
-	return cube;
-}
-
-GameObject* TutorialGame::AddSphereToWorld(const Vector3& position, float radius, float inverseMass) {
-	GameObject* sphere = new GameObject("sphere", LAYER_ONE);
-	Vector3 sphereSize = Vector3(radius, radius, radius);
-	SphereVolume* volume = new SphereVolume(radius);
-	sphere->SetBoundingVolume((CollisionVolume*)volume);
-	sphere->GetTransform().SetWorldScale(sphereSize);
-	sphere->GetTransform().SetWorldPosition(position);
-	sphere->SetRenderObject(new RenderObject(&sphere->GetTransform(), sphereMesh, basicTex, basicShader));
-	sphere->SetPhysicsObject(new PhysicsObject(&sphere->GetTransform(), sphere->GetBoundingVolume()));
-	sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
-	sphere->GetPhysicsObject()->InitSphereInertia();
-	return sphere;
-}
-
-void TutorialGame::GenerateLevelFromFile(const std::string& filename) {
-	std::ifstream infile(Assets::DATADIR + filename);
-
-	infile >> nodeSize;
-	infile >> gridWidth;
-	infile >> gridHeight;
-
-	// Positioning
-	const float offset = 90.0f;
-	const float dimension = nodeSize / 2;	
-
-	Vector3 keeperPos;
-
-	for (size_t z = 0; z < gridWidth; ++z) {
-		for (size_t x = 0; x < gridHeight; ++x) {
-			char type;
-			infile >> type;
-
-			float positionX = ((float)x + 1.0f) * nodeSize - (offset + dimension);
-			float positionY = 5.0f;
-			float positionZ = ((float)z + 1.0f) * nodeSize - (offset + dimension);
-
-			Vector3 position = Vector3(positionX, positionY, positionZ);
-
-			if (type == 'C') {
-				world->AddAdditionStorage(AddCubeToWorld(position, Vector3(5.0f, 5.0f, 5.0f), 0.0f, CUBE_OBJECT, LAYER_ONE));
-			}
-			else if (type == 'S') {
-				world->AddAdditionStorage(AddSphereToWorld(position, 5.0f, 10.0f));
-			}
-			else if (type == 'A') {
-				world->AddAdditionStorage(new AppleObject(position));
-			}
-			else if (type == 'K') {				
-				keeperPos = position;
-			}
-			else if (type == 'R') {
-				world->SetRoamingPoint(position);
-			}
-			else if (type == 'X') {
-				world->SetSpawnPoint(position);			
-			}
-		}
-	}
-
-	world->AddAdditionStorage(new KeeperAI(keeperPos, world->GetRoamingPoint(), filename, goosePlayer));
-}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "../../Common/MeshGeometry.h"
+#include "../../Common/Assets.h"
+#include "../../Common/GameTimer.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace NCL;
+
+/*
+Converts text .msh files into the binary mesh format, which MeshGeometry
+maps straight into memory instead of parsing:
+
+	MeshConverter [--out directory] mesh.msh [mesh.msh ...]
+
+Meshes are read from Assets/Meshes, and by default written back over the
+originals - the binary files keep the same name, so nothing that loads
+them needs to change. Files that are already binary are left alone.
+*/
+
+//Only here to get at MeshGeometry's loading - nothing is ever uploaded
+class ConverterMesh : public MeshGeometry {
+public:
+	ConverterMesh(const std::string& filename) : MeshGeometry(filename) {}
+	void UploadToGPU() override {}
+};
+
+bool IsBinaryMesh(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	char magic[4] = { 0 };
+	file.read(magic, sizeof(magic));
+	return memcmp(magic, "NMSH", sizeof(magic)) == 0;
+}
+
+double LoadMSec(const std::string& filename, GameTimer& timer) {
+	timer.Tick();
+	ConverterMesh mesh(filename);
+	timer.Tick();
+	return timer.GetTimeDeltaMSec();
+}
+
+int main(int argc, char** argv) {
+	std::string					outputDir = Assets::MESHDIR;
+	std::vector<std::string>	meshes;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--out" && i + 1 < argc) {
+			outputDir = argv[++i];
+			if (!outputDir.empty() && outputDir.back() != '/' && outputDir.back() != '\\') {
+				outputDir += "/";
+			}
+		}
+		else {
+			meshes.emplace_back(arg);
+		}
+	}
+	if (meshes.empty()) {
+		std::cout << "Usage: MeshConverter [--out directory] mesh.msh [mesh.msh ...]" << std::endl;
+		return 1;
+	}
+
+	GameTimer	timer;
+	int			failures = 0;
+	for (const std::string& name : meshes) {
+		if (IsBinaryMesh(Assets::MESHDIR + name)) {
+			std::cout << name << " is already binary, skipping" << std::endl;
+			continue;
+		}
+		double			textMSec = LoadMSec(name, timer);
+		ConverterMesh	mesh(name);
+		if (mesh.GetVertexCount() == 0 || !mesh.SaveBinary(outputDir + name)) {
+			std::cout << name << " couldn't be converted!" << std::endl;
+			failures++;
+			continue;
+		}
+		std::cout << name << ": " << mesh.GetVertexCount() << " vertices, " << mesh.GetIndexCount() << " indices, text load " << textMSec << "ms";
+		if (outputDir == Assets::MESHDIR) {
+			std::cout << ", binary load " << LoadMSec(name, timer) << "ms";
+		}
+		std::cout << std::endl;
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include "BenchmarkScenarios.h"
+#include "../CSC8503Common/ObjectNames.h"
+#include "../CSC8503Common/Layers.h"
+#include "../../Common/Assets.h"
+
+#include <fstream>
+#include <iostream>
+#include <random>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	std::string levelFile = Assets::DATADIR + "test.txt";
+
+	GameObject* AddCube(GameWorld& world, const Vector3& position, const Vector3& dimensions, float inverseMass, const std::string& name, uint8_t layer) {
+		GameObjectAllocator& allocator = world.GetLevelAllocator();
+		GameObject* cube = allocator.NewGameObject(name, layer);
+		cube->SetBoundingVolume((CollisionVolume*)allocator.NewAABBVolume(dimensions));
+		cube->GetTransform().SetWorldPosition(position);
+		cube->GetTransform().SetWorldScale(dimensions);
+		cube->SetPhysicsObject(allocator.NewPhysicsObject(&cube->GetTransform(), cube->GetBoundingVolume()));
+		cube->GetPhysicsObject()->SetInverseMass(inverseMass);
+		cube->GetPhysicsObject()->InitCubeInertia();
+		world.AddGameObject(cube);
+		return cube;
+	}
+
+	GameObject* AddSphere(GameWorld& world, const Vector3& position, float radius, float inverseMass, const std::string& name = SPHERE_OBJECT) {
+		GameObjectAllocator& allocator = world.GetLevelAllocator();
+		GameObject* sphere = allocator.NewGameObject(name, LAYER_ONE);
+		sphere->SetBoundingVolume((CollisionVolume*)allocator.NewSphereVolume(radius));
+		sphere->GetTransform().SetWorldScale(Vector3(radius, radius, radius));
+		sphere->GetTransform().SetWorldPosition(position);
+		sphere->SetPhysicsObject(allocator.NewPhysicsObject(&sphere->GetTransform(), sphere->GetBoundingVolume()));
+		sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
+		sphere->GetPhysicsObject()->InitSphereInertia();
+		world.AddGameObject(sphere);
+		return sphere;
+	}
+
+	//Matches TutorialGame's floor and barriers
+	void AddArena(GameWorld& world) {
+		AddCube(world, Vector3(0.0f, -2.0f, 0.0f), Vector3(100.0f, 2.0f, 100.0f), 0.0f, FLOOR_OBJECT, LAYER_ONE);
+
+		Vector3 horizontalBarrierSize	= Vector3(90.0f, 5.0f, 5.0f);
+		Vector3 verticalBarrierSize		= Vector3(5.0f, 5.0f, 100.0f);
+
+		AddCube(world, Vector3(0.0f, 5.0f, -95.0f), horizontalBarrierSize, 0.0f, BARRIER_OBJECT, LAYER_ZERO);
+		AddCube(world, Vector3(0.0f, 5.0f,  95.0f), horizontalBarrierSize, 0.0f, BARRIER_OBJECT, LAYER_ZERO);
+		AddCube(world, Vector3( 95.0f, 5.0f, 0.0f), verticalBarrierSize,	 0.0f, BARRIER_OBJECT, LAYER_ZERO);
+		AddCube(world, Vector3(-95.0f, 5.0f, 0.0f), verticalBarrierSize,	 0.0f, BARRIER_OBJECT, LAYER_ZERO);
+	}
+
+	//Spreads count items over a square grid, spacing units apart, centred on the origin
+	Vector3 GridPosition(int index, int count, float spacing, float height) {
+		int side = 1;
+		while (side * side < count) {
+			side++;
+		}
+		float start = -(side - 1) * spacing * 0.5f;
+		return Vector3(start + (index % side) * spacing, height, start + (index / side) * spacing);
+	}
+}
+
+void BenchmarkScenarios::BuildFallingSpheres(GameWorld& world, int count) {
+	AddArena(world);
+
+	std::mt19937 random(8503);
+	std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+
+	const int perLayer = 400; // Keeps each layer inside the barriers
+	for (int i = 0; i < count; ++i) {
+		int layer = i / perLayer;
+		Vector3 position = GridPosition(i % perLayer, count < perLayer ? count : perLayer, 4.0f, 3.0f + layer * 2.5f);
+		position += Vector3(jitter(random), jitter(random), jitter(random));
+		AddSphere(world, position, 1.0f, 1.0f);
+	}
+}
+
+void BenchmarkScenarios::BuildStackedCubes(GameWorld& world, int count) {
+	AddArena(world);
+
+	const int towerHeight	= 10;
+	const int towers		= (count + towerHeight - 1) / towerHeight;
+	for (int i = 0; i < count; ++i) {
+		Vector3 position = GridPosition(i / towerHeight, towers, 6.0f, 1.0f + (i % towerHeight) * 2.01f);
+		AddCube(world, position, Vector3(1.0f, 1.0f, 1.0f), 1.0f, CUBE_OBJECT, LAYER_ONE);
+	}
+}
+
+/*
+Reads the same grid file as TutorialGame::GenerateLevelFromFile. Apples are
+added as the plain spheres their physics amounts to - the keeper needs the
+goose to chase and a navigation grid, so is left out.
+*/
+void BenchmarkScenarios::BuildLevel(GameWorld& world, int) {
+	AddArena(world);
+
+	std::ifstream infile(levelFile);
+	if (!infile) {
+		std::cout << __FUNCTION__ << " can't open " << levelFile << std::endl;
+		return;
+	}
+	int nodeSize	= 0;
+	int gridWidth	= 0;
+	int gridHeight	= 0;
+	infile >> nodeSize >> gridWidth >> gridHeight;
+
+	const float offset		= 90.0f;
+	const float dimension	= nodeSize / 2.0f;
+
+	for (int z = 0; z < gridWidth; ++z) {
+		for (int x = 0; x < gridHeight; ++x) {
+			char type;
+			infile >> type;
+
+			Vector3 position = Vector3(
+				(x + 1.0f) * nodeSize - (offset + dimension),
+				5.0f,
+				(z + 1.0f) * nodeSize - (offset + dimension));
+
+			if (type == CUBE_SHORT) {
+				AddCube(world, position, Vector3(5.0f, 5.0f, 5.0f), 0.0f, CUBE_OBJECT, LAYER_ONE);
+			}
+			else if (type == SPHERE_SHORT) {
+				AddSphere(world, position, 5.0f, 10.0f);
+			}
+			else if (type == APPLE_SHORT) {
+				AddSphere(world, position, 0.7f, 1.0f, APPLE_OBJECT);
+			}
+		}
+	}
+}
+
+void BenchmarkScenarios::BuildMixedShapes(GameWorld& world, int count) {
+	AddArena(world);
+
+	std::mt19937 random(8503);
+	std::uniform_real_distribution<float> size(0.5f, 2.0f);
+	std::uniform_real_distribution<float> mass(0.2f, 2.0f);
+	std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+
+	const int perLayer = 300;
+	for (int i = 0; i < count; ++i) {
+		int layer = i / perLayer;
+		Vector3 position = GridPosition(i % perLayer, count < perLayer ? count : perLayer, 5.0f, 3.0f + layer * 4.5f);
+		position += Vector3(jitter(random), jitter(random), jitter(random));
+
+		float s = size(random);
+		float m = mass(random);
+		if (i % 2 == 0) {
+			AddSphere(world, position, s, m);
+		}
+		else {
+			AddCube(world, position, Vector3(s, s, s), m, CUBE_OBJECT, LAYER_ONE);
+		}
+	}
+}
+
+void BenchmarkScenarios::SetLevelFile(const std::string& path) {
+	levelFile = path;
+}
+
+const std::vector<BenchmarkScenarios::Scenario>& BenchmarkScenarios::GetScenarios() {
+	static const std::vector<Scenario> scenarios = {
+		{ "spheres",	BuildFallingSpheres },
+		{ "stacks",		BuildStackedCubes },
+		{ "level",		BuildLevel },
+		{ "mixed",		BuildMixedShapes },
+	};
+	return scenarios;
+}
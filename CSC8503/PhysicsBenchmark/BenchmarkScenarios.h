@@ -0,0 +1,40 @@
+#pragma once
+#include "../CSC8503Common/GameWorld.h"
+
+#include <string>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		The scenes the physics benchmark can run. They're built straight into a
+		GameWorld, the same way TutorialGame builds its level, but without any
+		render objects - so nothing here needs a window or a GL context.
+
+		Everything is placed deterministically (random offsets come from a fixed
+		seed), so two runs of the same scenario step exactly the same objects.
+		*/
+		namespace BenchmarkScenarios {
+			struct Scenario {
+				std::string name;
+				void (*build)(GameWorld& world, int count);
+			};
+
+			//count spheres dropped onto the floor from a grid of heights
+			void BuildFallingSpheres(GameWorld& world, int count);
+
+			//count cubes, stacked into towers of 10 resting on the floor
+			void BuildStackedCubes(GameWorld& world, int count);
+
+			//The game's level, read from SetLevelFile's file - count is unused
+			void BuildLevel(GameWorld& world, int count);
+
+			//count spheres and cubes of varying sizes and masses, dropped together
+			void BuildMixedShapes(GameWorld& world, int count);
+
+			void SetLevelFile(const std::string& path);
+
+			const std::vector<Scenario>& GetScenarios();
+		}
+	}
+}
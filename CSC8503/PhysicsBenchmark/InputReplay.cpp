@@ -0,0 +1,142 @@
+#include "../GameTech/GameSimulation.h"
+
+#include "../../Common/Input.h"
+#include "../../Common/GameTimer.h"
+#include "../../Common/TextureLoader.h"
+#include "../../Common/FrameAllocator.h"
+#include "../../Common/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace NCL;
+using namespace NCL::CSC8503;
+using namespace NCL::Rendering;
+
+/*
+Plays a recording made by the game back without a window - the world,
+physics and gameplay objects are all run as the game runs them, but nothing
+is drawn. Record with the game's -record and -mode options, so the recording
+starts as the level does, and this replays it frame by frame:
+
+	cd CSC8503/PhysicsBenchmark
+	../../build/PhysicsBenchmark/InputReplay <recording> [--mode G|O] [--quiet]
+
+Prints each frame's update time (unless --quiet), a mean/max summary, and a
+hash of every object's final position and orientation - two runs of the
+same recording should always give the same hash.
+*/
+
+//Assets are still loaded through the AssetManager, but there's nothing to upload them to
+class ReplayMesh : public MeshGeometry {
+public:
+	void UploadToGPU() override {}
+};
+
+class ReplayTexture : public TextureBase {
+};
+
+class ReplayShader : public ShaderBase {
+public:
+	void ReloadShader() override {}
+};
+
+void RegisterReplayAssets() {
+	AssetManager::RegisterMeshCreateFunction([]() -> MeshGeometry* { return new ReplayMesh(); });
+	AssetManager::RegisterTextureFunctions(
+		[]() -> TextureBase* { return new ReplayTexture(); },
+		[](TextureBase*, const TextureContainer&) {});
+	AssetManager::RegisterShaderLoadFunction([](const std::string&, const std::string&) -> ShaderBase* { return new ReplayShader(); });
+	TextureLoader::RegisterAPILoadFunction([](const std::string&) -> TextureBase* { return new ReplayTexture(); });
+}
+
+//FNV-1a over the bytes of every object's world position and orientation
+uint64_t HashWorldState(const GameWorld& world) {
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&](const void* data, size_t bytes) {
+		for (size_t i = 0; i < bytes; ++i) {
+			hash ^= ((const uint8_t*)data)[i];
+			hash *= 1099511628211ull;
+		}
+	};
+	GameObjectIterator first;
+	GameObjectIterator last;
+	world.GetObjectIterators(first, last);
+	for (auto i = first; i != last; ++i) {
+		Vector3		position	= (*i)->GetTransform().GetWorldPosition();
+		Quaternion	orientation	= (*i)->GetTransform().GetWorldOrientation();
+		add(&position, sizeof(position));
+		add(&orientation, sizeof(orientation));
+	}
+	return hash;
+}
+
+int main(int argc, char** argv) {
+	std::string recording;
+	char		mode	= 'G';
+	bool		quiet	= false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--mode" && i + 1 < argc) {
+			mode = argv[++i][0];
+		}
+		else if (arg == "--quiet") {
+			quiet = true;
+		}
+		else if (recording.empty() && arg[0] != '-') {
+			recording = arg;
+		}
+		else {
+			std::cout << "Unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+	if (recording.empty() || (mode != 'G' && mode != 'O')) {
+		std::cout << "Usage: InputReplay <recording> [--mode G|O] [--quiet]" << std::endl;
+		return 1;
+	}
+	if (!Input::StartPlayback(recording)) {
+		return 1;
+	}
+	RegisterReplayAssets();
+
+	GameSimulation* game = new GameSimulation();
+	game->InitialiseAssets();
+	game->InitialiseWorld(mode);
+
+	GameTimer	frameTimer;
+	double		totalUpdateMSec	= 0.0;
+	float		maxUpdateMSec	= 0.0f;
+
+	float dt = 0.0f;
+	while (!Input::PlaybackFinished() && Input::UpdateFrame(dt)) {
+		FrameAllocator::Get().BeginFrame();
+		Profiler::NewFrame();
+
+		frameTimer.Tick();
+		game->UpdateSimulation(dt);
+		game->UpdateRoundControls();
+		frameTimer.Tick();
+
+		float updateMSec = frameTimer.GetTimeDeltaMSec();
+		totalUpdateMSec += updateMSec;
+		maxUpdateMSec	= std::max(maxUpdateMSec, updateMSec);
+		if (!quiet) {
+			std::cout << "Frame " << Input::GetFrameNumber() << " dt " << (1000.0f * dt) << "ms update " << updateMSec << "ms" << std::endl;
+		}
+	}
+	uint32_t frames = Input::GetFrameNumber();
+	if (frames > 0) {
+		std::cout << "Replayed " << frames << " frames, update mean " << (totalUpdateMSec / frames)
+			<< "ms max " << maxUpdateMSec << "ms" << std::endl;
+	}
+	std::cout << "World state hash " << std::hex << HashWorldState(*game->GetWorld()) << std::dec << std::endl;
+
+	AssetManager::StopStreaming();
+	AssetManager::SetPlaceholders(nullptr, nullptr);
+	delete game;
+	Input::Stop();
+	return 0;
+}
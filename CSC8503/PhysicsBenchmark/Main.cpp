@@ -0,0 +1,237 @@
+#include "BenchmarkScenarios.h"
+#include "../CSC8503Common/PhysicsSystem.h"
+#include "../../Common/GameTimer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace NCL;
+using namespace CSC8503;
+
+/*
+Steps the physics scenarios with no window or renderer, and reports how long
+each step took. A step is everything TutorialGame::UpdateGame does short of
+rendering - the world update (transforms, object updates and the deferred
+object list), then the physics update and its collision events - and the
+two halves are also reported separately. Run with no arguments for every
+scenario at the defaults:
+
+	PhysicsBenchmark [scenario|all] [--count N] [--steps N] [--warmup N]
+	                 [--dt seconds] [--format csv|json] [--out file] [--level file]
+
+The results go to stdout unless --out is given, so a build script can keep
+one file per commit and compare them.
+*/
+
+struct BenchmarkSettings {
+	std::string scenario	= "all";
+	int			count		= 500;
+	int			steps		= 600;
+	int			warmup		= 60;
+	float		dt			= 1.0f / 120.0f;
+	std::string format		= "csv";
+	std::string output;
+};
+
+struct BenchmarkResult {
+	std::string name;
+	size_t		objects;
+	int			steps;
+	float		dt;
+	double		meanMSec;
+	double		worldMeanMSec;
+	double		physicsMeanMSec;
+	double		p50MSec;
+	double		p90MSec;
+	double		p99MSec;
+	double		maxMSec;
+	double		pairsPerStep;
+	double		contactsPerStep;
+	double		contactsPerSecond;
+};
+
+//Nearest rank percentile of an already sorted list
+double Percentile(const std::vector<double>& sorted, double p) {
+	if (sorted.empty()) {
+		return 0.0;
+	}
+	size_t rank = (size_t)(p * sorted.size() + 0.999999);
+	rank = std::min(std::max(rank, (size_t)1), sorted.size());
+	return sorted[rank - 1];
+}
+
+BenchmarkResult RunScenario(const BenchmarkScenarios::Scenario& scenario, const BenchmarkSettings& settings) {
+	GameWorld world;
+	PhysicsSystem physics(world);
+	physics.UseGravity(true);
+
+	scenario.build(world, settings.count);
+
+	std::vector<GameObject*>::const_iterator first;
+	std::vector<GameObject*>::const_iterator last;
+	world.GetObjectIterators(first, last);
+
+	BenchmarkResult result;
+	result.name		= scenario.name;
+	result.objects	= last - first;
+	result.steps	= settings.steps;
+	result.dt		= settings.dt;
+
+	GameTimer timer;
+	double worldMSec	= 0.0;
+	double physicsMSec	= 0.0;
+	auto step = [&]() {
+		timer.Tick();
+		world.UpdateWorld(settings.dt);
+		timer.Tick();
+		worldMSec = timer.GetTimeDeltaMSec();
+
+		physics.Update(settings.dt);
+		world.DispatchCollisionEvents(physics.GetCollisionEvents());
+		timer.Tick();
+		physicsMSec = timer.GetTimeDeltaMSec();
+	};
+
+	for (int i = 0; i < settings.warmup; ++i) {
+		step();
+	}
+
+	std::vector<double> stepMSec;
+	stepMSec.reserve(settings.steps);
+	double totalWorldMSec	= 0.0;
+	double totalPhysicsMSec	= 0.0;
+	uint64_t pairs		= 0;
+	uint64_t contacts	= 0;
+
+	for (int i = 0; i < settings.steps; ++i) {
+		step();
+
+		stepMSec.emplace_back(worldMSec + physicsMSec);
+		totalWorldMSec		+= worldMSec;
+		totalPhysicsMSec	+= physicsMSec;
+		pairs		+= physics.GetStatistics().pairsTested;
+		contacts	+= physics.GetStatistics().contacts;
+	}
+
+	double totalMSec = 0.0;
+	for (double t : stepMSec) {
+		totalMSec += t;
+	}
+	std::sort(stepMSec.begin(), stepMSec.end());
+
+	int steps = std::max(settings.steps, 1);
+	result.meanMSec				= totalMSec / steps;
+	result.worldMeanMSec		= totalWorldMSec / steps;
+	result.physicsMeanMSec		= totalPhysicsMSec / steps;
+	result.p50MSec				= Percentile(stepMSec, 0.50);
+	result.p90MSec				= Percentile(stepMSec, 0.90);
+	result.p99MSec				= Percentile(stepMSec, 0.99);
+	result.maxMSec				= stepMSec.empty() ? 0.0 : stepMSec.back();
+	result.pairsPerStep			= (double)pairs / steps;
+	result.contactsPerStep		= (double)contacts / steps;
+	result.contactsPerSecond	= totalMSec > 0.0 ? contacts / (totalMSec / 1000.0) : 0.0;
+	return result;
+}
+
+void WriteCSV(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+	out << "scenario,objects,steps,dt,mean_ms,world_mean_ms,physics_mean_ms,p50_ms,p90_ms,p99_ms,max_ms,pairs_per_step,contacts_per_step,contacts_per_sec\n";
+	for (const BenchmarkResult& r : results) {
+		out << r.name << "," << r.objects << "," << r.steps << "," << r.dt << ","
+			<< r.meanMSec << "," << r.worldMeanMSec << "," << r.physicsMeanMSec << "," << r.p50MSec << "," << r.p90MSec << "," << r.p99MSec << "," << r.maxMSec << ","
+			<< r.pairsPerStep << "," << r.contactsPerStep << "," << r.contactsPerSecond << "\n";
+	}
+}
+
+void WriteJSON(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+	out << "[\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const BenchmarkResult& r = results[i];
+		out << "\t{\"scenario\":\"" << r.name << "\",\"objects\":" << r.objects << ",\"steps\":" << r.steps << ",\"dt\":" << r.dt
+			<< ",\"mean_ms\":" << r.meanMSec << ",\"world_mean_ms\":" << r.worldMeanMSec << ",\"physics_mean_ms\":" << r.physicsMeanMSec << ",\"p50_ms\":" << r.p50MSec << ",\"p90_ms\":" << r.p90MSec
+			<< ",\"p99_ms\":" << r.p99MSec << ",\"max_ms\":" << r.maxMSec
+			<< ",\"pairs_per_step\":" << r.pairsPerStep << ",\"contacts_per_step\":" << r.contactsPerStep
+			<< ",\"contacts_per_sec\":" << r.contactsPerSecond << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "]\n";
+}
+
+bool ReadSettings(int argc, char** argv, BenchmarkSettings& settings) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg[0] != '-') {
+			settings.scenario = arg;
+		}
+		else if (arg == "--count" && hasValue) {
+			settings.count = std::stoi(argv[++i]);
+		}
+		else if (arg == "--steps" && hasValue) {
+			settings.steps = std::stoi(argv[++i]);
+		}
+		else if (arg == "--warmup" && hasValue) {
+			settings.warmup = std::stoi(argv[++i]);
+		}
+		else if (arg == "--dt" && hasValue) {
+			settings.dt = std::stof(argv[++i]);
+		}
+		else if (arg == "--format" && hasValue) {
+			settings.format = argv[++i];
+		}
+		else if (arg == "--out" && hasValue) {
+			settings.output = argv[++i];
+		}
+		else if (arg == "--level" && hasValue) {
+			BenchmarkScenarios::SetLevelFile(argv[++i]);
+		}
+		else {
+			std::cout << "Unknown option " << arg << std::endl;
+			return false;
+		}
+	}
+	if (settings.format != "csv" && settings.format != "json") {
+		std::cout << "Unknown format " << settings.format << ", expected csv or json" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+	BenchmarkSettings settings;
+	if (!ReadSettings(argc, argv, settings)) {
+		return 1;
+	}
+
+	std::vector<BenchmarkResult> results;
+	for (const BenchmarkScenarios::Scenario& s : BenchmarkScenarios::GetScenarios()) {
+		if (settings.scenario == "all" || settings.scenario == s.name) {
+			std::cerr << "Running " << s.name << "..." << std::endl;
+			results.emplace_back(RunScenario(s, settings));
+		}
+	}
+	if (results.empty()) {
+		std::cout << "No scenario called " << settings.scenario << std::endl;
+		return 1;
+	}
+
+	std::ofstream file;
+	if (!settings.output.empty()) {
+		file.open(settings.output);
+		if (!file) {
+			std::cout << "Can't open " << settings.output << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = settings.output.empty() ? std::cout : file;
+
+	if (settings.format == "json") {
+		WriteJSON(out, results);
+	}
+	else {
+		WriteCSV(out, results);
+	}
+	return 0;
+}
@@ -0,0 +1,245 @@
+#include "../../Common/RenderCommandBuffer.h"
+#include "../../Common/JobSystem.h"
+#include "../../Common/MeshGeometry.h"
+#include "../../Common/ShaderBase.h"
+#include "../../Common/GameTimer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace NCL;
+using namespace NCL::Rendering;
+
+/*
+Checks the command buffers that GameTechRenderer records its camera pass
+into, with no window or GL context. A large frame's worth of draws is
+recorded in chunks across a JobSystem, split the same way RenderCamera
+splits its batches, then replayed in order and compared draw by draw with
+what was asked for, and with one thread recording the whole frame.
+
+	RenderCommandCheck [--draws N] [--threads N]
+
+Returns 1, after saying which draw went wrong, if anything doesn't match.
+*/
+
+//Only ever compared, never drawn with
+class CheckMesh : public MeshGeometry {
+public:
+	void UploadToGPU() override {}
+};
+
+class CheckShader : public ShaderBase {
+public:
+	void ReloadShader() override {}
+};
+
+enum CheckUniform {
+	UNIFORM_FRAME,
+	UNIFORM_INDEX,
+	UNIFORM_COLOUR
+};
+
+const int	MESH_COUNT		= 7;
+const int	SHADER_COUNT	= 3;
+const int	DRAWS_PER_SHADER = 500; // Runs of draws share a shader, as sorted batches do
+
+struct CheckScene {
+	CheckMesh	meshes[MESH_COUNT];
+	CheckShader	shaders[SHADER_COUNT];
+	int			frameNumber = 8503;
+
+	const ShaderBase* ShaderFor(int draw) {
+		return &shaders[(draw / DRAWS_PER_SHADER) % SHADER_COUNT];
+	}
+};
+
+//Everything a draw would have been made with, once the commands before it had been applied
+struct ReplayedDraw {
+	const ShaderBase*	shader;
+	const MeshGeometry*	mesh;
+	int					frame;
+	int					index;
+	float				colour[4];
+	int					instanceCount;
+	int					baseInstance;
+	bool				blend;
+};
+
+struct ReplayState {
+	RenderPipeline	pipeline	= {};
+	MeshGeometry*	mesh		= nullptr;
+	int				frame		= -1;
+	int				index		= -1;
+	float			colour[4]	= {};
+};
+
+/*
+Like OGLRenderer::ExecuteCommandBuffer, the replay state carries on from one
+buffer into the next, so this is called on each chunk in turn.
+*/
+void Replay(const RenderCommandBuffer& buffer, ReplayState& state, std::vector<ReplayedDraw>& draws) {
+	for (const RenderCommand& c : buffer.GetCommands()) {
+		switch (c.type) {
+			case RenderCommandType::SetPipeline: {
+				state.pipeline = c.pipeline;
+			}break;
+			case RenderCommandType::BindMesh: {
+				state.mesh = c.mesh;
+			}break;
+			case RenderCommandType::BindTexture: {
+			}break;
+			case RenderCommandType::SetUniforms: {
+				const RenderCommandBuffer::RecordedUniform* uniforms = buffer.GetUniforms(c);
+				for (uint32_t i = 0; i < c.uniforms.count; ++i) {
+					const void* data = buffer.GetUniformData(uniforms[i]);
+					switch (uniforms[i].id) {
+						case UNIFORM_FRAME:		memcpy(&state.frame, data, sizeof(int));		break;
+						case UNIFORM_INDEX:		memcpy(&state.index, data, sizeof(int));		break;
+						case UNIFORM_COLOUR:	memcpy(state.colour, data, sizeof(float) * 4);	break;
+					}
+				}
+			}break;
+			case RenderCommandType::Draw:
+			case RenderCommandType::DrawInstanced: {
+				ReplayedDraw d;
+				d.shader		= state.pipeline.shader;
+				d.mesh			= state.mesh;
+				d.frame			= state.frame;
+				d.index			= state.index;
+				memcpy(d.colour, state.colour, sizeof(d.colour));
+				d.instanceCount = c.draw.instanceCount;
+				d.baseInstance	= c.draw.baseInstance;
+				d.blend			= state.pipeline.blend == BlendMode::Alpha;
+				draws.emplace_back(d);
+			}break;
+		}
+	}
+}
+
+/*
+Records draws [first, last) the way RecordCameraBatches does - a pipeline
+whenever the shader changes, and the per-frame uniforms the first time a
+chunk meets each shader, as a chunk can't know what the others have sent.
+*/
+void RecordDraws(CheckScene& scene, RenderCommandBuffer& buffer, int first, int last) {
+	const ShaderBase* sent[SHADER_COUNT];
+	int sentCount = 0;
+
+	for (int i = first; i < last; ++i) {
+		const ShaderBase* shader = scene.ShaderFor(i);
+		bool transparent = (i % 10) == 9;
+		if (i == first || shader != scene.ShaderFor(i - 1) || transparent != ((i - 1) % 10 == 9)) {
+			buffer.SetPipeline({ (ShaderBase*)shader, transparent ? BlendMode::Alpha : BlendMode::Opaque, CullMode::Back, true });
+		}
+		if (std::find(sent, sent + sentCount, shader) == sent + sentCount) {
+			UniformValue frameUniform = { UNIFORM_FRAME, UniformType::Int, &scene.frameNumber };
+			buffer.SetUniforms(&frameUniform, 1);
+			sent[sentCount++] = shader;
+		}
+		buffer.BindMesh(&scene.meshes[i % MESH_COUNT]);
+
+		float colour[4] = { (float)i, 0.5f, 0.25f, transparent ? 0.5f : 1.0f };
+		const UniformValue drawUniforms[] = {
+			{ UNIFORM_INDEX,	UniformType::Int,		&i },
+			{ UNIFORM_COLOUR,	UniformType::Vector4,	colour }	// A temporary, so the copy is what's checked
+		};
+		buffer.SetUniforms(drawUniforms, 2);
+		buffer.DrawInstanced(i % 5 + 1, i);
+	}
+}
+
+bool CheckDraws(CheckScene& scene, const std::vector<ReplayedDraw>& draws, int drawCount, const std::string& name) {
+	if ((int)draws.size() != drawCount) {
+		std::cout << name << ": replayed " << draws.size() << " draws, expected " << drawCount << std::endl;
+		return false;
+	}
+	for (int i = 0; i < drawCount; ++i) {
+		const ReplayedDraw& d = draws[i];
+		bool transparent = (i % 10) == 9;
+		bool matches =
+			d.shader		== scene.ShaderFor(i) &&
+			d.mesh			== &scene.meshes[i % MESH_COUNT] &&
+			d.frame			== scene.frameNumber &&
+			d.index			== i &&
+			d.colour[0]		== (float)i &&
+			d.colour[3]		== (transparent ? 0.5f : 1.0f) &&
+			d.instanceCount	== i % 5 + 1 &&
+			d.baseInstance	== i &&
+			d.blend			== transparent;
+		if (!matches) {
+			std::cout << name << ": draw " << i << " doesn't match what was recorded (index " << d.index
+				<< ", base instance " << d.baseInstance << ")" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+	int drawCount	= 10000;
+	int threads		= 0;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--draws" && i + 1 < argc) {
+			drawCount = std::stoi(argv[++i]);
+		}
+		else if (arg == "--threads" && i + 1 < argc) {
+			threads = std::stoi(argv[++i]);
+		}
+		else {
+			std::cout << "Unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+	CheckScene	scene;
+	JobSystem	jobs(threads);
+	GameTimer	timer;
+
+	//One thread, one buffer
+	RenderCommandBuffer whole;
+	timer.Tick();
+	RecordDraws(scene, whole, 0, drawCount);
+	timer.Tick();
+	float serialMSec = timer.GetTimeDeltaMSec();
+
+	//A few chunks per thread, as GameTechRenderer::RenderCamera splits them
+	size_t parts		= jobs.GetThreadCount() * 4;
+	size_t chunkSize	= std::max((size_t)1, (size_t)drawCount / parts);
+	size_t chunks		= (drawCount + chunkSize - 1) / chunkSize;
+	std::vector<RenderCommandBuffer> buffers(chunks);
+
+	timer.Tick();
+	jobs.ParallelFor(chunks, 1, [&](size_t begin, size_t end) {
+		for (size_t chunk = begin; chunk < end; ++chunk) {
+			int first	= (int)(chunk * chunkSize);
+			int last	= (int)std::min(first + chunkSize, (size_t)drawCount);
+			RecordDraws(scene, buffers[chunk], first, last);
+		}
+	});
+	timer.Tick();
+	float parallelMSec = timer.GetTimeDeltaMSec();
+
+	std::vector<ReplayedDraw> wholeDraws;
+	ReplayState wholeState;
+	Replay(whole, wholeState, wholeDraws);
+
+	std::vector<ReplayedDraw> chunkDraws;
+	ReplayState chunkState;
+	size_t chunkCommands = 0;
+	for (const RenderCommandBuffer& b : buffers) {
+		Replay(b, chunkState, chunkDraws);
+		chunkCommands += b.GetCommands().size();
+	}
+
+	bool passed = CheckDraws(scene, wholeDraws, drawCount, "single buffer") &&
+				  CheckDraws(scene, chunkDraws, drawCount, "chunked buffers");
+
+	std::cout << "Recorded " << drawCount << " draws as " << whole.GetCommands().size() << " commands in "
+		<< serialMSec << "ms on one thread, and as " << chunkCommands << " commands in " << chunks << " buffers in "
+		<< parallelMSec << "ms across " << jobs.GetThreadCount() << " threads" << std::endl;
+	std::cout << (passed ? "Passed" : "FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
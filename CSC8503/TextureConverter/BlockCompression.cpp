@@ -0,0 +1,270 @@
+#include "BlockCompression.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace NCL;
+
+namespace {
+	const int PIXELS = 16;
+
+	//BC7's 4 bit interpolation weights, out of 64
+	const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	int Clamp(int v, int low, int high) {
+		return v < low ? low : (v > high ? high : v);
+	}
+
+	/*
+	Picks the two ends of a block's line of best fit - the line through the
+	mean along the direction the pixels vary most, found by power iteration
+	on their covariance - clipped to where the pixels actually lie along it.
+	*/
+	void FitEndpoints(const uint8_t* pixels, int channels, float* low, float* high) {
+		float mean[4] = { 0 };
+		for (int i = 0; i < PIXELS; ++i) {
+			for (int c = 0; c < channels; ++c) {
+				mean[c] += pixels[i * 4 + c] / (float)PIXELS;
+			}
+		}
+		float covariance[4][4] = { 0 };
+		for (int i = 0; i < PIXELS; ++i) {
+			for (int a = 0; a < channels; ++a) {
+				for (int b = 0; b < channels; ++b) {
+					covariance[a][b] += (pixels[i * 4 + a] - mean[a]) * (pixels[i * 4 + b] - mean[b]);
+				}
+			}
+		}
+		float axis[4] = { 1, 1, 1, 1 };
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			float next[4]	= { 0 };
+			float length	= 0.0f;
+			for (int a = 0; a < channels; ++a) {
+				for (int b = 0; b < channels; ++b) {
+					next[a] += covariance[a][b] * axis[b];
+				}
+				length += next[a] * next[a];
+			}
+			if (length < 1e-6f) {
+				break; // Flat block, any direction will do
+			}
+			length = sqrtf(length);
+			for (int a = 0; a < channels; ++a) {
+				axis[a] = next[a] / length;
+			}
+		}
+		float minT = 0.0f;
+		float maxT = 0.0f;
+		for (int i = 0; i < PIXELS; ++i) {
+			float t = 0.0f;
+			for (int c = 0; c < channels; ++c) {
+				t += (pixels[i * 4 + c] - mean[c]) * axis[c];
+			}
+			minT = t < minT ? t : minT;
+			maxT = t > maxT ? t : maxT;
+		}
+		for (int c = 0; c < channels; ++c) {
+			low[c]	= fminf(fmaxf(mean[c] + axis[c] * minT, 0.0f), 255.0f);
+			high[c] = fminf(fmaxf(mean[c] + axis[c] * maxT, 0.0f), 255.0f);
+		}
+	}
+
+	int SquaredDistance(const uint8_t* pixel, const int* colour, int channels) {
+		int total = 0;
+		for (int c = 0; c < channels; ++c) {
+			int d = pixel[c] - colour[c];
+			total += d * d;
+		}
+		return total;
+	}
+
+	uint16_t To565(const float* colour) {
+		int r = (int)(colour[0] * 31.0f / 255.0f + 0.5f);
+		int g = (int)(colour[1] * 63.0f / 255.0f + 0.5f);
+		int b = (int)(colour[2] * 31.0f / 255.0f + 0.5f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	void From565(uint16_t v, int* colour) {
+		int r = (v >> 11) & 31;
+		int g = (v >> 5) & 63;
+		int b = v & 31;
+		colour[0] = (r << 3) | (r >> 2);
+		colour[1] = (g << 2) | (g >> 4);
+		colour[2] = (b << 3) | (b >> 2);
+	}
+
+	//Always in 4 colour mode, as BC3 expects its colour block to be
+	void EncodeColour(const uint8_t* pixels, uint8_t* block) {
+		float low[4];
+		float high[4];
+		FitEndpoints(pixels, 3, low, high);
+
+		uint16_t c0 = To565(high);
+		uint16_t c1 = To565(low);
+		if (c0 < c1) {
+			uint16_t t = c0; c0 = c1; c1 = t;
+		}
+		uint32_t indices = 0;
+		if (c0 != c1) {
+			int palette[4][3];
+			From565(c0, palette[0]);
+			From565(c1, palette[1]);
+			for (int c = 0; c < 3; ++c) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			for (int i = 0; i < PIXELS; ++i) {
+				int best		= 0;
+				int bestError	= SquaredDistance(&pixels[i * 4], palette[0], 3);
+				for (int p = 1; p < 4; ++p) {
+					int error = SquaredDistance(&pixels[i * 4], palette[p], 3);
+					if (error < bestError) {
+						best		= p;
+						bestError	= error;
+					}
+				}
+				indices |= best << (i * 2);
+			}
+		}
+		block[0] = c0 & 0xFF;
+		block[1] = c0 >> 8;
+		block[2] = c1 & 0xFF;
+		block[3] = c1 >> 8;
+		for (int i = 0; i < 4; ++i) {
+			block[4 + i] = (indices >> (i * 8)) & 0xFF;
+		}
+	}
+
+	//8 alpha mode, with the block's extremes as its end points
+	void EncodeAlpha(const uint8_t* pixels, uint8_t* block) {
+		int a0 = 0;
+		int a1 = 255;
+		for (int i = 0; i < PIXELS; ++i) {
+			a0 = pixels[i * 4 + 3] > a0 ? pixels[i * 4 + 3] : a0;
+			a1 = pixels[i * 4 + 3] < a1 ? pixels[i * 4 + 3] : a1;
+		}
+		uint64_t indices = 0;
+		if (a0 != a1) {
+			int palette[8] = { a0, a1 };
+			for (int p = 2; p < 8; ++p) {
+				palette[p] = ((8 - p) * a0 + (p - 1) * a1) / 7;
+			}
+			for (int i = 0; i < PIXELS; ++i) {
+				int best		= 0;
+				int bestError	= 256;
+				for (int p = 0; p < 8; ++p) {
+					int error = std::abs(pixels[i * 4 + 3] - palette[p]);
+					if (error < bestError) {
+						best		= p;
+						bestError	= error;
+					}
+				}
+				indices |= (uint64_t)best << (i * 3);
+			}
+		}
+		block[0] = (uint8_t)a0;
+		block[1] = (uint8_t)a1;
+		for (int i = 0; i < 6; ++i) {
+			block[2 + i] = (indices >> (i * 8)) & 0xFF;
+		}
+	}
+
+	struct BitWriter {
+		uint8_t*	out;
+		int			bit;
+
+		void Write(uint32_t value, int bits) {
+			for (int i = 0; i < bits; ++i, ++bit) {
+				if ((value >> i) & 1) {
+					out[bit >> 3] |= 1 << (bit & 7);
+				}
+			}
+		}
+	};
+
+	/*
+	Mode 6 end points are 7 bits per channel plus a shared lowest bit (the
+	p-bit), so both choices of p-bit are tried and the closer one kept.
+	*/
+	void QuantiseBC7(const float* endpoint, int* quantised, int& pBit) {
+		int bestError = -1;
+		for (int p = 0; p < 2; ++p) {
+			int q[4];
+			int error = 0;
+			for (int c = 0; c < 4; ++c) {
+				q[c] = Clamp((int)((endpoint[c] - p) / 2.0f + 0.5f), 0, 127);
+				int d = ((q[c] << 1) | p) - (int)(endpoint[c] + 0.5f);
+				error += d * d;
+			}
+			if (bestError < 0 || error < bestError) {
+				bestError = error;
+				pBit = p;
+				memcpy(quantised, q, sizeof(q));
+			}
+		}
+	}
+}
+
+void BlockCompression::EncodeBC1(const uint8_t* pixels, uint8_t* block) {
+	EncodeColour(pixels, block);
+}
+
+void BlockCompression::EncodeBC3(const uint8_t* pixels, uint8_t* block) {
+	EncodeAlpha(pixels, block);
+	EncodeColour(pixels, block + 8);
+}
+
+void BlockCompression::EncodeBC7(const uint8_t* pixels, uint8_t* block) {
+	float low[4];
+	float high[4];
+	FitEndpoints(pixels, 4, low, high);
+
+	int q[2][4];
+	int p[2];
+	QuantiseBC7(low,  q[0], p[0]);
+	QuantiseBC7(high, q[1], p[1]);
+
+	int palette[16][4];
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < 4; ++c) {
+			int e0 = (q[0][c] << 1) | p[0];
+			int e1 = (q[1][c] << 1) | p[1];
+			palette[i][c] = ((64 - BC7_WEIGHTS[i]) * e0 + BC7_WEIGHTS[i] * e1 + 32) >> 6;
+		}
+	}
+	int indices[PIXELS];
+	for (int i = 0; i < PIXELS; ++i) {
+		int bestError = -1;
+		for (int w = 0; w < 16; ++w) {
+			int error = SquaredDistance(&pixels[i * 4], palette[w], 4);
+			if (bestError < 0 || error < bestError) {
+				bestError	= error;
+				indices[i]	= w;
+			}
+		}
+	}
+	//The first pixel's index only gets 3 bits, so its top bit has to be 0
+	if (indices[0] & 8) {
+		for (int c = 0; c < 4; ++c) {
+			int t = q[0][c]; q[0][c] = q[1][c]; q[1][c] = t;
+		}
+		int t = p[0]; p[0] = p[1]; p[1] = t;
+		for (int i = 0; i < PIXELS; ++i) {
+			indices[i] = 15 - indices[i];
+		}
+	}
+	memset(block, 0, 16);
+	BitWriter writer = { block, 0 };
+	writer.Write(1 << 6, 7);
+	for (int c = 0; c < 4; ++c) {
+		writer.Write(q[0][c], 7);
+		writer.Write(q[1][c], 7);
+	}
+	writer.Write(p[0], 1);
+	writer.Write(p[1], 1);
+	for (int i = 0; i < PIXELS; ++i) {
+		writer.Write(indices[i], i == 0 ? 3 : 4);
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace NCL {
+	/*
+	CPU encoders for a single 4x4 block of RGBA8 pixels, given row by row.
+	They're built for the TextureConverter, so they go for reasonable
+	quality in a simple, predictable amount of time rather than trying
+	every possible encoding.
+	*/
+	namespace BlockCompression {
+		//8 bytes out - alpha is ignored
+		void EncodeBC1(const uint8_t* pixels, uint8_t* block);
+
+		//16 bytes out - a BC4 style alpha block, then a BC1 colour block
+		void EncodeBC3(const uint8_t* pixels, uint8_t* block);
+
+		//16 bytes out - always mode 6, a single RGBA line with 16 steps
+		void EncodeBC7(const uint8_t* pixels, uint8_t* block);
+	}
+}
@@ -0,0 +1,242 @@
+#include "BlockCompression.h"
+
+#include "../../Common/TextureContainer.h"
+#include "../../Common/TextureLoader.h"
+#include "../../Common/Assets.h"
+#include "../../Common/GameTimer.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace NCL;
+
+/*
+Converts images into .ntex texture containers, with every mip level
+generated and block compressed ahead of time:
+
+	TextureConverter [--format bc1|bc3|bc7] [--linear] [--out directory] image.png [image.png ...]
+
+Images are read from Assets/Textures, and by default the containers are
+written next to them, where TextureContainer picks them up in place of
+the originals. Colour images become BC1 if they're opaque, and BC3 if
+not, unless a format is given; one and two channel images are only given
+their mip levels, as block compressing them would blur them badly.
+Colour is assumed to be sRGB, unless --linear is given for things like
+normal maps.
+*/
+
+struct Image {
+	int					width;
+	int					height;
+	std::vector<uint8_t> pixels;
+};
+
+float ToLinear(uint8_t v) {
+	float f = v / 255.0f;
+	return f <= 0.04045f ? f / 12.92f : powf((f + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t FromLinear(float f) {
+	f = f <= 0.0031308f ? f * 12.92f : 1.055f * powf(f, 1.0f / 2.4f) - 0.055f;
+	return (uint8_t)fminf(fmaxf(f * 255.0f + 0.5f, 0.0f), 255.0f);
+}
+
+/*
+A 2x2 box filter. sRGB colour has to be averaged as linear light, or each
+level comes out darker than the last.
+*/
+Image Downsample(const Image& from, int channels, bool sRGB) {
+	Image to;
+	to.width	= from.width  > 1 ? from.width  / 2 : 1;
+	to.height	= from.height > 1 ? from.height / 2 : 1;
+	to.pixels.resize((size_t)to.width * to.height * channels);
+
+	for (int y = 0; y < to.height; ++y) {
+		for (int x = 0; x < to.width; ++x) {
+			int x0 = x * 2;
+			int y0 = y * 2;
+			int x1 = x0 + 1 < from.width  ? x0 + 1 : x0;
+			int y1 = y0 + 1 < from.height ? y0 + 1 : y0;
+			const uint8_t* samples[4] = {
+				&from.pixels[((size_t)y0 * from.width + x0) * channels],
+				&from.pixels[((size_t)y0 * from.width + x1) * channels],
+				&from.pixels[((size_t)y1 * from.width + x0) * channels],
+				&from.pixels[((size_t)y1 * from.width + x1) * channels]
+			};
+			uint8_t* out = &to.pixels[((size_t)y * to.width + x) * channels];
+			for (int c = 0; c < channels; ++c) {
+				bool	colour	= sRGB && c < 3;
+				float	total	= 0.0f;
+				for (int s = 0; s < 4; ++s) {
+					total += colour ? ToLinear(samples[s][c]) : samples[s][c];
+				}
+				out[c] = colour ? FromLinear(total / 4.0f) : (uint8_t)(total / 4.0f + 0.5f);
+			}
+		}
+	}
+	return to;
+}
+
+//Edge pixels are repeated to fill blocks that hang off the side of the image
+std::vector<uint8_t> Compress(const Image& image, TextureFormat format) {
+	int blocksWide = (image.width + 3) / 4;
+	int blocksHigh = (image.height + 3) / 4;
+
+	std::vector<uint8_t> out(TextureContainer::GetLevelSize(format, image.width, image.height));
+	size_t blockSize = format == TextureFormat::BC1 ? 8 : 16;
+
+	for (int by = 0; by < blocksHigh; ++by) {
+		for (int bx = 0; bx < blocksWide; ++bx) {
+			uint8_t block[16 * 4];
+			for (int y = 0; y < 4; ++y) {
+				for (int x = 0; x < 4; ++x) {
+					int sx = bx * 4 + x < image.width  ? bx * 4 + x : image.width  - 1;
+					int sy = by * 4 + y < image.height ? by * 4 + y : image.height - 1;
+					memcpy(&block[(y * 4 + x) * 4], &image.pixels[((size_t)sy * image.width + sx) * 4], 4);
+				}
+			}
+			uint8_t* to = &out[((size_t)by * blocksWide + bx) * blockSize];
+			switch (format) {
+				case TextureFormat::BC1: BlockCompression::EncodeBC1(block, to); break;
+				case TextureFormat::BC3: BlockCompression::EncodeBC3(block, to); break;
+				case TextureFormat::BC7: BlockCompression::EncodeBC7(block, to); break;
+				default: break;
+			}
+		}
+	}
+	return out;
+}
+
+std::string ContainerName(const std::string& filename) {
+	size_t dot = filename.find_last_of('.');
+	return (dot == std::string::npos ? filename : filename.substr(0, dot)) + ".ntex";
+}
+
+bool Convert(const std::string& name, const std::string& outputDir, const std::string& formatName, bool linear) {
+	char*	data		= nullptr;
+	int		width		= 0;
+	int		height		= 0;
+	int		channels	= 0;
+	int		flags		= 0;
+	if (!TextureLoader::LoadTexture(name, data, width, height, channels, flags) || channels < 1 || channels > 4) {
+		std::cout << name << " couldn't be loaded!" << std::endl;
+		free(data);
+		return false;
+	}
+	//Colour images are always worked on as RGBA
+	int		workChannels	= channels >= 3 ? 4 : channels;
+	bool	sRGB			= channels >= 3 && !linear;
+	bool	opaque			= true;
+
+	Image top;
+	top.width	= width;
+	top.height	= height;
+	top.pixels.resize((size_t)width * height * workChannels);
+	for (size_t i = 0; i < (size_t)width * height; ++i) {
+		for (int c = 0; c < workChannels; ++c) {
+			top.pixels[i * workChannels + c] = c < channels ? data[i * channels + c] : 255;
+		}
+		opaque &= workChannels < 4 || top.pixels[i * 4 + 3] == 255;
+	}
+	free(data);
+
+	TextureFormat format = TextureContainer::FormatFromChannels(workChannels);
+	if (workChannels == 4) {
+		format = opaque ? TextureFormat::BC1 : TextureFormat::BC3;
+		if (formatName == "bc1") { format = TextureFormat::BC1; }
+		if (formatName == "bc3") { format = TextureFormat::BC3; }
+		if (formatName == "bc7") { format = TextureFormat::BC7; }
+	}
+
+	std::vector<Image> mips = { top };
+	while ((mips.back().width > 1 || mips.back().height > 1) && mips.size() < TextureContainer::MAX_LEVELS) {
+		mips.emplace_back(Downsample(mips.back(), workChannels, sRGB));
+	}
+	std::vector<std::vector<uint8_t>>	compressed(mips.size());
+	std::vector<TextureContainer::Level> levels(mips.size());
+	for (size_t i = 0; i < mips.size(); ++i) {
+		if (TextureContainer::IsCompressed(format)) {
+			compressed[i] = Compress(mips[i], format);
+		}
+		else {
+			compressed[i] = mips[i].pixels;
+		}
+		levels[i] = { mips[i].width, mips[i].height, (const char*)compressed[i].data(), compressed[i].size() };
+	}
+	TextureContainer container;
+	container.SetLevels(format, sRGB, levels.data(), (int)levels.size());
+	if (!container.SaveFile(outputDir + ContainerName(name))) {
+		return false;
+	}
+	//What the renderer used to upload, before it had sized formats: RGBA32F plus generated mips
+	size_t oldBytes = 0;
+	size_t newBytes = 0;
+	for (size_t i = 0; i < mips.size(); ++i) {
+		oldBytes += (size_t)mips[i].width * mips[i].height * 16;
+		newBytes += levels[i].size;
+	}
+	std::cout << name << ": " << width << "x" << height << ", " << mips.size() << " levels, "
+		<< oldBytes / 1024 << "KB as RGBA32F, " << newBytes / 1024 << "KB as converted" << std::endl;
+	return true;
+}
+
+int main(int argc, char** argv) {
+	std::string					outputDir = Assets::TEXTUREDIR;
+	std::string					formatName;
+	bool						linear = false;
+	std::vector<std::string>	images;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--out" && i + 1 < argc) {
+			outputDir = argv[++i];
+			if (!outputDir.empty() && outputDir.back() != '/' && outputDir.back() != '\\') {
+				outputDir += "/";
+			}
+		}
+		else if (arg == "--format" && i + 1 < argc) {
+			formatName = argv[++i];
+		}
+		else if (arg == "--linear") {
+			linear = true;
+		}
+		else {
+			images.emplace_back(arg);
+		}
+	}
+	if (images.empty() || !(formatName.empty() || formatName == "bc1" || formatName == "bc3" || formatName == "bc7")) {
+		std::cout << "Usage: TextureConverter [--format bc1|bc3|bc7] [--linear] [--out directory] image.png [image.png ...]" << std::endl;
+		return 1;
+	}
+
+	GameTimer	timer;
+	int			failures = 0;
+	for (const std::string& name : images) {
+		if (!Convert(name, outputDir, formatName, linear)) {
+			std::cout << name << " couldn't be converted!" << std::endl;
+			failures++;
+			continue;
+		}
+		if (outputDir != Assets::TEXTUREDIR) {
+			continue;
+		}
+		char*	data = nullptr;
+		int		width, height, channels, flags;
+		timer.Tick();
+		TextureLoader::LoadTexture(name, data, width, height, channels, flags);
+		timer.Tick();
+		float decodeMSec = timer.GetTimeDeltaMSec();
+		free(data);
+
+		TextureContainer container;
+		timer.Tick();
+		container.LoadFile(name);
+		timer.Tick();
+		std::cout << "  image decode " << decodeMSec << "ms, container load " << timer.GetTimeDeltaMSec() << "ms" << std::endl;
+	}
+	return failures == 0 ? 0 : 1;
+}
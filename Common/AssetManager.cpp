@@ -0,0 +1,354 @@
+#include "AssetManager.h"
+#include "TextureLoader.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace NCL;
+using namespace Rendering;
+
+std::map<std::string, AssetManager::Entry<MeshGeometry>>	AssetManager::meshes;
+std::map<std::string, AssetManager::Entry<TextureBase>>		AssetManager::textures;
+std::map<std::string, AssetManager::Entry<ShaderBase>>		AssetManager::shaders;
+
+MeshCreateFunction		AssetManager::meshFunction			= nullptr;
+TextureCreateFunction	AssetManager::textureCreateFunction	= nullptr;
+TextureUploadFunction	AssetManager::textureUploadFunction	= nullptr;
+ShaderLoadFunction		AssetManager::shaderFunction		= nullptr;
+
+MeshGeometry*	AssetManager::placeholderMesh		= nullptr;
+TextureBase*	AssetManager::placeholderTexture	= nullptr;
+
+std::vector<AssetManager::StreamRequest*>	AssetManager::streaming;
+std::deque<AssetManager::StreamRequest*>	AssetManager::readQueue;
+std::mutex									AssetManager::streamMutex;
+std::condition_variable						AssetManager::readCondition;
+std::condition_variable						AssetManager::finishedCondition;
+std::thread									AssetManager::streamThread;
+bool										AssetManager::stopStreaming = false;
+
+template<typename T, typename Loader>
+T* AssetManager::Acquire(std::map<std::string, Entry<T>>& assets, const std::string& key, Loader load) {
+	auto i = assets.find(key);
+	if (i != assets.end()) {
+		i->second.references++;
+		return i->second.asset;
+	}
+	T* asset = load();
+	if (!asset) {
+		return nullptr; // Nothing is cached, so it'll be tried again next time
+	}
+	assets.insert(std::make_pair(key, Entry<T>{ asset, 1 }));
+	return asset;
+}
+
+/*
+Linear in the number of unique assets, but releases only happen on unload.
+Anything still streaming can't be deleted until the background thread is
+done with it, so it's left for UpdateStreaming to clear up.
+*/
+template<typename T>
+void AssetManager::Release(std::map<std::string, Entry<T>>& assets, T* asset) {
+	if (!asset) {
+		return;
+	}
+	for (auto i = assets.begin(); i != assets.end(); ++i) {
+		if (i->second.asset != asset) {
+			continue;
+		}
+		if (--i->second.references == 0) {
+			auto request = FindRequest(asset);
+			if (request != streaming.end()) {
+				(*request)->released = true;
+			}
+			else {
+				delete i->second.asset;
+			}
+			assets.erase(i);
+		}
+		return;
+	}
+	std::cout << __FUNCTION__ << " asset wasn't acquired through the AssetManager!" << std::endl;
+}
+
+MeshGeometry* AssetManager::AcquireMesh(const std::string& filename, AssetLoad load) {
+	if (!meshFunction) {
+		std::cout << __FUNCTION__ << " no mesh create function has been defined!" << std::endl;
+		return nullptr;
+	}
+	MeshGeometry* mesh = Acquire(meshes, filename, [&]() { return LoadMesh(filename, load); });
+
+	if (mesh && !mesh->IsReady() && load == AssetLoad::Immediate) {
+		auto request = FindRequest(mesh);
+		if (request != streaming.end()) {
+			WaitForRequest(*request); // Someone else started streaming it, but it's wanted now
+			FinishRequest(*request);
+			streaming.erase(request);
+		}
+	}
+	return mesh;
+}
+
+TextureBase* AssetManager::AcquireTexture(const std::string& filename, AssetLoad load) {
+	TextureBase* texture = Acquire(textures, filename, [&]() { return LoadTexture(filename, load); });
+
+	if (texture && !texture->IsReady() && load == AssetLoad::Immediate) {
+		auto request = FindRequest(texture);
+		if (request != streaming.end()) {
+			WaitForRequest(*request);
+			FinishRequest(*request);
+			streaming.erase(request);
+		}
+	}
+	return texture;
+}
+
+ShaderBase* AssetManager::AcquireShader(const std::string& vertex, const std::string& fragment) {
+	if (!shaderFunction) {
+		std::cout << __FUNCTION__ << " no shader load function has been defined!" << std::endl;
+		return nullptr;
+	}
+	return Acquire(shaders, vertex + "|" + fragment, [&]() { return shaderFunction(vertex, fragment); });
+}
+
+MeshGeometry* AssetManager::LoadMesh(const std::string& filename, AssetLoad load) {
+	MeshGeometry* mesh = meshFunction();
+	if (load == AssetLoad::Streamed) {
+		mesh->ready = false;
+		Stream(new StreamRequest(filename, mesh, nullptr));
+		return mesh;
+	}
+	if (!mesh->LoadFile(filename)) {
+		std::cout << __FUNCTION__ << " can't load " << filename << std::endl;
+		delete mesh;
+		return nullptr;
+	}
+	mesh->UploadToGPU();
+	mesh->ReleaseCPUData(); // Shared meshes are only ever drawn
+	return mesh;
+}
+
+TextureBase* AssetManager::LoadTexture(const std::string& filename, AssetLoad load) {
+	if (load == AssetLoad::Immediate) {
+		return TextureLoader::LoadAPITexture(filename);
+	}
+	if (!textureCreateFunction || !textureUploadFunction) {
+		std::cout << __FUNCTION__ << " no texture functions have been defined!" << std::endl;
+		return nullptr;
+	}
+	TextureBase* texture = textureCreateFunction();
+	texture->ready = false;
+	Stream(new StreamRequest(filename, nullptr, texture));
+	return texture;
+}
+
+void AssetManager::Release(MeshGeometry* mesh) {
+	Release(meshes, mesh);
+}
+
+void AssetManager::Release(TextureBase* texture) {
+	Release(textures, texture);
+}
+
+void AssetManager::Release(ShaderBase* shader) {
+	Release(shaders, shader);
+}
+
+void AssetManager::RegisterMeshCreateFunction(MeshCreateFunction f) {
+	meshFunction = f;
+}
+
+void AssetManager::RegisterTextureFunctions(TextureCreateFunction create, TextureUploadFunction upload) {
+	textureCreateFunction = create;
+	textureUploadFunction = upload;
+}
+
+void AssetManager::RegisterShaderLoadFunction(ShaderLoadFunction f) {
+	shaderFunction = f;
+}
+
+size_t AssetManager::GetLoadedCount() {
+	return meshes.size() + textures.size() + shaders.size();
+}
+
+/*
+The thread is only started the first time something is streamed, so
+programs that load everything immediately never have one.
+*/
+void AssetManager::Stream(StreamRequest* request) {
+	streaming.emplace_back(request);
+
+	std::lock_guard<std::mutex> lock(streamMutex);
+	readQueue.emplace_back(request);
+	if (!streamThread.joinable()) {
+		stopStreaming	= false;
+		streamThread	= std::thread(StreamThread);
+	}
+	readCondition.notify_one();
+}
+
+void AssetManager::StreamThread() {
+	while (true) {
+		StreamRequest* request = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(streamMutex);
+			readCondition.wait(lock, []() { return stopStreaming || !readQueue.empty(); });
+			if (stopStreaming) {
+				return;
+			}
+			request = readQueue.front();
+			readQueue.pop_front();
+		}
+		ReadRequest(request);
+		{
+			std::lock_guard<std::mutex> lock(streamMutex);
+			request->finished = true;
+		}
+		finishedCondition.notify_all();
+	}
+}
+
+//All the file reading and decoding, none of which needs the render thread
+void AssetManager::ReadRequest(StreamRequest* request) {
+	if (request->mesh) {
+		request->loaded = request->mesh->LoadFile(request->filename);
+	}
+	else {
+		request->image	= new TextureContainer();
+		request->loaded = request->image->LoadFile(request->filename);
+	}
+}
+
+/*
+If the background thread hasn't got to the request yet it's just done
+here instead, rather than waiting for everything queued in front of it.
+*/
+void AssetManager::WaitForRequest(StreamRequest* request) {
+	std::unique_lock<std::mutex> lock(streamMutex);
+	for (auto i = readQueue.begin(); i != readQueue.end(); ++i) {
+		if (*i == request) {
+			readQueue.erase(i);
+			lock.unlock();
+			ReadRequest(request);
+			request->finished = true;
+			return;
+		}
+	}
+	finishedCondition.wait(lock, [&]() { return request->finished.load(); });
+}
+
+//Render thread only - uploads a finished request, and deletes it
+void AssetManager::FinishRequest(StreamRequest* request) {
+	if (request->released) {
+		delete request->mesh;
+		delete request->texture;
+	}
+	else if (!request->loaded) {
+		std::cout << __FUNCTION__ << " can't load " << request->filename << std::endl;
+	}
+	else if (request->mesh) {
+		request->mesh->UploadToGPU();
+		request->mesh->ReleaseCPUData();
+		request->mesh->ready = true;
+	}
+	else {
+		textureUploadFunction(request->texture, *request->image);
+		request->texture->ready = true;
+	}
+	delete request->image;
+	delete request;
+}
+
+void AssetManager::UpdateStreaming(float budgetMSec) {
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (auto i = streaming.begin(); i != streaming.end(); ) {
+		if (!(*i)->finished) {
+			++i;
+			continue;
+		}
+		FinishRequest(*i);
+		i = streaming.erase(i);
+
+		std::chrono::duration<float, std::milli> spent = std::chrono::high_resolution_clock::now() - start;
+		if (spent.count() >= budgetMSec) {
+			break;
+		}
+	}
+}
+
+void AssetManager::StopStreaming() {
+	{
+		std::lock_guard<std::mutex> lock(streamMutex);
+		stopStreaming = true;
+		readQueue.clear();
+	}
+	readCondition.notify_all();
+	if (streamThread.joinable()) {
+		streamThread.join();
+	}
+	for (StreamRequest* r : streaming) {
+		if (r->released) {
+			delete r->mesh;
+			delete r->texture;
+		}
+		delete r->image;
+		delete r;
+	}
+	streaming.clear();
+}
+
+std::vector<AssetManager::StreamRequest*>::iterator AssetManager::FindRequest(const void* asset) {
+	for (auto i = streaming.begin(); i != streaming.end(); ++i) {
+		if ((*i)->mesh == asset || (*i)->texture == asset) {
+			return i;
+		}
+	}
+	return streaming.end();
+}
+
+void AssetManager::SetPlaceholders(MeshGeometry* mesh, TextureBase* texture) {
+	placeholderMesh		= mesh;
+	placeholderTexture	= texture;
+}
+
+MeshGeometry* AssetManager::DrawableMesh(MeshGeometry* mesh) {
+	return (!mesh || mesh->IsReady()) ? mesh : placeholderMesh;
+}
+
+TextureBase* AssetManager::DrawableTexture(TextureBase* texture) {
+	return (!texture || texture->IsReady()) ? texture : placeholderTexture;
+}
+
+MeshGeometry* AssetScope::Mesh(const std::string& filename, AssetLoad load) {
+	MeshGeometry* mesh = AssetManager::AcquireMesh(filename, load);
+	if (mesh) {
+		meshes.emplace_back(mesh);
+	}
+	return mesh;
+}
+
+TextureBase* AssetScope::Texture(const std::string& filename, AssetLoad load) {
+	TextureBase* texture = AssetManager::AcquireTexture(filename, load);
+	if (texture) {
+		textures.emplace_back(texture);
+	}
+	return texture;
+}
+
+ShaderBase* AssetScope::Shader(const std::string& vertex, const std::string& fragment) {
+	ShaderBase* shader = AssetManager::AcquireShader(vertex, fragment);
+	if (shader) {
+		shaders.emplace_back(shader);
+	}
+	return shader;
+}
+
+void AssetScope::ReleaseAll() {
+	for (MeshGeometry* m : meshes)		{ AssetManager::Release(m); }
+	for (TextureBase* t : textures)		{ AssetManager::Release(t); }
+	for (ShaderBase* s : shaders)		{ AssetManager::Release(s); }
+	meshes.clear();
+	textures.clear();
+	shaders.clear();
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MeshGeometry.h"
+#include "TextureBase.h"
+#include "ShaderBase.h"
+#include "TextureContainer.h"
+
+namespace NCL {
+	//Makes an empty mesh of the renderer's type, which the AssetManager then fills and uploads
+	typedef std::function<MeshGeometry*()> MeshCreateFunction;
+
+	//Makes an empty texture, and fills one in from a loaded image - both on the render thread
+	typedef std::function<Rendering::TextureBase*()> TextureCreateFunction;
+	typedef std::function<void(Rendering::TextureBase* texture, const TextureContainer& image)> TextureUploadFunction;
+
+	typedef std::function<Rendering::ShaderBase*(const std::string& vertex, const std::string& fragment)> ShaderLoadFunction;
+
+	enum class AssetLoad {
+		Immediate,	// Loaded and uploaded before Acquire returns
+		Streamed	// Acquire returns straight away, and the asset becomes ready later
+	};
+
+	/*
+	Keeps one copy of each mesh, texture and shader, keyed by the files they
+	came from. Acquiring something that's already loaded just hands back the
+	same object and bumps its reference count; releasing the last reference
+	deletes it. Like TextureLoader, the renderer registers how to actually
+	make each kind of asset, so Common doesn't need to know about any API.
+
+	Meshes and textures can also be streamed. The object is made and handed
+	back immediately, but stays not-ready while a background thread reads
+	and decodes its file; the render thread then uploads finished assets a
+	few at a time from UpdateStreaming, within a time budget, so loading a
+	level never stalls a frame. Until then the renderer should draw whatever
+	DrawableMesh / DrawableTexture give it instead. Shaders are small, and
+	have to be compiled on the render thread anyway, so they're always
+	loaded immediately.
+
+	Everything here other than the background thread itself should only be
+	called from the render thread.
+
+	Most code should go through an AssetScope rather than calling Acquire and
+	Release itself.
+	*/
+	class AssetManager {
+	public:
+		static MeshGeometry*			AcquireMesh(const std::string& filename, AssetLoad load = AssetLoad::Immediate);
+		static Rendering::TextureBase*	AcquireTexture(const std::string& filename, AssetLoad load = AssetLoad::Immediate);
+		static Rendering::ShaderBase*	AcquireShader(const std::string& vertex, const std::string& fragment);
+
+		static void Release(MeshGeometry* mesh);
+		static void Release(Rendering::TextureBase* texture);
+		static void Release(Rendering::ShaderBase* shader);
+
+		static void RegisterMeshCreateFunction(MeshCreateFunction f);
+		static void RegisterTextureFunctions(TextureCreateFunction create, TextureUploadFunction upload);
+		static void RegisterShaderLoadFunction(ShaderLoadFunction f);
+
+		/*
+		Uploads streamed assets that have finished loading, stopping once
+		budgetMSec has been spent - though always uploading at least one, so
+		that a single large asset can't hold everything up forever.
+		*/
+		static void UpdateStreaming(float budgetMSec);
+
+		//Stops the background thread; anything still streaming is left not-ready
+		static void StopStreaming();
+
+		//Drawn in place of meshes and textures that aren't ready yet
+		static void SetPlaceholders(MeshGeometry* mesh, Rendering::TextureBase* texture);
+
+		//What to actually draw for an asset - nullptr if it isn't ready and there's no placeholder
+		static MeshGeometry*			DrawableMesh(MeshGeometry* mesh);
+		static Rendering::TextureBase*	DrawableTexture(Rendering::TextureBase* texture);
+
+		//How many unique assets are loaded right now, of every kind
+		static size_t GetLoadedCount();
+		//How many of them are still being streamed in
+		static size_t GetStreamingCount() { return streaming.size(); }
+
+	protected:
+		template<typename T>
+		struct Entry {
+			T*		asset;
+			int		references;
+		};
+
+		/*
+		One streamed asset. Only loaded and image are written by the background
+		thread, and only before it sets finished.
+		*/
+		struct StreamRequest {
+			StreamRequest(const std::string& filename, MeshGeometry* mesh, Rendering::TextureBase* texture) :
+				filename(filename), mesh(mesh), texture(texture), image(nullptr),
+				loaded(false), finished(false), released(false) {}
+
+			std::string				filename;
+			MeshGeometry*			mesh;
+			Rendering::TextureBase*	texture;
+			TextureContainer*		image;
+
+			bool				loaded;
+			std::atomic<bool>	finished;
+			bool				released;	// Its last reference went while it was still streaming
+		};
+
+		template<typename T, typename Loader>
+		static T* Acquire(std::map<std::string, Entry<T>>& assets, const std::string& key, Loader load);
+
+		template<typename T>
+		static void Release(std::map<std::string, Entry<T>>& assets, T* asset);
+
+		static MeshGeometry*			LoadMesh(const std::string& filename, AssetLoad load);
+		static Rendering::TextureBase*	LoadTexture(const std::string& filename, AssetLoad load);
+
+		static void Stream(StreamRequest* request);
+		static void ReadRequest(StreamRequest* request);
+		static void FinishRequest(StreamRequest* request);
+		static void WaitForRequest(StreamRequest* request);
+		static std::vector<StreamRequest*>::iterator FindRequest(const void* asset);
+		static void StreamThread();
+
+		static std::map<std::string, Entry<MeshGeometry>>				meshes;
+		static std::map<std::string, Entry<Rendering::TextureBase>>	textures;
+		static std::map<std::string, Entry<Rendering::ShaderBase>>		shaders;
+
+		static MeshCreateFunction		meshFunction;
+		static TextureCreateFunction	textureCreateFunction;
+		static TextureUploadFunction	textureUploadFunction;
+		static ShaderLoadFunction		shaderFunction;
+
+		static MeshGeometry*			placeholderMesh;
+		static Rendering::TextureBase*	placeholderTexture;
+
+		//Everything currently streaming, oldest first - only touched by the render thread
+		static std::vector<StreamRequest*>	streaming;
+
+		//Requests the background thread hasn't picked up yet
+		static std::deque<StreamRequest*>	readQueue;
+		static std::mutex					streamMutex;
+		static std::condition_variable		readCondition;
+		static std::condition_variable		finishedCondition;
+		static std::thread					streamThread;
+		static bool							stopStreaming;
+	};
+
+	/*
+	Everything acquired through a scope is released together, when the scope
+	is destroyed or ReleaseAll is called - so an object that holds one as a
+	member gives its assets back when it goes, however many other objects are
+	still sharing them.
+	*/
+	class AssetScope {
+	public:
+		AssetScope() {}
+		~AssetScope() { ReleaseAll(); }
+
+		AssetScope(const AssetScope&) = delete;
+		AssetScope& operator=(const AssetScope&) = delete;
+
+		MeshGeometry*			Mesh(const std::string& filename, AssetLoad load = AssetLoad::Immediate);
+		Rendering::TextureBase*	Texture(const std::string& filename, AssetLoad load = AssetLoad::Immediate);
+		Rendering::ShaderBase*	Shader(const std::string& vertex, const std::string& fragment);
+
+		void ReleaseAll();
+
+	protected:
+		std::vector<MeshGeometry*>				meshes;
+		std::vector<Rendering::TextureBase*>	textures;
+		std::vector<Rendering::ShaderBase*>		shaders;
+	};
+}
@@ -1,5 +1,7 @@
 #include "Camera.h"
 #include "Window.h"
+#include "Input.h"
+#include "Vector4.h"
 #include <algorithm>
 
 using namespace NCL;
@@ -10,9 +12,13 @@ Should be done once per frame! Pass it the msec since
 last frame (default value is for simplicities sake...)
 */
 void Camera::UpdateCamera(float dt) {
+	Vector3 oldPosition = position;
+	float	oldPitch	= pitch;
+	float	oldYaw		= yaw;
+
 	//Update the mouse by how much
-	pitch	-= (Window::GetMouse()->GetRelativePosition().y);
-	yaw		-= (Window::GetMouse()->GetRelativePosition().x);
+	pitch	-= (Input::GetMouse()->GetRelativePosition().y);
+	yaw		-= (Input::GetMouse()->GetRelativePosition().x);
 
 	//Bounds check the pitch, to be between straight up and straight down ;)
 	pitch = std::min(pitch, 90.0f);
@@ -27,32 +33,36 @@ void Camera::UpdateCamera(float dt) {
 
 	float frameSpeed = speed * dt;
 
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::PLUS)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::PLUS)) {
 		speed += 0.1f;
 	}
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::MINUS)) { 
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::MINUS)) { 
 		speed -= 0.1f;
 	}
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::W)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::W)) {
 		position += Matrix4::Rotation(yaw, Vector3(0, 1, 0)) * Vector3(0, 0, -1) * frameSpeed;
 	}
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::S)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::S)) {
 		position -= Matrix4::Rotation(yaw, Vector3(0, 1, 0)) * Vector3(0, 0, -1) * frameSpeed;
 	}
 
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::A)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::A)) {
 		position += Matrix4::Rotation(yaw, Vector3(0, 1, 0)) * Vector3(-1, 0, 0) * frameSpeed;
 	}
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::D)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::D)) {
 		position -= Matrix4::Rotation(yaw, Vector3(0, 1, 0)) * Vector3(-1, 0, 0) * frameSpeed;
 	}
 
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::SPACE)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::SPACE)) {
 		position.y += frameSpeed;
 	}
-	if (Window::GetKeyboard()->KeyDown(KeyboardKeys::SHIFT)) {
+	if (Input::GetKeyboard()->KeyDown(KeyboardKeys::SHIFT)) {
 		position.y -= frameSpeed;
 	}
+
+	if (position != oldPosition || pitch != oldPitch || yaw != oldYaw) {
+		viewDirty = true;
+	}
 }
 
 /*
@@ -60,12 +70,50 @@ Generates a view matrix for the camera's viewpoint. This matrix can be sent
 straight to the shader...it's already an 'inverse camera' matrix.
 */
 Matrix4 Camera::BuildViewMatrix() const {
+	return GetViewMatrix();
+};
+
+/*
+Rebuilds the cached view matrices, but only if the camera has moved since the
+last time they were built. The view matrix is purely rotation and translation,
+so its inverse is just the transposed rotation - no general 4x4 inversion needed.
+*/
+void Camera::UpdateViewMatrices() const {
+	if (!viewDirty) {
+		return;
+	}
 	//Why do a complicated matrix inversion, when we can just generate the matrix
 	//using the negative values ;). The matrix multiplication order is important!
-	return	Matrix4::Rotation(-pitch, Vector3(1, 0, 0)) *
+	viewMatrix = Matrix4::Rotation(-pitch, Vector3(1, 0, 0)) *
 		Matrix4::Rotation(-yaw, Vector3(0, 1, 0)) *
 		Matrix4::Translation(-position);
-};
+
+	inverseViewMatrix = viewMatrix.RigidInverse();
+
+	viewDirty = false;
+}
+
+const Matrix4& Camera::GetViewMatrix() const {
+	UpdateViewMatrices();
+	return viewMatrix;
+}
+
+const Matrix4& Camera::GetInverseViewMatrix() const {
+	UpdateViewMatrices();
+	return inverseViewMatrix;
+}
+
+Vector3 Camera::GetRightAxis() const {
+	return Vector3(GetInverseViewMatrix().GetColumn(0));
+}
+
+Vector3 Camera::GetUpAxis() const {
+	return Vector3(GetInverseViewMatrix().GetColumn(1));
+}
+
+Vector3 Camera::GetForwardAxis() const {
+	return -Vector3(GetInverseViewMatrix().GetColumn(2));
+}
 
 Matrix4 Camera::BuildProjectionMatrix(float currentAspect) const {
 	if (camType == CameraType::Orthographic) {
@@ -26,6 +26,8 @@ namespace NCL {
 			speed		= 100.0f;
 
 			camType		= CameraType::Perspective;
+
+			viewDirty	= true;
 		};
 
 		Camera(float pitch, float yaw, const Vector3& position) : Camera() {
@@ -67,26 +69,53 @@ namespace NCL {
 		//to a vertex shader (i.e it's already an 'inverse camera matrix').
 		Matrix4 BuildViewMatrix() const;
 
+		//Cached versions of the view matrix and its inverse (the camera's world matrix).
+		//These are only rebuilt when the position, pitch or yaw has changed.
+		const Matrix4& GetViewMatrix() const;
+		const Matrix4& GetInverseViewMatrix() const;
+
+		//World space basis vectors of the camera, taken from the cached inverse view matrix
+		Vector3 GetRightAxis()		const;
+		Vector3 GetUpAxis()			const;
+		Vector3 GetForwardAxis()	const;
+
 		Matrix4 BuildProjectionMatrix(float currentAspect = 1.0f) const;
 
 		//Gets position in world space
 		Vector3 GetPosition() const { return position; }
 		//Sets position in world space
-		void	SetPosition(const Vector3& val) { position = val; }
+		void	SetPosition(const Vector3& val) {
+			if (val != position) {
+				position	= val;
+				viewDirty	= true;
+			}
+		}
 
 		//Gets yaw, in degrees
 		float	GetYaw()   const { return yaw; }
 		//Sets yaw, in degrees
-		void	SetYaw(float y) { yaw = y; }
+		void	SetYaw(float y) {
+			if (y != yaw) {
+				yaw			= y;
+				viewDirty	= true;
+			}
+		}
 
 		//Gets pitch, in degrees
 		float	GetPitch() const { return pitch; }
 		//Sets pitch, in degrees
-		void	SetPitch(float p) { pitch = p; }
+		void	SetPitch(float p) {
+			if (p != pitch) {
+				pitch		= p;
+				viewDirty	= true;
+			}
+		}
 
 		static Camera BuildPerspectiveCamera(const Vector3& pos, float pitch, float yaw, float fov, float near, float far);
 		static Camera BuildOrthoCamera(const Vector3& pos, float pitch, float yaw, float left, float right, float top, float bottom, float near, float far);
 	protected:
+		void UpdateViewMatrices() const;
+
 		CameraType camType;
 
 		float	nearPlane;
@@ -101,5 +130,9 @@ namespace NCL {
 		float	pitch;
 		float	speed;
 		Vector3 position;
+
+		mutable bool	viewDirty;
+		mutable Matrix4 viewMatrix;
+		mutable Matrix4 inverseViewMatrix;
 	};
 }
\ No newline at end of file
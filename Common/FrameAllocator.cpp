@@ -0,0 +1,96 @@
+#include "FrameAllocator.h"
+#include <cstdlib>
+#include <cstdint>
+
+using namespace NCL;
+
+FrameAllocator::FrameAllocator(size_t bytesPerFrame) {
+	for (Buffer& b : buffers) {
+		b.memory	= new char[bytesPerFrame];
+		b.capacity	= bytesPerFrame;
+		b.offset	= 0;
+		b.overflow	= nullptr;
+	}
+	current						= 0;
+	heapAllocations				= 0;
+	lastFrameHeapAllocations	= 0;
+}
+
+FrameAllocator::~FrameAllocator() {
+	for (Buffer& b : buffers) {
+		while (b.overflow) {
+			Overflow* next = b.overflow->next;
+			std::free(b.overflow);
+			b.overflow = next;
+		}
+		delete[] b.memory;
+	}
+}
+
+FrameAllocator& FrameAllocator::Get() {
+	static FrameAllocator frameAllocator;
+	return frameAllocator;
+}
+
+void* FrameAllocator::Allocate(size_t bytes, size_t alignment) {
+	Buffer& b = buffers[current];
+
+	size_t size		= bytes + alignment - 1; // Worst case padding
+	size_t start	= b.offset.fetch_add(size);
+
+	if (start + size > b.capacity) {
+		return AllocateOverflow(b, bytes, alignment);
+	}
+	uintptr_t address = (uintptr_t)(b.memory + start);
+	address = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	return (void*)address;
+}
+
+/*
+The buffer's full, so this allocation has to come from the heap. The block
+is put on the buffer's overflow list, so it gets freed at the same time the
+buffer would have been reused.
+*/
+void* FrameAllocator::AllocateOverflow(Buffer& b, size_t bytes, size_t alignment) {
+	heapAllocations++;
+
+	char* block = (char*)std::malloc(sizeof(Overflow) + alignment + bytes);
+	if (!block) {
+		return nullptr;
+	}
+	{
+		std::lock_guard<std::mutex> lock(overflowLock);
+		((Overflow*)block)->next	= b.overflow;
+		b.overflow					= (Overflow*)block;
+	}
+	uintptr_t address = (uintptr_t)(block + sizeof(Overflow));
+	address = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	return (void*)address;
+}
+
+void FrameAllocator::BeginFrame() {
+	lastFrameHeapAllocations = heapAllocations.exchange(0);
+
+	current = 1 - current;
+	Buffer& b = buffers[current];
+
+	while (b.overflow) {
+		Overflow* next = b.overflow->next;
+		std::free(b.overflow);
+		b.overflow = next;
+	}
+	size_t used = b.offset;
+	if (used > b.capacity) { // Ran out last time it was used, so make room for that much and more
+		delete[] b.memory;
+		b.capacity	= used + used / 2;
+		b.memory	= new char[b.capacity];
+		heapAllocations++;
+	}
+	b.offset = 0;
+}
+
+size_t FrameAllocator::GetBytesUsed() const {
+	const Buffer& b = buffers[current];
+	size_t used = b.offset;
+	return used < b.capacity ? used : b.capacity;
+}
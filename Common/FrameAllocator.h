@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+
+namespace NCL {
+	/*
+	A linear 'bump' allocator for memory that only needs to last a frame or
+	so. Allocating just moves an offset along (atomically, so jobs can use it
+	too), and nothing is ever freed individually - instead, BeginFrame swaps
+	over to the other of two buffers and starts again from the beginning.
+	Anything allocated in one frame is therefore still valid throughout the
+	next one, and is thrown away at the start of the frame after that.
+
+	If a frame needs more than the buffer holds, the rest comes from the heap
+	and is counted - the buffer is then grown the next time it's reused, so
+	after a few frames a steady workload makes no heap allocations at all.
+	*/
+	class FrameAllocator {
+	public:
+		FrameAllocator(size_t bytesPerFrame = 1024 * 1024);
+		~FrameAllocator();
+
+		void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+		//Must only be called while nothing else is allocating
+		void BeginFrame();
+
+		size_t GetBytesUsed()	const;
+		size_t GetCapacity()	const { return buffers[current].capacity; }
+
+		//Heap allocations made during the last complete frame - should settle at 0
+		size_t GetHeapAllocations() const { return lastFrameHeapAllocations; }
+
+		static FrameAllocator& Get();
+
+	protected:
+		struct Overflow {
+			Overflow* next;
+		};
+
+		struct Buffer {
+			char*				memory;
+			size_t				capacity;
+			std::atomic<size_t>	offset;
+			Overflow*			overflow;
+		};
+
+		void* AllocateOverflow(Buffer& b, size_t bytes, size_t alignment);
+
+		Buffer				buffers[2];
+		int					current;
+		std::mutex			overflowLock;
+		std::atomic<size_t>	heapAllocations;
+		size_t				lastFrameHeapAllocations;
+	};
+
+	/*
+	Lets the standard containers use the frame allocator. Deallocation does
+	nothing, so a container that outlives its frame must not be clear()ed and
+	reused - its storage is gone two frames later. Use ResetFrameContainer at
+	the start of each frame instead, which drops the old storage entirely.
+	*/
+	template<class T>
+	class FrameAdaptor {
+	public:
+		typedef T value_type;
+
+		FrameAdaptor() {}
+
+		template<class U>
+		FrameAdaptor(const FrameAdaptor<U>&) {}
+
+		T* allocate(size_t n) {
+			return (T*)FrameAllocator::Get().Allocate(n * sizeof(T), alignof(T));
+		}
+
+		void deallocate(T*, size_t) {}
+
+		template<class U>
+		bool operator==(const FrameAdaptor<U>&) const { return true; }
+
+		template<class U>
+		bool operator!=(const FrameAdaptor<U>&) const { return false; }
+	};
+
+	template<class T>
+	using FrameVector = std::vector<T, FrameAdaptor<T>>;
+
+	typedef std::basic_string<char, std::char_traits<char>, FrameAdaptor<char>> FrameString;
+
+	template<class Container>
+	void ResetFrameContainer(Container& c) {
+		Container().swap(c);
+	}
+}
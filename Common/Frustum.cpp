@@ -0,0 +1,116 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "Frustum.h"
+
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE
+#endif
+
+using namespace NCL;
+using namespace NCL::Maths;
+
+void BoxList::Clear() {
+	centreX.clear();
+	centreY.clear();
+	centreZ.clear();
+	halfX.clear();
+	halfY.clear();
+	halfZ.clear();
+}
+
+void BoxList::Add(const Vector3& centre, const Vector3& halfSize) {
+	centreX.emplace_back(centre.x);
+	centreY.emplace_back(centre.y);
+	centreZ.emplace_back(centre.z);
+	halfX.emplace_back(halfSize.x);
+	halfY.emplace_back(halfSize.y);
+	halfZ.emplace_back(halfSize.z);
+}
+
+Frustum::Frustum() {
+}
+
+/*
+Each plane is the matrix's fourth row plus or minus one of the others
+(Gribb and Hartmann) - the matrix is column major, so row r is spread
+across array[r], array[r + 4], array[r + 8] and array[r + 12].
+*/
+Frustum::Frustum(const Matrix4& viewProj) {
+	const float* m = viewProj.array;
+	for (int i = 0; i < 6; ++i) {
+		int		row		= i / 2;
+		float	sign	= (i & 1) ? -1.0f : 1.0f;
+		Vector3 normal(m[3] + sign * m[row], m[7] + sign * m[row + 4], m[11] + sign * m[row + 8]);
+		planes[i] = Plane(normal, m[15] + sign * m[row + 12], true);
+	}
+}
+
+bool Frustum::BoxInside(const Vector3& centre, const Vector3& halfSize) const {
+	for (int i = 0; i < 6; ++i) {
+		Vector3 n		= planes[i].GetNormal();
+		float	radius	= fabsf(n.x) * halfSize.x + fabsf(n.y) * halfSize.y + fabsf(n.z) * halfSize.z;
+		if (Vector3::Dot(centre, n) + planes[i].GetDistance() < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+A box is outside if it's entirely behind any one plane: its centre's
+distance in front of the plane, plus its extent along the plane normal,
+is below zero. Each group of four boxes is tested against every plane,
+rather than stopping early, so there's no branching per box.
+*/
+void Frustum::CullBoxes(const BoxList& boxes, uint8_t* visible) const {
+	const size_t count	= boxes.Size();
+	size_t i			= 0;
+#ifdef FRUSTUM_SSE
+	__m128 nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+	for (int p = 0; p < 6; ++p) {
+		Vector3 n = planes[p].GetNormal();
+		nx[p] = _mm_set1_ps(n.x);
+		ny[p] = _mm_set1_ps(n.y);
+		nz[p] = _mm_set1_ps(n.z);
+		ax[p] = _mm_set1_ps(fabsf(n.x));
+		ay[p] = _mm_set1_ps(fabsf(n.y));
+		az[p] = _mm_set1_ps(fabsf(n.z));
+		d[p]  = _mm_set1_ps(planes[p].GetDistance());
+	}
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		__m128 cx = _mm_loadu_ps(&boxes.centreX[i]);
+		__m128 cy = _mm_loadu_ps(&boxes.centreY[i]);
+		__m128 cz = _mm_loadu_ps(&boxes.centreZ[i]);
+		__m128 hx = _mm_loadu_ps(&boxes.halfX[i]);
+		__m128 hy = _mm_loadu_ps(&boxes.halfY[i]);
+		__m128 hz = _mm_loadu_ps(&boxes.halfZ[i]);
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; ++p) {
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)), _mm_add_ps(_mm_mul_ps(nz[p], cz), d[p]));
+			__m128 rad	= _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], hx), _mm_mul_ps(ay[p], hy)), _mm_mul_ps(az[p], hz));
+			outside		= _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, rad), zero));
+		}
+		int mask = _mm_movemask_ps(outside);
+		visible[i + 0] = (mask & 1) ? 0 : 1;
+		visible[i + 1] = (mask & 2) ? 0 : 1;
+		visible[i + 2] = (mask & 4) ? 0 : 1;
+		visible[i + 3] = (mask & 8) ? 0 : 1;
+	}
+#endif
+	for (; i < count; ++i) {
+		Vector3 centre(boxes.centreX[i], boxes.centreY[i], boxes.centreZ[i]);
+		Vector3 half(boxes.halfX[i], boxes.halfY[i], boxes.halfZ[i]);
+		visible[i] = BoxInside(centre, half) ? 1 : 0;
+	}
+}
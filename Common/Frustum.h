@@ -0,0 +1,63 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include "Plane.h"
+#include "Matrix4.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace NCL {
+	namespace Maths {
+		/*
+		Axis aligned boxes, stored as a separate array per component so the
+		frustum can test four of them against a plane at once.
+		*/
+		class BoxList {
+		public:
+			void Clear();
+			void Add(const Vector3& centre, const Vector3& halfSize);
+
+			size_t Size() const {
+				return centreX.size();
+			}
+
+			std::vector<float> centreX;
+			std::vector<float> centreY;
+			std::vector<float> centreZ;
+			std::vector<float> halfX;
+			std::vector<float> halfY;
+			std::vector<float> halfZ;
+		};
+
+		/*
+		The six planes of a view-projection matrix's clip volume, facing
+		inwards. Works for any projection, so it can cull for a camera or for
+		a shadow casting light alike.
+		*/
+		class Frustum {
+		public:
+			Frustum();
+			Frustum(const Matrix4& viewProj);
+
+			//Conservative - boxes straddling a corner can pass when they're just outside
+			bool BoxInside(const Vector3& centre, const Vector3& halfSize) const;
+
+			//Sets each box's entry in visible to 1 if it might be seen, or 0 if not
+			void CullBoxes(const BoxList& boxes, uint8_t* visible) const;
+
+			const Plane& GetPlane(int i) const {
+				return planes[i];
+			}
+
+		protected:
+			Plane planes[6];
+		};
+	}
+}
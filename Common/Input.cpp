@@ -0,0 +1,196 @@
+#include "Input.h"
+#include "Window.h"
+
+#include <cstring>
+#include <iostream>
+
+using namespace NCL;
+
+std::ofstream		Input::recordFile;
+uint8_t				Input::recordedKeys[(int)KeyboardKeys::MAXVALUE];
+
+Keyboard*			Input::playbackKeyboard	= nullptr;
+Mouse*				Input::playbackMouse	= nullptr;
+std::vector<char>	Input::playbackData;
+size_t				Input::playbackOffset	= 0;
+
+uint32_t			Input::frameNumber		= 0;
+
+namespace {
+	const char		FILE_MAGIC[4]	= { 'N', 'C', 'L', 'I' };
+	const uint32_t	FILE_VERSION	= 1;
+
+	//Each key's state is packed into a byte, each mouse button state into a bit
+	const uint8_t	KEY_DOWN		= 1 << 0;
+	const uint8_t	KEY_HELD		= 1 << 1;
+
+	uint8_t PackButtons(const bool* buttons) {
+		uint8_t bits = 0;
+		for (int i = 0; i < (int)MouseButtons::MAXVAL; ++i) {
+			bits |= buttons[i] ? (1 << i) : 0;
+		}
+		return bits;
+	}
+
+	void UnpackButtons(uint8_t bits, bool* buttons) {
+		for (int i = 0; i < (int)MouseButtons::MAXVAL; ++i) {
+			buttons[i] = (bits & (1 << i)) != 0;
+		}
+	}
+}
+
+bool Input::UpdateFrame(float& dt) {
+	if (IsPlayingBack()) {
+		if (!PlayFrame(dt)) {
+			playbackOffset = playbackData.size(); // Anything left is a partial frame
+			return false;
+		}
+	}
+	else if (IsRecording()) {
+		RecordFrame(dt);
+	}
+	frameNumber++;
+	return true;
+}
+
+const Keyboard* Input::GetKeyboard() {
+	return playbackKeyboard ? playbackKeyboard : Window::GetKeyboard();
+}
+
+const Mouse* Input::GetMouse() {
+	return playbackMouse ? playbackMouse : Window::GetMouse();
+}
+
+bool Input::StartRecording(const std::string& filename) {
+	Stop();
+	recordFile.open(filename, std::ios::binary);
+	if (!recordFile) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	recordFile.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	recordFile.write((const char*)&FILE_VERSION, sizeof(FILE_VERSION));
+
+	memset(recordedKeys, 0, sizeof(recordedKeys));
+	frameNumber = 0;
+	return true;
+}
+
+/*
+The whole recording is read in up front, so that playing it back doesn't
+touch the disk, and per-frame timings taken during a replay aren't thrown
+off by file reads.
+*/
+bool Input::StartPlayback(const std::string& filename) {
+	Stop();
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	playbackData.resize((size_t)file.tellg());
+	file.seekg(0);
+	file.read(playbackData.data(), playbackData.size());
+	playbackOffset = 0;
+
+	char		magic[4];
+	uint32_t	version = 0;
+	if (!Read(magic, sizeof(magic)) || memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+		!Read(&version, sizeof(version)) || version != FILE_VERSION) {
+		std::cout << __FUNCTION__ << " " << filename << " isn't an input recording this version can play" << std::endl;
+		playbackData.clear();
+		return false;
+	}
+	playbackKeyboard	= new Keyboard();
+	playbackMouse		= new Mouse();
+	frameNumber			= 0;
+	return true;
+}
+
+void Input::Stop() {
+	if (recordFile.is_open()) {
+		recordFile.close();
+	}
+	delete playbackKeyboard;
+	delete playbackMouse;
+	playbackKeyboard	= nullptr;
+	playbackMouse		= nullptr;
+	playbackData.clear();
+	playbackOffset		= 0;
+}
+
+/*
+Only the keys that changed since the last frame are written, as a key index
+and state byte each - most frames that's none, or one or two.
+*/
+void Input::RecordFrame(float dt) {
+	const Keyboard* keyboard	= Window::GetKeyboard();
+	const Mouse*	mouse		= Window::GetMouse();
+	if (!keyboard || !mouse) {
+		return;
+	}
+	uint8_t changedKeys[(int)KeyboardKeys::MAXVALUE * 2];
+	uint8_t changeCount = 0;
+	for (int i = 0; i < (int)KeyboardKeys::MAXVALUE; ++i) {
+		uint8_t state = (keyboard->keyStates[i] ? KEY_DOWN : 0) | (keyboard->holdStates[i] ? KEY_HELD : 0);
+		if (state != recordedKeys[i]) {
+			changedKeys[changeCount * 2]		= (uint8_t)i;
+			changedKeys[changeCount * 2 + 1]	= state;
+			changeCount++;
+			recordedKeys[i] = state;
+		}
+	}
+	uint8_t buttons[3] = {
+		PackButtons(mouse->buttons),
+		PackButtons(mouse->holdButtons),
+		PackButtons(mouse->doubleClicks)
+	};
+	int32_t wheel = mouse->frameWheel;
+
+	recordFile.write((const char*)&dt, sizeof(dt));
+	recordFile.write((const char*)&changeCount, sizeof(changeCount));
+	recordFile.write((const char*)changedKeys, changeCount * 2);
+	recordFile.write((const char*)buttons, sizeof(buttons));
+	recordFile.write((const char*)&wheel, sizeof(wheel));
+	recordFile.write((const char*)&mouse->relativePosition, sizeof(Vector2));
+	recordFile.write((const char*)&mouse->absolutePosition, sizeof(Vector2));
+	recordFile.write((const char*)&mouse->windowPosition,	sizeof(Vector2));
+}
+
+bool Input::PlayFrame(float& dt) {
+	uint8_t changeCount = 0;
+	if (!Read(&dt, sizeof(dt)) || !Read(&changeCount, sizeof(changeCount))) {
+		return false;
+	}
+	for (uint8_t i = 0; i < changeCount; ++i) {
+		uint8_t key		= 0;
+		uint8_t state	= 0;
+		if (!Read(&key, sizeof(key)) || !Read(&state, sizeof(state)) || key >= (int)KeyboardKeys::MAXVALUE) {
+			return false;
+		}
+		playbackKeyboard->keyStates[key]	= (state & KEY_DOWN) != 0;
+		playbackKeyboard->holdStates[key]	= (state & KEY_HELD) != 0;
+	}
+	uint8_t buttons[3];
+	int32_t wheel = 0;
+	if (!Read(buttons, sizeof(buttons)) || !Read(&wheel, sizeof(wheel)) ||
+		!Read(&playbackMouse->relativePosition, sizeof(Vector2)) ||
+		!Read(&playbackMouse->absolutePosition, sizeof(Vector2)) ||
+		!Read(&playbackMouse->windowPosition,	sizeof(Vector2))) {
+		return false;
+	}
+	UnpackButtons(buttons[0], playbackMouse->buttons);
+	UnpackButtons(buttons[1], playbackMouse->holdButtons);
+	UnpackButtons(buttons[2], playbackMouse->doubleClicks);
+	playbackMouse->frameWheel = wheel;
+	return true;
+}
+
+bool Input::Read(void* into, size_t bytes) {
+	if (playbackOffset + bytes > playbackData.size()) {
+		return false;
+	}
+	memcpy(into, playbackData.data() + playbackOffset, bytes);
+	playbackOffset += bytes;
+	return true;
+}
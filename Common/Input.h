@@ -0,0 +1,62 @@
+#pragma once
+#include "Keyboard.h"
+#include "Mouse.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace NCL {
+	/*
+	Where gameplay code should read the keyboard and mouse from, instead of
+	going to the Window directly. Normally it just hands back the Window's
+	devices, but it can also record every frame's keyboard, mouse and frame
+	time out to a file, or play a recording back in their place - so a play
+	session can be repeated exactly, as many times as needed.
+
+	The file is a small header followed by one record per frame: the dt, the
+	keys whose state changed since the previous frame, then the mouse.
+	*/
+	class Input {
+	public:
+		/*
+		Call once a frame, after Window::UpdateWindow. dt is changed to the one
+		the frame should use - while playing back, that's the recorded one
+		rather than the one passed in. Returns false if playback has run out,
+		in which case there's no input for the frame and it shouldn't be run.
+		*/
+		static bool UpdateFrame(float& dt);
+
+		static const Keyboard*	GetKeyboard();
+		static const Mouse*		GetMouse();
+
+		static bool StartRecording(const std::string& filename);
+		static bool StartPlayback(const std::string& filename);
+		static void Stop();
+
+		static bool IsRecording()		{ return recordFile.is_open(); }
+		static bool IsPlayingBack()		{ return playbackKeyboard != nullptr; }
+
+		//True once the last recorded frame has been handed out
+		static bool PlaybackFinished()	{ return IsPlayingBack() && playbackOffset >= playbackData.size(); }
+
+		static uint32_t GetFrameNumber() { return frameNumber; }
+
+	protected:
+		static void RecordFrame(float dt);
+		static bool PlayFrame(float& dt);
+
+		static bool Read(void* into, size_t bytes);
+
+		static std::ofstream		recordFile;
+		static uint8_t				recordedKeys[(int)KeyboardKeys::MAXVALUE];
+
+		static Keyboard*			playbackKeyboard;
+		static Mouse*				playbackMouse;
+		static std::vector<char>	playbackData;
+		static size_t				playbackOffset;
+
+		static uint32_t				frameNumber;
+	};
+}
@@ -0,0 +1,223 @@
+#include "JobSystem.h"
+
+#include <cassert>
+
+using namespace NCL;
+
+//Set by the constructor for the owning thread, and by WorkerLoop for the workers
+static thread_local const JobSystem*	threadSystem	= nullptr;
+static thread_local unsigned int		threadIndex		= JobSystem::UNREGISTERED_THREAD;
+
+JobSystem::JobSystem(unsigned int numWorkers) {
+	if (numWorkers == 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+	running		= true;
+	queuedJobs	= 0;
+
+	for (unsigned int i = 0; i < numWorkers + 1; ++i) {
+		Job* ring = new Job[MAX_JOBS_PER_THREAD];
+		for (unsigned int j = 0; j < MAX_JOBS_PER_THREAD; ++j) {
+			ring[j].unfinished	= 0;
+			ring[j].reusable	= true; // So AllocateJob sees every slot as free
+		}
+		queues.emplace_back(new WorkQueue());
+		jobRings.emplace_back(ring);
+		jobCounters.emplace_back(0);
+	}
+	threadSystem	= this;
+	threadIndex		= 0;
+
+	for (unsigned int i = 1; i < numWorkers + 1; ++i) {
+		workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+JobSystem::~JobSystem() {
+	running = false;
+	{
+		std::lock_guard<std::mutex> lock(wakeLock);
+	}
+	wakeCondition.notify_all();
+	for (std::thread& t : workers) {
+		t.join();
+	}
+	for (WorkQueue* q : queues) {
+		delete q;
+	}
+	for (Job* ring : jobRings) {
+		delete[] ring;
+	}
+	if (threadSystem == this) {
+		threadSystem	= nullptr;
+		threadIndex		= UNREGISTERED_THREAD;
+	}
+}
+
+unsigned int JobSystem::GetThreadIndex() {
+	return threadIndex;
+}
+
+bool JobSystem::IsRegisteredThread() const {
+	return threadSystem == this;
+}
+
+JobSystem::Job* JobSystem::AllocateJob() {
+	assert(IsRegisteredThread() && "Jobs can only be made by the JobSystem's owner and workers");
+	unsigned int index = threadIndex;
+	Job* job = &jobRings[index][jobCounters[index]++ & (MAX_JOBS_PER_THREAD - 1)];
+
+	while (!job->reusable.load()) { // The ring is full - help out until this slot is free
+		if (!RunOneJob()) {
+			std::this_thread::yield();
+		}
+	}
+
+	job->reusable	= false;
+	job->parent		= nullptr;
+	job->unfinished	= 1;
+	job->blockers	= 1;
+	job->finished	= false;
+	job->dependents.clear();
+	return job;
+}
+
+JobSystem::Job* JobSystem::CreateJob(const JobFunc& func) {
+	Job* job	= AllocateJob();
+	job->func	= func;
+	return job;
+}
+
+JobSystem::Job* JobSystem::CreateChildJob(Job* parent, const JobFunc& func) {
+	parent->unfinished++;
+	Job* job	= AllocateJob();
+	job->func	= func;
+	job->parent = parent;
+	return job;
+}
+
+void JobSystem::AddDependency(Job* job, Job* dependency) {
+	std::lock_guard<std::mutex> lock(dependency->dependentLock);
+	if (dependency->finished) {
+		return;
+	}
+	job->blockers++;
+	dependency->dependents.emplace_back(job);
+}
+
+void JobSystem::Run(Job* job) {
+	if (job->blockers.fetch_sub(1) == 1) {
+		Push(job);
+	}
+}
+
+bool JobSystem::IsFinished(const Job* job) const {
+	return job->unfinished.load() == 0;
+}
+
+void JobSystem::Wait(const Job* job) {
+	while (!IsFinished(job)) {
+		if (!RunOneJob()) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::Push(Job* job) {
+	assert(IsRegisteredThread() && "Jobs can only be run by the JobSystem's owner and workers");
+	WorkQueue* queue = queues[threadIndex];
+	{
+		std::lock_guard<std::mutex> lock(queue->lock);
+		queue->jobs.emplace_back(job);
+	}
+	queuedJobs++;
+	{
+		std::lock_guard<std::mutex> lock(wakeLock); // So a worker about to sleep can't miss this
+	}
+	wakeCondition.notify_one();
+}
+
+/*
+Newest job from our own queue first, as it's the most likely to still be in
+the cache, and failing that the oldest job from anyone else's.
+*/
+JobSystem::Job* JobSystem::GetJob() {
+	unsigned int index = threadIndex;
+	{
+		WorkQueue* own = queues[index];
+		std::lock_guard<std::mutex> lock(own->lock);
+		if (!own->jobs.empty()) {
+			Job* job = own->jobs.back();
+			own->jobs.pop_back();
+			queuedJobs--;
+			return job;
+		}
+	}
+	for (size_t i = 1; i < queues.size(); ++i) {
+		WorkQueue* victim = queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim->lock);
+		if (!victim->jobs.empty()) {
+			Job* job = victim->jobs.front();
+			victim->jobs.pop_front();
+			queuedJobs--;
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+bool JobSystem::RunOneJob() {
+	Job* job = GetJob();
+	if (!job) {
+		return false;
+	}
+	Execute(job);
+	return true;
+}
+
+void JobSystem::Execute(Job* job) {
+	if (job->func) {
+		job->func();
+	}
+	Finish(job);
+}
+
+/*
+Anyone waiting on the job can carry on as soon as unfinished hits 0, but the
+slot isn't handed back to AllocateJob until everything still needed from it
+has been taken out - otherwise the ring could wrap onto it and overwrite the
+parent and dependents while they're being read.
+*/
+void JobSystem::Finish(Job* job) {
+	if (job->unfinished.fetch_sub(1) != 1) {
+		return; // Still waiting on children
+	}
+	Job* parent = job->parent;
+	std::vector<Job*> ready;
+	{
+		std::lock_guard<std::mutex> lock(job->dependentLock);
+		job->finished = true;
+		ready.swap(job->dependents);
+	}
+	job->reusable = true;
+
+	for (Job* dependent : ready) {
+		Run(dependent);
+	}
+	if (parent) {
+		Finish(parent);
+	}
+}
+
+void JobSystem::WorkerLoop(unsigned int index) {
+	threadSystem	= this;
+	threadIndex		= index;
+	while (running) {
+		if (RunOneJob()) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(wakeLock);
+		wakeCondition.wait(lock, [&]() { return queuedJobs.load() > 0 || !running; });
+	}
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace NCL {
+	/*
+	A small work-stealing job scheduler. Each thread (the workers, plus the
+	thread that created the JobSystem, which is always thread index 0) has its
+	own queue of jobs - a thread pushes and pops from the back of its own queue,
+	and when it runs out of work it steals from the front of someone else's.
+
+	Jobs can have child jobs (the parent doesn't count as finished until all of
+	its children have), and dependencies (a job isn't queued until everything
+	it depends on has finished). Waiting on a job doesn't block, the waiting
+	thread runs other jobs until the one it wants is done.
+
+	Job memory comes from a per-thread ring buffer, and is reused without being
+	freed, so a Job* is only valid until that thread has made another
+	MAX_JOBS_PER_THREAD jobs - plenty for anything waited on within a frame.
+	If the ring comes back round to a job that still hasn't finished, the
+	thread runs other jobs until it has, rather than overwriting it - so a
+	thread mustn't make a whole ring's worth of jobs while holding one it
+	hasn't called Run on yet.
+
+	Only the owning thread and the workers have a queue and a ring, so jobs
+	can only be made and run from those. Other threads get ParallelFor run
+	inline for them, and anything else is a bug.
+	*/
+	class JobSystem {
+	public:
+		typedef std::function<void()> JobFunc;
+		struct Job;
+
+		//0 workers means one less than the number of hardware threads
+		JobSystem(unsigned int numWorkers = 0);
+		~JobSystem();
+
+		Job* CreateJob(const JobFunc& func);
+		Job* CreateChildJob(Job* parent, const JobFunc& func);
+
+		//job won't be run until dependency has finished. Must be called before Run(job)
+		void AddDependency(Job* job, Job* dependency);
+
+		void Run(Job* job);
+		void Wait(const Job* job);
+		bool IsFinished(const Job* job) const;
+
+		/*
+		Splits [0, count) into chunks of at most grainSize, and calls
+		func(begin, end) on each chunk across all of the threads, returning
+		once they have all been done. func is called per chunk rather than
+		per element, so the loop inside it can be inlined.
+		*/
+		template<typename Func>
+		void ParallelFor(size_t count, size_t grainSize, const Func& func) {
+			if (count == 0) {
+				return;
+			}
+			if (grainSize == 0) {
+				grainSize = 1;
+			}
+			if (count <= grainSize || workers.empty() || !IsRegisteredThread()) {
+				func((size_t)0, count);
+				return;
+			}
+			//The root stays unfinished until every chunk is done, so the chunks mustn't wrap the ring onto it
+			const size_t maxChunks = MAX_JOBS_PER_THREAD / 2;
+			if ((count + grainSize - 1) / grainSize > maxChunks) {
+				grainSize = (count + maxChunks - 1) / maxChunks;
+			}
+			Job* root = CreateJob(JobFunc());
+			for (size_t begin = 0; begin < count; begin += grainSize) {
+				size_t end = begin + grainSize < count ? begin + grainSize : count;
+				Run(CreateChildJob(root, [&func, begin, end]() { func(begin, end); }));
+			}
+			Run(root);
+			Wait(root);
+		}
+
+		//Workers, plus the thread that owns the JobSystem
+		unsigned int GetThreadCount() const { return (unsigned int)queues.size(); }
+
+		//0 on the owning thread, 1..n on the workers, and UNREGISTERED_THREAD anywhere else
+		static unsigned int GetThreadIndex();
+
+		//Whether the calling thread is this JobSystem's owner or one of its workers
+		bool IsRegisteredThread() const;
+
+		static const unsigned int UNREGISTERED_THREAD = ~0u;
+
+		static const unsigned int MAX_JOBS_PER_THREAD = 4096;
+
+		struct Job {
+			JobFunc				func;
+			Job*				parent;
+			std::atomic<int>	unfinished;		// This job, plus any unfinished children
+			std::atomic<int>	blockers;		// Unfinished dependencies, plus one until Run is called
+			std::mutex			dependentLock;
+			std::vector<Job*>	dependents;
+			bool				finished;
+			std::atomic<bool>	reusable;		// Set once Finish is done with the slot, not just the job
+		};
+
+	protected:
+		struct WorkQueue {
+			std::mutex			lock;
+			std::deque<Job*>	jobs;
+		};
+
+		Job*	AllocateJob();
+		void	Push(Job* job);
+		Job*	GetJob();
+		bool	RunOneJob();
+		void	Execute(Job* job);
+		void	Finish(Job* job);
+		void	WorkerLoop(unsigned int index);
+
+		std::vector<std::thread>	workers;
+		std::vector<WorkQueue*>		queues;
+		std::vector<Job*>			jobRings;
+		std::vector<unsigned int>	jobCounters; // Only ever touched by the owning thread
+
+		std::atomic<bool>		running;
+		std::atomic<int>		queuedJobs;
+		std::mutex				wakeLock;
+		std::condition_variable	wakeCondition;
+	};
+}
@@ -164,6 +164,7 @@ namespace NCL {
 	class Keyboard {
 	public:
 		friend class Window;
+		friend class Input;
 
 		//Is this key currently pressed down?
 		bool KeyDown(KeyboardKeys key) const {
@@ -0,0 +1,105 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace NCL;
+
+MappedFile::MappedFile() {
+	data	= nullptr;
+	size	= 0;
+#ifdef _WIN32
+	fileHandle		= INVALID_HANDLE_VALUE;
+	mappingHandle	= nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& filename) {
+	Close();
+	fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		std::cout << __FUNCTION__ << " " << filename << " is empty!" << std::endl;
+		Close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle) {
+		data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (!data) {
+		std::cout << __FUNCTION__ << " can't map " << filename << std::endl;
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+	}
+	data			= nullptr;
+	size			= 0;
+	fileHandle		= INVALID_HANDLE_VALUE;
+	mappingHandle	= nullptr;
+}
+#else
+bool MappedFile::Open(const std::string& filename) {
+	Close();
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	struct stat fileInfo;
+	if (fstat(file, &fileInfo) != 0 || fileInfo.st_size == 0) {
+		std::cout << __FUNCTION__ << " " << filename << " is empty!" << std::endl;
+		close(file);
+		return false;
+	}
+	void* view = mmap(nullptr, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file); // The mapping keeps its own reference to the file
+	if (view == MAP_FAILED) {
+		std::cout << __FUNCTION__ << " can't map " << filename << std::endl;
+		return false;
+	}
+	data = (const char*)view;
+	size = (size_t)fileInfo.st_size;
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+		munmap((void*)data, size);
+	}
+	data = nullptr;
+	size = 0;
+}
+#endif
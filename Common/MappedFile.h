@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+
+namespace NCL {
+	/*
+	A read-only view of a whole file, mapped into memory by the OS rather
+	than read into a buffer. Pages are only loaded when they're touched, and
+	come straight out of the file cache, so data can be handed to something
+	like glBufferData without ever being copied by us.
+
+	The view stays valid until Close, or until the MappedFile is destroyed.
+	*/
+	class MappedFile {
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::string& filename);
+		void Close();
+
+		bool		IsOpen()	const { return data != nullptr; }
+		const char*	GetData()	const { return data; }
+		size_t		GetSize()	const { return size; }
+
+	protected:
+		const char*	data;
+		size_t		size;
+
+#ifdef _WIN32
+		void*		fileHandle;
+		void*		mappingHandle;
+#endif
+	};
+}
@@ -12,6 +12,7 @@ https://research.ncl.ac.uk/game/
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Quaternion.h"
+#include <cstring>
 
 using namespace NCL;
 using namespace NCL::Maths;
@@ -281,6 +282,62 @@ Matrix4 Matrix4::Inverse()	const {
 	return temp;
 }
 
+Matrix4 Matrix4::AffineInverse() const {
+	Matrix4 m;
+
+	// Cofactors of the upper 3x3
+	float c0 = array[5] * array[10] - array[6] * array[9];
+	float c1 = array[2] * array[9]  - array[1] * array[10];
+	float c2 = array[1] * array[6]  - array[2] * array[5];
+
+	float det = array[0] * c0 + array[4] * c1 + array[8] * c2;
+
+	if (det == 0.0f) {
+		return m;
+	}
+	float invDet = 1.0f / det;
+
+	m.array[0]  = c0 * invDet;
+	m.array[1]  = c1 * invDet;
+	m.array[2]  = c2 * invDet;
+
+	m.array[4]  = (array[6] * array[8]  - array[4] * array[10]) * invDet;
+	m.array[5]  = (array[0] * array[10] - array[2] * array[8])  * invDet;
+	m.array[6]  = (array[2] * array[4]  - array[0] * array[6])  * invDet;
+
+	m.array[8]  = (array[4] * array[9]  - array[5] * array[8])  * invDet;
+	m.array[9]  = (array[1] * array[8]  - array[0] * array[9])  * invDet;
+	m.array[10] = (array[0] * array[5]  - array[1] * array[4])  * invDet;
+
+	m.array[12] = -(m.array[0] * array[12] + m.array[4] * array[13] + m.array[8]  * array[14]);
+	m.array[13] = -(m.array[1] * array[12] + m.array[5] * array[13] + m.array[9]  * array[14]);
+	m.array[14] = -(m.array[2] * array[12] + m.array[6] * array[13] + m.array[10] * array[14]);
+
+	return m;
+}
+
+Matrix4 Matrix4::RigidInverse() const {
+	Matrix4 m;
+
+	m.array[0]  = array[0];
+	m.array[1]  = array[4];
+	m.array[2]  = array[8];
+
+	m.array[4]  = array[1];
+	m.array[5]  = array[5];
+	m.array[6]  = array[9];
+
+	m.array[8]  = array[2];
+	m.array[9]  = array[6];
+	m.array[10] = array[10];
+
+	m.array[12] = -(array[0] * array[12] + array[1] * array[13] + array[2]  * array[14]);
+	m.array[13] = -(array[4] * array[12] + array[5] * array[13] + array[6]  * array[14]);
+	m.array[14] = -(array[8] * array[12] + array[9] * array[13] + array[10] * array[14]);
+
+	return m;
+}
+
 Vector4 Matrix4::GetRow(unsigned int row) const {
 	Vector4 out(0, 0, 0, 1);
 	if (row <= 3) {
@@ -69,6 +69,14 @@ namespace NCL {
 			void    Invert();
 			Matrix4 Inverse() const;
 
+			//Inverts a matrix whose bottom row is (0,0,0,1) - any mix of rotation, scale
+			//and translation. Only needs a 3x3 inversion, so is much cheaper than Inverse()
+			Matrix4 AffineInverse() const;
+
+			//Inverts a matrix made of only rotation and translation (such as a view matrix)
+			//by transposing the rotation and rotating the negated translation
+			Matrix4 RigidInverse() const;
+
 
 			Vector4 GetRow(unsigned int row) const;
 			Vector4 GetColumn(unsigned int column) const;
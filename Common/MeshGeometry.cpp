@@ -1,106 +1,197 @@
 #include "MeshGeometry.h"
 #include "Assets.h"
+#include "MappedFile.h"
 #include "Vector2.h"
 #include "Vector3.h"
 #include "Vector4.h"
+#include "Matrix3.h"
+#include "Matrix4.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <string>
 
 using namespace NCL;
 using namespace Maths;
 
-MeshGeometry::MeshGeometry()
-{
-	primType	= GeometryPrimitive::Triangles;
-}
-
-enum class GeometryChunkTypes {
-	VPositions		= 1,
-	VNormals		= 2,
-	VTangents		= 4,
-	VColors			= 8,
-	VTex0			= 16,
-	VTex1			= 32,
-	VWeightValues	= 64,
-	VWeightIndices	= 128,
-	Indices			= 256,
-	BindPose		= 512,
-	Material		= 1024
-};
-
-enum class GeometryChunkData {
-	dFloat, //Just float data
-	dShort, //Translate from -32k to 32k to a float
-	dByte,	//Translate from -128 to 127 to a float
-};
-
-void* ReadVertexData(GeometryChunkData dataType, GeometryChunkTypes chunkType, int numVertices) {
-	int numElements = 3;
-
-	if (chunkType == GeometryChunkTypes::VTex0 ||
-		chunkType == GeometryChunkTypes::VTex1) {
-		numElements = 2;
-	}
-	else if (chunkType == GeometryChunkTypes::VColors) {
-		numElements = 4;
+namespace {
+	/*
+	The binary format is a header, a table of chunks, then each chunk's data
+	in the same layout as the vectors MeshGeometry keeps it in, starting on a
+	CHUNK_ALIGNMENT boundary. Everything is little endian, as written by the
+	machines that run the game.
+	*/
+	const char		BINARY_MAGIC[4]		= { 'N', 'M', 'S', 'H' };
+	const uint32_t	BINARY_VERSION		= 1;
+	const uint64_t	CHUNK_ALIGNMENT		= 16;
+
+	struct BinaryMeshHeader {
+		char		magic[4];
+		uint32_t	version;
+		uint32_t	primitiveType;
+		uint32_t	vertexCount;
+		uint32_t	indexCount;
+		uint32_t	chunkCount;
+	};
+
+	struct BinaryMeshChunk {
+		uint32_t	type;		// GeometryChunkTypes
+		uint32_t	dataType;	// GeometryChunkData
+		uint64_t	offset;		// From the start of the file
+		uint64_t	size;
+	};
+
+	struct ChunkLayout {
+		GeometryChunkTypes	type;
+		size_t				elementSize;
+	};
+
+	//In the same order as MeshGeometry::MappedChunk
+	const ChunkLayout CHUNK_LAYOUTS[] = {
+		{ GeometryChunkTypes::VPositions,	sizeof(Vector3)		 },
+		{ GeometryChunkTypes::VNormals,		sizeof(Vector3)		 },
+		{ GeometryChunkTypes::VTangents,	sizeof(Vector3)		 },
+		{ GeometryChunkTypes::VColors,		sizeof(Vector4)		 },
+		{ GeometryChunkTypes::VTex0,		sizeof(Vector2)		 },
+		{ GeometryChunkTypes::Indices,		sizeof(unsigned int) },
+	};
+	const int CHUNK_LAYOUT_COUNT = sizeof(CHUNK_LAYOUTS) / sizeof(ChunkLayout);
+
+	int MappedChunkIndex(GeometryChunkTypes type) {
+		for (int i = 0; i < CHUNK_LAYOUT_COUNT; ++i) {
+			if (CHUNK_LAYOUTS[i].type == type) {
+				return i;
+			}
+		}
+		return -1;
 	}
 
-	int bytesPerElement = 4;
+	template<typename T>
+	void CopyMappedChunk(vector<T>& into, const char* mapped, unsigned int count) {
+		if (into.empty() && mapped) {
+			into.assign((const T*)mapped, (const T*)mapped + count);
+		}
+	}
 
-	if (dataType == GeometryChunkData::dShort) {
-		bytesPerElement = 2;
+	template<typename T>
+	void ReadTextFloats(std::ifstream& file, vector<T>& element, int numVertices, int numFloats) {
+		element.resize(numVertices);
+		for (int i = 0; i < numVertices; ++i) {
+			for (int j = 0; j < numFloats; ++j) {
+				file >> element[i].array[j];
+			}
+		}
 	}
-	else if (dataType == GeometryChunkData::dByte) {
-		bytesPerElement = 1;
+
+	void ReadIndices(std::ifstream& file, vector<unsigned int>& elements, int numIndices) {
+		elements.resize(numIndices);
+		for (int i = 0; i < numIndices; ++i) {
+			file >> elements[i];
+		}
 	}
+}
 
-	char* data = new char[numElements * bytesPerElement];
+MeshGeometry::MeshGeometry()
+{
+	primType			= GeometryPrimitive::Triangles;
+	mappedFile			= nullptr;
+	mappedVertexCount	= 0;
+	mappedIndexCount	= 0;
+	releasedChunks		= 0;
+	boundsDirty			= false;
+	ready				= true;
+	for (int i = 0; i < MAX_MAPPED_CHUNK; ++i) {
+		mappedChunks[i] = nullptr;
+	}
+}
 
-	return data;
+MeshGeometry::MeshGeometry(const std::string&filename) : MeshGeometry() {
+	LoadFile(filename);
 }
 
-void ReadTextFloats(std::ifstream& file, vector<Vector2>& element, int numVertices) {
-	for (size_t i = 0; i < numVertices; ++i) {
-		Vector2 temp;
-		file >> temp.x;
-		file >> temp.y;
-		element.emplace_back(temp);
+/*
+Binary meshes are recognised by their header, so a text .msh can be
+swapped for its converted version without any code changing.
+*/
+bool MeshGeometry::LoadFile(const std::string& filename) {
+	if (!mappedFile) {
+		mappedFile = new MappedFile();
+	}
+	if (!mappedFile->Open(Assets::MESHDIR + filename)) {
+		return false;
+	}
+	if (mappedFile->GetSize() >= sizeof(BINARY_MAGIC) && memcmp(mappedFile->GetData(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+		if (!ReadBinaryMesh()) {
+			std::cout << __FUNCTION__ << " " << filename << " is not a valid binary mesh!" << std::endl;
+			mappedFile->Close();
+			return false;
+		}
+		UpdateBounds(); // Now rather than later, as streamed meshes are loaded off the render thread
+		return true;
 	}
+	mappedFile->Close();
+	bool loaded = ReadTextMesh(Assets::MESHDIR + filename);
+	UpdateBounds();
+	return loaded;
 }
 
-void ReadTextFloats(std::ifstream& file, vector<Vector3>& element, int numVertices) {
-	for (size_t i = 0; i < numVertices; ++i) {
-		Vector3 temp;
-		file >> temp.x;
-		file >> temp.y;
-		file >> temp.z;
-		element.emplace_back(temp);
+void MeshGeometry::UpdateBounds() const {
+	const Vector3*	vertices	= (const Vector3*)GetChunkData(GeometryChunkTypes::VPositions);
+	unsigned int	count		= GetVertexCount();
+	boundsDirty = false;
+	if (!vertices || count == 0) {
+		boundsCentre	= Vector3();
+		boundsHalfSize	= Vector3();
+		return;
+	}
+	Vector3 low		= vertices[0];
+	Vector3 high	= vertices[0];
+	for (unsigned int i = 1; i < count; ++i) {
+		low.x	= std::min(low.x, vertices[i].x);
+		low.y	= std::min(low.y, vertices[i].y);
+		low.z	= std::min(low.z, vertices[i].z);
+		high.x	= std::max(high.x, vertices[i].x);
+		high.y	= std::max(high.y, vertices[i].y);
+		high.z	= std::max(high.z, vertices[i].z);
 	}
+	boundsCentre	= (low + high) * 0.5f;
+	boundsHalfSize	= (high - low) * 0.5f;
 }
 
-void ReadTextFloats(std::ifstream& file, vector<Vector4>& element, int numVertices) {
-	for (size_t i = 0; i < numVertices; ++i) {
-		Vector4 temp;
-		file >> temp.x;
-		file >> temp.y;
-		file >> temp.z;
-		file >> temp.w;
-		element.emplace_back(temp);
-	}
+MeshGeometry::~MeshGeometry()
+{
+	delete mappedFile;
 }
 
-void ReadIndices(std::ifstream& file, vector<unsigned int>& elements, int numIndices) {
-	for (size_t i = 0; i < numIndices; ++i) {
-		unsigned int temp;
-		file >> temp;
-		elements.emplace_back(temp);
+void MeshGeometry::ReleaseCPUData() {
+	if (boundsDirty) {
+		UpdateBounds(); // Last chance, as the positions are about to go
+	}
+	for (int i = 0; i < CHUNK_LAYOUT_COUNT; ++i) {
+		if (GetChunkData(CHUNK_LAYOUTS[i].type)) {
+			releasedChunks |= (int)CHUNK_LAYOUTS[i].type;
+		}
+		mappedChunks[i] = nullptr;
 	}
+	mappedVertexCount	= GetVertexCount();
+	mappedIndexCount	= GetIndexCount();
+
+	vector<Vector3>().swap(positions);
+	vector<Vector2>().swap(texCoords);
+	vector<Vector4>().swap(colours);
+	vector<Vector3>().swap(normals);
+	vector<Vector3>().swap(tangents);
+	vector<unsigned int>().swap(indices);
+
+	delete mappedFile;
+	mappedFile = nullptr;
 }
 
-MeshGeometry::MeshGeometry(const std::string&filename) {
-	primType = GeometryPrimitive::Triangles;
-	std::ifstream file(Assets::MESHDIR + filename);
+bool MeshGeometry::ReadTextMesh(const std::string& filename) {
+	std::ifstream file(filename);
 
 	std::string filetype;
 	int fileVersion;
@@ -109,14 +200,14 @@ MeshGeometry::MeshGeometry(const std::string&filename) {
 
 	if (filetype != "MeshGeometry") {
 		std::cout << "File is not a MeshGeometry file!" << std::endl;
-		return;
+		return false;
 	}
 
 	file >> fileVersion;
 
 	if (fileVersion != 1) {
 		std::cout << "MeshGeometry file has incompatible version!" << std::endl;
-		return;
+		return false;
 	}
 
 	int numMeshes	= 0; //read
@@ -128,32 +219,151 @@ MeshGeometry::MeshGeometry(const std::string&filename) {
 	file >> numVertices;
 	file >> numIndices;
 	file >> numChunks;
-	
-	for (size_t i = 0; i < numChunks; ++i) {
+
+	for (int i = 0; i < numChunks; ++i) {
 		int chunkType = (int)GeometryChunkTypes::VPositions;
 
 		file >> chunkType;
 
 		switch ((GeometryChunkTypes)chunkType) {
-			case GeometryChunkTypes::VPositions:ReadTextFloats(file, positions, numVertices);  break;
-			case GeometryChunkTypes::VColors:	ReadTextFloats(file, colours, numVertices);  break;
-			case GeometryChunkTypes::VNormals:	ReadTextFloats(file, normals, numVertices);  break;
-			case GeometryChunkTypes::VTangents:	ReadTextFloats(file, tangents, numVertices);  break;
-			case GeometryChunkTypes::VTex0:		ReadTextFloats(file, texCoords, numVertices);  break;
+			case GeometryChunkTypes::VPositions:ReadTextFloats(file, positions, numVertices, 3);  break;
+			case GeometryChunkTypes::VColors:	ReadTextFloats(file, colours, numVertices, 4);  break;
+			case GeometryChunkTypes::VNormals:	ReadTextFloats(file, normals, numVertices, 3);  break;
+			case GeometryChunkTypes::VTangents:	ReadTextFloats(file, tangents, numVertices, 3);  break;
+			case GeometryChunkTypes::VTex0:		ReadTextFloats(file, texCoords, numVertices, 2);  break;
 			//case GeometryChunkTypes::VTex1:ReadTextFloats(file, positions, numVertices);  break;
 			//case GeometryChunkTypes::VWeightValues:		ReadTextFloats(file, positions, numVertices);  break;
 			//case GeometryChunkTypes::VWeightIndices:	ReadTextFloats(file, positions, numVertices);  break;
 			case GeometryChunkTypes::Indices:	ReadIndices(file, indices, numIndices); break;
 		}
 	}
+	return true;
 }
 
-MeshGeometry::~MeshGeometry()
-{
+/*
+Nothing is copied - each chunk is just pointed at where it sits in the
+mapped file, once it's been checked to lie inside it.
+*/
+bool MeshGeometry::ReadBinaryMesh() {
+	const char* data = mappedFile->GetData();
+	size_t		size = mappedFile->GetSize();
+
+	BinaryMeshHeader header;
+	if (size < sizeof(header)) {
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (header.version != BINARY_VERSION ||
+		size < sizeof(header) + (uint64_t)header.chunkCount * sizeof(BinaryMeshChunk)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < header.chunkCount; ++i) {
+		BinaryMeshChunk chunk;
+		memcpy(&chunk, data + sizeof(header) + i * sizeof(BinaryMeshChunk), sizeof(chunk));
+
+		int index = MappedChunkIndex((GeometryChunkTypes)chunk.type);
+		if (index < 0) {
+			continue; // Padding, or something we don't keep
+		}
+		uint64_t count = (chunk.type == (uint32_t)GeometryChunkTypes::Indices) ? header.indexCount : header.vertexCount;
+		if (chunk.dataType != (uint32_t)GeometryChunkData::dFloat ||
+			chunk.size != count * CHUNK_LAYOUTS[index].elementSize ||
+			chunk.offset % CHUNK_ALIGNMENT != 0 || chunk.offset + chunk.size > size) {
+			return false;
+		}
+		mappedChunks[index] = data + chunk.offset;
+	}
+	primType			= (GeometryPrimitive)header.primitiveType;
+	mappedVertexCount	= header.vertexCount;
+	mappedIndexCount	= header.indexCount;
+	return true;
 }
 
+bool MeshGeometry::SaveBinary(const std::string& filename) const {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	//The table always has room for every chunk, so the data offsets can be worked out up front
+	BinaryMeshChunk chunks[CHUNK_LAYOUT_COUNT] = {};
+	uint32_t		chunkCount = 0;
+
+	uint64_t offset = sizeof(BinaryMeshHeader) + sizeof(chunks);
+	for (int i = 0; i < CHUNK_LAYOUT_COUNT; ++i) {
+		if (!HasChunk(CHUNK_LAYOUTS[i].type)) {
+			continue;
+		}
+		uint64_t count = (CHUNK_LAYOUTS[i].type == GeometryChunkTypes::Indices) ? GetIndexCount() : GetVertexCount();
+		offset = (offset + CHUNK_ALIGNMENT - 1) & ~(CHUNK_ALIGNMENT - 1);
+
+		BinaryMeshChunk& chunk	= chunks[chunkCount++];
+		chunk.type		= (uint32_t)CHUNK_LAYOUTS[i].type;
+		chunk.dataType	= (uint32_t)GeometryChunkData::dFloat;
+		chunk.offset	= offset;
+		chunk.size		= count * CHUNK_LAYOUTS[i].elementSize;
+		offset += chunk.size;
+	}
+	BinaryMeshHeader header;
+	memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	header.version			= BINARY_VERSION;
+	header.primitiveType	= (uint32_t)primType;
+	header.vertexCount		= GetVertexCount();
+	header.indexCount		= GetIndexCount();
+	header.chunkCount		= CHUNK_LAYOUT_COUNT;
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)chunks, sizeof(chunks));
+
+	const char	padding[CHUNK_ALIGNMENT] = { 0 };
+	uint64_t	written = sizeof(header) + sizeof(chunks);
+	for (uint32_t i = 0; i < chunkCount; ++i) {
+		file.write(padding, chunks[i].offset - written);
+		file.write((const char*)GetChunkData((GeometryChunkTypes)chunks[i].type), chunks[i].size);
+		written = chunks[i].offset + chunks[i].size;
+	}
+	return (bool)file;
+}
+
+const void* MeshGeometry::GetChunkData(GeometryChunkTypes type) const {
+	const void* data = nullptr;
+	switch (type) {
+		case GeometryChunkTypes::VPositions:	data = positions.empty()	? nullptr : positions.data();	break;
+		case GeometryChunkTypes::VNormals:		data = normals.empty()		? nullptr : normals.data();		break;
+		case GeometryChunkTypes::VTangents:		data = tangents.empty()		? nullptr : tangents.data();	break;
+		case GeometryChunkTypes::VColors:		data = colours.empty()		? nullptr : colours.data();		break;
+		case GeometryChunkTypes::VTex0:			data = texCoords.empty()	? nullptr : texCoords.data();	break;
+		case GeometryChunkTypes::Indices:		data = indices.empty()		? nullptr : indices.data();		break;
+		default: return nullptr;
+	}
+	return data ? data : mappedChunks[MappedChunkIndex(type)];
+}
+
+/*
+Binary meshes keep their vertices in the mapped file, so those that are
+about to change are copied out first - from then on, the vectors take
+precedence over the mapping. Normals go through the inverse transpose, so
+that they stay perpendicular to the surface under a non-uniform scale.
+*/
 void	MeshGeometry::TransformVertices(const Matrix4& byMatrix) {
+	CopyMappedChunk(positions,	mappedChunks[MAPPED_POSITIONS], mappedVertexCount);
+	CopyMappedChunk(normals,	mappedChunks[MAPPED_NORMALS],	mappedVertexCount);
+	CopyMappedChunk(tangents,	mappedChunks[MAPPED_TANGENTS],	mappedVertexCount);
 
+	for (Vector3& p : positions) {
+		p = byMatrix * p;
+	}
+	Matrix3 normalMatrix = Matrix3(byMatrix.AffineInverse()).Transposed();
+	for (Vector3& n : normals) {
+		n = normalMatrix * n;
+		n.Normalise();
+	}
+	Matrix3 tangentMatrix = Matrix3(byMatrix);
+	for (Vector3& t : tangents) {
+		t = tangentMatrix * t;
+		t.Normalise();
+	}
+	boundsDirty = true;
 }
 
 void	MeshGeometry::RecalculateNormals() {
@@ -165,7 +375,8 @@ void	MeshGeometry::RecalculateTangents() {
 }
 
 void MeshGeometry::SetVertexPositions(const vector<Vector3>& newVerts) {
-	positions = newVerts;
+	positions	= newVerts;
+	boundsDirty = true;
 }
 
 void MeshGeometry::SetVertexTextureCoords(const vector<Vector2>& newTex) {
@@ -186,4 +397,17 @@ void MeshGeometry::SetVertexTangents(const vector<Vector3>& newTans) {
 
 void MeshGeometry::SetVertexIndices(const vector<unsigned int>& newIndices) {
 	indices = newIndices;
+}
+
+void MeshGeometry::SetVertexPositions(const Vector3* newVerts, size_t count) {
+	positions.assign(newVerts, newVerts + count);
+	boundsDirty = true;
+}
+
+void MeshGeometry::SetVertexTextureCoords(const Vector2* newTex, size_t count) {
+	texCoords.assign(newTex, newTex + count);
+}
+
+void MeshGeometry::SetVertexColours(const Vector4* newColours, size_t count) {
+	colours.assign(newColours, newColours + count);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Vector2.h"
 #include "Vector3.h"
 #include "Vector4.h"
+#include <string>
 using std::vector;
 
 namespace NCL {
@@ -13,6 +14,7 @@ namespace NCL {
 		class Matrix4;
 	}
 	using namespace Maths;
+	class MappedFile;
 
 	enum class GeometryPrimitive {
 		Points,
@@ -23,11 +25,35 @@ namespace NCL {
 		Patches
 	};
 
+	enum class GeometryChunkTypes {
+		VPositions		= 1,
+		VNormals		= 2,
+		VTangents		= 4,
+		VColors			= 8,
+		VTex0			= 16,
+		VTex1			= 32,
+		VWeightValues	= 64,
+		VWeightIndices	= 128,
+		Indices			= 256,
+		BindPose		= 512,
+		Material		= 1024
+	};
+
+	enum class GeometryChunkData {
+		dFloat, //Just float data
+		dShort, //Translate from -32k to 32k to a float
+		dByte,	//Translate from -128 to 127 to a float
+	};
+
 	class MeshGeometry
 	{
 	public:		
 		virtual ~MeshGeometry();
 
+		//A copy would share the mapped file with the original, and both would unmap it
+		MeshGeometry(const MeshGeometry&) = delete;
+		MeshGeometry& operator=(const MeshGeometry&) = delete;
+
 		GeometryPrimitive GetPrimitiveType() const {
 			return primType;
 		}
@@ -37,11 +63,38 @@ namespace NCL {
 		}
 
 		unsigned int GetVertexCount() const {
-			return (unsigned int)positions.size();
+			return positions.empty() ? mappedVertexCount : (unsigned int)positions.size();
 		}
 
 		unsigned int GetIndexCount()  const {
-			return (unsigned int)indices.size();
+			return indices.empty() ? mappedIndexCount : (unsigned int)indices.size();
+		}
+
+		/*
+		Meshes loaded from binary files leave their vertex data in the mapped
+		file rather than copying it into the vectors below, so anything that
+		just wants the raw data to upload should ask for it through here.
+		Returns nullptr if the mesh doesn't have that chunk, or if its data has
+		been released - HasChunk still knows about released chunks.
+		*/
+		const void* GetChunkData(GeometryChunkTypes type) const;
+		bool HasChunk(GeometryChunkTypes type) const {
+			return GetChunkData(type) != nullptr || (releasedChunks & (int)type) != 0;
+		}
+
+		/*
+		An object space box around the vertex positions. Changing them just
+		marks it out of date, and it's worked out again the next time it's
+		asked for - so a mesh whose positions change must not have its bounds
+		read from several threads at once.
+		*/
+		Vector3 GetBoundsCentre() const {
+			if (boundsDirty) { UpdateBounds(); }
+			return boundsCentre;
+		}
+		Vector3 GetBoundsHalfSize() const {
+			if (boundsDirty) { UpdateBounds(); }
+			return boundsHalfSize;
 		}
 
 		const vector<Vector3>&		GetPositionData()		const { return positions;	}
@@ -59,6 +112,11 @@ namespace NCL {
 		void SetVertexTangents(const vector<Vector3>& newTans);
 		void SetVertexIndices(const vector<unsigned int>& newIndices);
 
+		//For filling from containers that aren't std::vectors, without a temporary copy
+		void SetVertexPositions(const Vector3* newVerts, size_t count);
+		void SetVertexTextureCoords(const Vector2* newTex, size_t count);
+		void SetVertexColours(const Vector4* newColours, size_t count);
+
 
 		void	TransformVertices(const Matrix4& byMatrix);
 
@@ -67,10 +125,32 @@ namespace NCL {
 
 		virtual void UploadToGPU() = 0;
 
+		/*
+		For meshes that are only ever drawn - throws away the vertex data kept
+		on the CPU side, whether that's in the vectors or the mapped file, once
+		it has been uploaded. The counts, the bounds, and which chunks the mesh
+		had are all kept.
+		*/
+		void ReleaseCPUData();
+
+		/*
+		False while a streamed mesh is still being read in or is waiting to be
+		uploaded - until then, nothing but the AssetManager should touch it.
+		*/
+		bool IsReady() const { return ready; }
+
+		//Writes the mesh out in the binary format, which the filename constructor will then map
+		bool SaveBinary(const std::string& filename) const;
+
 	protected:
+		friend class AssetManager;
+
 		MeshGeometry();
 		MeshGeometry(const std::string&filename);
 
+		//Doesn't touch the GPU, so streamed meshes are read in on the AssetManager's thread
+		bool LoadFile(const std::string& filename);
+
 		GeometryPrimitive	primType;
 		vector<Vector3>		positions;
 
@@ -79,5 +159,26 @@ namespace NCL {
 		vector<Vector3>		normals;
 		vector<Vector3>		tangents;
 		vector<unsigned int>	indices;
+
+		bool ReadTextMesh(const std::string& filename);
+		bool ReadBinaryMesh();
+		void UpdateBounds() const;
+
+		mutable Vector3		boundsCentre;
+		mutable Vector3		boundsHalfSize;
+		mutable bool		boundsDirty;
+
+		enum MappedChunk {
+			MAPPED_POSITIONS, MAPPED_NORMALS, MAPPED_TANGENTS,
+			MAPPED_COLOURS, MAPPED_TEXCOORDS, MAPPED_INDICES, MAX_MAPPED_CHUNK
+		};
+
+		MappedFile*		mappedFile;
+		const char*		mappedChunks[MAX_MAPPED_CHUNK];
+		unsigned int	mappedVertexCount;
+		unsigned int	mappedIndexCount;
+		int				releasedChunks;	// GeometryChunkTypes flags
+
+		bool			ready;
 	};
 }
\ No newline at end of file
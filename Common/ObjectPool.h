@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <new>
+
+namespace NCL {
+	/*
+	A typed pool allocator. Objects are constructed in place inside fixed size
+	blocks, so objects of the same type end up sitting next to each other in
+	memory, and freed slots are reused through a free list rather than going
+	back to the heap. ReleaseAll destroys everything still alive in one go,
+	but keeps the blocks around, so the next 'level' reuses the same memory.
+	*/
+	template<class T>
+	class ObjectPool {
+	public:
+		ObjectPool(size_t objectsPerBlock = 64) {
+			blockSize	= objectsPerBlock > 0 ? objectsPerBlock : 1;
+			freeList	= nullptr;
+			liveCount	= 0;
+		}
+
+		//Copies would both destroy the same objects and delete the same blocks
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		~ObjectPool() {
+			ReleaseAll();
+			for (Slot* b : blocks) {
+				delete[] b;
+			}
+		}
+
+		template<typename... Args>
+		T* Allocate(Args&&... args) {
+			if (!freeList) {
+				AddBlock();
+			}
+			Slot* s		= freeList;
+			freeList	= s->next;
+
+			T* object	= new (s->storage) T(std::forward<Args>(args)...);
+			s->live		= true;
+			liveCount++;
+			return object;
+		}
+
+		void Free(T* object) {
+			if (!object) {
+				return;
+			}
+			Slot* s = (Slot*)object;
+			object->~T();
+			s->live		= false;
+			s->next		= freeList;
+			freeList	= s;
+			liveCount--;
+		}
+
+		//Destroys every live object, and rebuilds the free list over all of the blocks
+		void ReleaseAll() {
+			freeList = nullptr;
+			for (size_t b = blocks.size(); b > 0; --b) {
+				Slot* block = blocks[b - 1];
+				for (size_t i = blockSize; i > 0; --i) {
+					Slot& s = block[i - 1];
+					if (s.live) {
+						((T*)s.storage)->~T();
+						s.live = false;
+					}
+					s.next		= freeList;
+					freeList	= &s;
+				}
+			}
+			liveCount = 0;
+		}
+
+		bool Owns(const T* object) const {
+			const char* p = (const char*)object;
+			for (const Slot* b : blocks) {
+				if (p >= (const char*)b && p < (const char*)(b + blockSize)) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		size_t GetLiveCount()		const { return liveCount; }
+		size_t GetCapacity()		const { return blocks.size() * blockSize; }
+
+	protected:
+		struct Slot {
+			alignas(T) unsigned char storage[sizeof(T)]; //Must stay first, so a T* is also a Slot*
+			Slot*	next;
+			bool	live;
+		};
+
+		void AddBlock() {
+			Slot* block = new Slot[blockSize];
+			for (size_t i = blockSize; i > 0; --i) {
+				block[i - 1].live = false;
+				block[i - 1].next = freeList;
+				freeList = &block[i - 1];
+			}
+			blocks.emplace_back(block);
+		}
+
+		std::vector<Slot*>	blocks;
+		Slot*				freeList;
+		size_t				blockSize;
+		size_t				liveCount;
+	};
+}
@@ -0,0 +1,373 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "OcclusionCuller.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define OCCLUSION_SSE
+#endif
+
+using namespace NCL;
+using namespace NCL::Maths;
+
+namespace {
+	//Rows of the depth buffer given to each rasterising job
+	const int BAND_HEIGHT = 16;
+
+	//Bounds are tested against the level where they cover at most this many cells across
+	const int TEST_CELLS = 4;
+
+	//Wound anticlockwise when seen from outside the box
+	const int BOX_FACES[6][4] = {
+		{ 0, 1, 3, 2 },	// -x
+		{ 4, 6, 7, 5 },	// +x
+		{ 0, 4, 5, 1 },	// -y
+		{ 2, 3, 7, 6 },	// +y
+		{ 0, 2, 6, 4 },	// -z
+		{ 1, 5, 7, 3 }	// +z
+	};
+
+	Vector4 Lerp(const Vector4& a, const Vector4& b, float t) {
+		return Vector4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+	}
+
+	Vector4 Transform(const Matrix4& m, const Vector3& v) {
+		const float* a = m.array;
+		return Vector4(a[0] * v.x + a[4] * v.y + a[8]  * v.z + a[12],
+					   a[1] * v.x + a[5] * v.y + a[9]  * v.z + a[13],
+					   a[2] * v.x + a[6] * v.y + a[10] * v.z + a[14],
+					   a[3] * v.x + a[7] * v.y + a[11] * v.z + a[15]);
+	}
+}
+
+OcclusionCuller::OcclusionCuller(int w, int h) {
+	width	= (std::max(w, 4) + 3) & ~3;
+	height	= std::max(h, 1);
+
+	int levelWidth	= width;
+	int levelHeight = height;
+	while (true) {
+		Level level;
+		level.width		= levelWidth;
+		level.height	= levelHeight;
+		level.maxDepth.resize((size_t)levelWidth * levelHeight, 1.0f);
+		levels.emplace_back(std::move(level));
+		if (levelWidth == 1 && levelHeight == 1) {
+			break;
+		}
+		levelWidth	= (levelWidth  + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+	}
+}
+
+OcclusionCuller::~OcclusionCuller() {
+}
+
+void OcclusionCuller::Clear(const Matrix4& newViewProj) {
+	viewProj = newViewProj;
+	polygons.clear();
+	std::fill(levels[0].maxDepth.begin(), levels[0].maxDepth.end(), 1.0f);
+}
+
+void OcclusionCuller::AddOccluder(const Matrix4& modelMatrix, const Vector3& centre, const Vector3& halfSize) {
+	Matrix4 mvp = viewProj * modelMatrix;
+	Vector4 corners[8];
+	for (int i = 0; i < 8; ++i) {
+		Vector3 corner(centre.x + ((i & 4) ? halfSize.x : -halfSize.x),
+					   centre.y + ((i & 2) ? halfSize.y : -halfSize.y),
+					   centre.z + ((i & 1) ? halfSize.z : -halfSize.z));
+		corners[i] = Transform(mvp, corner);
+	}
+	for (int i = 0; i < 6; ++i) {
+		Vector4 face[4] = { corners[BOX_FACES[i][0]], corners[BOX_FACES[i][1]], corners[BOX_FACES[i][2]], corners[BOX_FACES[i][3]] };
+		AddClipPolygon(face, 4);
+	}
+}
+
+/*
+Polygons wholly outside one of the side planes are dropped, and those
+crossing the near plane are clipped against it, which adds at most one
+vertex.
+*/
+void OcclusionCuller::AddClipPolygon(const Vector4* vertices, int count) {
+	int outside[5] = { 0 };
+	for (int i = 0; i < count; ++i) {
+		const Vector4& v = vertices[i];
+		outside[0] += v.x >  v.w;
+		outside[1] += v.x < -v.w;
+		outside[2] += v.y >  v.w;
+		outside[3] += v.y < -v.w;
+		outside[4] += v.z >  v.w;
+	}
+	for (int i = 0; i < 5; ++i) {
+		if (outside[i] == count) {
+			return;
+		}
+	}
+	Vector4 clipped[MAX_POLYGON_VERTICES];
+	int		clippedCount = 0;
+	for (int i = 0; i < count; ++i) {
+		const Vector4& from = vertices[i];
+		const Vector4& to	= vertices[(i + 1) % count];
+		float fromDist	= from.z + from.w;
+		float toDist	= to.z + to.w;
+		if (fromDist >= 0.0f) {
+			clipped[clippedCount++] = from;
+		}
+		if ((fromDist >= 0.0f) != (toDist >= 0.0f)) {
+			clipped[clippedCount++] = Lerp(from, to, fromDist / (fromDist - toDist));
+		}
+	}
+	if (clippedCount >= 3) {
+		AddScreenPolygon(clipped, clippedCount);
+	}
+}
+
+void OcclusionCuller::AddScreenPolygon(const Vector4* vertices, int count) {
+	ScreenPolygon p;
+	p.count = count;
+	float minY = (float)height;
+	float maxY = 0.0f;
+	float area = 0.0f;
+	for (int i = 0; i < count; ++i) {
+		float invW = 1.0f / std::max(vertices[i].w, 1e-6f);
+		p.x[i] = (vertices[i].x * invW * 0.5f + 0.5f) * width;
+		p.y[i] = (vertices[i].y * invW * 0.5f + 0.5f) * height;
+		p.z[i] = vertices[i].z * invW * 0.5f + 0.5f;
+		minY = std::min(minY, p.y[i]);
+		maxY = std::max(maxY, p.y[i]);
+	}
+	for (int i = 0; i < count; ++i) {
+		int j = (i + 1) % count;
+		area += p.x[i] * p.y[j] - p.x[j] * p.y[i];
+	}
+	//Only faces turned towards the camera are needed to cover an occluder, and
+	//dropping the rest stops a camera that's inside one from being blinded by it
+	if (area < 1e-6f) {
+		return;
+	}
+	p.minY = std::max(0, (int)floorf(minY));
+	p.maxY = std::min(height - 1, (int)ceilf(maxY));
+	if (p.minY > p.maxY) {
+		return;
+	}
+	polygons.emplace_back(p);
+}
+
+void OcclusionCuller::Rasterise(JobSystem* jobs) {
+	int bands = (height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+	auto rasteriseBands = [&](size_t begin, size_t end) {
+		RasteriseRows((int)begin * BAND_HEIGHT, std::min((int)end * BAND_HEIGHT, height) - 1);
+	};
+	if (jobs) {
+		jobs->ParallelFor(bands, 1, rasteriseBands);
+	}
+	else {
+		rasteriseBands(0, bands);
+	}
+	for (size_t i = 1; i < levels.size(); ++i) {
+		auto reduce = [&](size_t begin, size_t end) {
+			ReduceRows((int)i, (int)begin, (int)end - 1);
+		};
+		if (jobs) {
+			jobs->ParallelFor(levels[i].height, BAND_HEIGHT, reduce);
+		}
+		else {
+			reduce(0, levels[i].height);
+		}
+	}
+}
+
+/*
+Each edge is a function that's positive on the inside of the polygon.
+Offsetting it by half a pixel's extent along its normal makes it positive
+only where the whole pixel is inside, and the depth plane is offset the
+same way, to the farthest the polygon gets within the pixel.
+*/
+void OcclusionCuller::RasteriseRows(int firstRow, int lastRow) {
+	float* depth = levels[0].maxDepth.data();
+
+	for (const ScreenPolygon& p : polygons) {
+		int rowBegin	= std::max(p.minY, firstRow);
+		int rowEnd		= std::min(p.maxY, lastRow);
+		if (rowBegin > rowEnd) {
+			continue;
+		}
+		float edgeA[MAX_POLYGON_VERTICES];
+		float edgeB[MAX_POLYGON_VERTICES];
+		float edgeC[MAX_POLYGON_VERTICES];
+		float minX = (float)width;
+		float maxX = 0.0f;
+		for (int i = 0; i < p.count; ++i) {
+			int j = (i + 1) % p.count;
+			edgeA[i] = p.y[i] - p.y[j];
+			edgeB[i] = p.x[j] - p.x[i];
+			edgeC[i] = p.x[i] * p.y[j] - p.x[j] * p.y[i] - 0.5f * (fabsf(edgeA[i]) + fabsf(edgeB[i]));
+			minX = std::min(minX, p.x[i]);
+			maxX = std::max(maxX, p.x[i]);
+		}
+		//The polygon is flat, so its depth plane comes from whichever fan triangle is largest
+		int		apex = 1;
+		float	area = 0.0f;
+		for (int i = 1; i + 1 < p.count; ++i) {
+			float a = (p.x[i] - p.x[0]) * (p.y[i + 1] - p.y[0]) - (p.x[i + 1] - p.x[0]) * (p.y[i] - p.y[0]);
+			if (a > area) {
+				area = a;
+				apex = i;
+			}
+		}
+		if (area <= 0.0f) {
+			continue;
+		}
+		float dx1 = p.x[apex] - p.x[0],		dy1 = p.y[apex] - p.y[0],		dz1 = p.z[apex] - p.z[0];
+		float dx2 = p.x[apex + 1] - p.x[0], dy2 = p.y[apex + 1] - p.y[0],	dz2 = p.z[apex + 1] - p.z[0];
+		float zA = (dz1 * dy2 - dz2 * dy1) / area;
+		float zB = (dz2 * dx1 - dz1 * dx2) / area;
+		float zC = p.z[0] - zA * p.x[0] - zB * p.y[0] + 0.5f * (fabsf(zA) + fabsf(zB));
+
+		int colBegin	= std::max(0, (int)floorf(minX)) & ~3;
+		int colEnd		= std::min(width - 1, (int)ceilf(maxX));
+
+		for (int y = rowBegin; y <= rowEnd; ++y) {
+			float	cy	= y + 0.5f;
+			float*	row = depth + (size_t)y * width;
+#ifdef OCCLUSION_SSE
+			const __m128 laneX	= _mm_set_ps(colBegin + 3.5f, colBegin + 2.5f, colBegin + 1.5f, colBegin + 0.5f);
+			const __m128 zero	= _mm_setzero_ps();
+			__m128 rowE[MAX_POLYGON_VERTICES];
+			__m128 stepE[MAX_POLYGON_VERTICES];
+			for (int i = 0; i < p.count; ++i) {
+				rowE[i]		= _mm_add_ps(_mm_set1_ps(edgeB[i] * cy + edgeC[i]), _mm_mul_ps(_mm_set1_ps(edgeA[i]), laneX));
+				stepE[i]	= _mm_set1_ps(edgeA[i] * 4.0f);
+			}
+			__m128 rowZ		= _mm_add_ps(_mm_set1_ps(zB * cy + zC), _mm_mul_ps(_mm_set1_ps(zA), laneX));
+			__m128 stepZ	= _mm_set1_ps(zA * 4.0f);
+
+			for (int x = colBegin; x <= colEnd; x += 4) {
+				__m128 inside = _mm_cmpge_ps(rowE[0], zero);
+				for (int i = 1; i < p.count; ++i) {
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(rowE[i], zero));
+				}
+				if (_mm_movemask_ps(inside)) {
+					__m128 old		= _mm_loadu_ps(row + x);
+					__m128 nearer	= _mm_min_ps(old, rowZ);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+				}
+				for (int i = 0; i < p.count; ++i) {
+					rowE[i] = _mm_add_ps(rowE[i], stepE[i]);
+				}
+				rowZ = _mm_add_ps(rowZ, stepZ);
+			}
+#else
+			for (int x = colBegin; x <= colEnd; ++x) {
+				float cx		= x + 0.5f;
+				bool  inside	= true;
+				for (int i = 0; i < p.count && inside; ++i) {
+					inside = edgeA[i] * cx + edgeB[i] * cy + edgeC[i] >= 0.0f;
+				}
+				if (inside) {
+					row[x] = std::min(row[x], zA * cx + zB * cy + zC);
+				}
+			}
+#endif
+		}
+	}
+}
+
+void OcclusionCuller::ReduceRows(int level, int firstRow, int lastRow) {
+	const Level&	from	= levels[level - 1];
+	Level&			to		= levels[level];
+	const float*	fromMax = from.maxDepth.data();
+
+	for (int y = firstRow; y <= lastRow; ++y) {
+		int y0 = y * 2;
+		int y1 = std::min(y0 + 1, from.height - 1);
+		for (int x = 0; x < to.width; ++x) {
+			int x0 = x * 2;
+			int x1 = std::min(x0 + 1, from.width - 1);
+			size_t a = (size_t)y0 * from.width + x0;
+			size_t b = (size_t)y0 * from.width + x1;
+			size_t c = (size_t)y1 * from.width + x0;
+			size_t d = (size_t)y1 * from.width + x1;
+			to.maxDepth[(size_t)y * to.width + x] = std::max(std::max(fromMax[a], fromMax[b]), std::max(fromMax[c], fromMax[d]));
+		}
+	}
+}
+
+/*
+Hidden only if the nearest point of the box is behind the farthest
+occluder depth everywhere its screen rectangle touches. Boxes reaching
+through the near plane are always visible.
+*/
+bool OcclusionCuller::IsVisible(const Vector3& centre, const Vector3& halfSize) const {
+	float minX		= (float)width;
+	float minY		= (float)height;
+	float maxX		= 0.0f;
+	float maxY		= 0.0f;
+	float nearest	= 1.0f;
+	for (int i = 0; i < 8; ++i) {
+		Vector3 corner(centre.x + ((i & 4) ? halfSize.x : -halfSize.x),
+					   centre.y + ((i & 2) ? halfSize.y : -halfSize.y),
+					   centre.z + ((i & 1) ? halfSize.z : -halfSize.z));
+		Vector4 clip = Transform(viewProj, corner);
+		if (clip.w <= 1e-6f || clip.z < -clip.w) {
+			return true;
+		}
+		float invW	= 1.0f / clip.w;
+		float x		= (clip.x * invW * 0.5f + 0.5f) * width;
+		float y		= (clip.y * invW * 0.5f + 0.5f) * height;
+		minX	= std::min(minX, x);
+		minY	= std::min(minY, y);
+		maxX	= std::max(maxX, x);
+		maxY	= std::max(maxY, y);
+		nearest = std::min(nearest, clip.z * invW * 0.5f + 0.5f);
+	}
+	int x0 = std::max(0, (int)floorf(minX));
+	int y0 = std::max(0, (int)floorf(minY));
+	int x1 = std::min(width  - 1, (int)floorf(maxX));
+	int y1 = std::min(height - 1, (int)floorf(maxY));
+	if (x0 > x1 || y0 > y1) {
+		return true; //Off screen - that's for frustum culling to decide
+	}
+	int level = 0;
+	while (level + 1 < (int)levels.size() && (((x1 >> level) - (x0 >> level)) >= TEST_CELLS || ((y1 >> level) - (y0 >> level)) >= TEST_CELLS)) {
+		level++;
+	}
+	const Level& l = levels[level];
+	for (int y = y0 >> level; y <= (y1 >> level); ++y) {
+		for (int x = x0 >> level; x <= (x1 >> level); ++x) {
+			if (nearest <= l.maxDepth[(size_t)y * l.width + x]) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void OcclusionCuller::CullBoxes(const BoxList& boxes, uint8_t* visible, JobSystem* jobs) const {
+	auto test = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (visible[i]) {
+				Vector3 centre(boxes.centreX[i], boxes.centreY[i], boxes.centreZ[i]);
+				Vector3 half(boxes.halfX[i], boxes.halfY[i], boxes.halfZ[i]);
+				visible[i] = IsVisible(centre, half) ? 1 : 0;
+			}
+		}
+	};
+	if (jobs) {
+		jobs->ParallelFor(boxes.Size(), 256, test);
+	}
+	else {
+		test(0, boxes.Size());
+	}
+}
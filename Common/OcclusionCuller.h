@@ -0,0 +1,107 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include "Frustum.h"
+#include "Matrix4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace NCL {
+	class JobSystem;
+
+	namespace Maths {
+		/*
+		Software occlusion culling, entirely on the CPU. A handful of big,
+		simple occluders (boxes, for now) are rasterised into a small depth
+		buffer, which is then reduced into a pyramid of ever coarser levels,
+		each cell keeping the farthest depth beneath it. Object bounds are
+		tested against whichever level lets their screen area be covered by a
+		few cells.
+
+		Only the farthest depth is kept, as that's all the test needs - a box
+		is visible as soon as it's in front of the farthest depth of any cell
+		it covers, which it always is if it's in front of the nearest.
+
+		Occluders are drawn as convex polygons, only where they cover a whole
+		depth buffer pixel, at the farthest depth they reach inside it, so an object is
+		never hidden by an occluder that doesn't really hide it.
+
+		Nothing here needs a GL context, so it can be run and checked
+		headlessly. Rasterising and testing are split across a JobSystem, if
+		given one: the depth buffer in horizontal bands, and the bounds in
+		chunks.
+		*/
+		class OcclusionCuller {
+		public:
+			//Width is rounded up to a multiple of 4, as pixels are done 4 at a time
+			OcclusionCuller(int width = 256, int height = 128);
+			~OcclusionCuller();
+
+			//Empties the depth buffer, and sets the view for everything that follows
+			void Clear(const Matrix4& viewProj);
+
+			//A box in object space, such as a mesh's bounds, placed by modelMatrix
+			void AddOccluder(const Matrix4& modelMatrix, const Vector3& centre, const Vector3& halfSize);
+
+			//Draws every occluder added since Clear, then builds the hierarchy
+			void Rasterise(JobSystem* jobs = nullptr);
+
+			//World space axis aligned bounds
+			bool IsVisible(const Vector3& centre, const Vector3& halfSize) const;
+
+			//Only boxes with a non-zero visible entry are tested, and those found hidden are zeroed
+			void CullBoxes(const BoxList& boxes, uint8_t* visible, JobSystem* jobs = nullptr) const;
+
+			int GetWidth()	const { return width;	}
+			int GetHeight() const { return height;	}
+
+			//0 is the near plane and 1 the far plane, with row 0 at the bottom of the screen
+			const float* GetDepthBuffer() const {
+				return levels[0].maxDepth.data();
+			}
+
+			size_t GetPolygonCount() const {
+				return polygons.size();
+			}
+
+		protected:
+			//Box faces are kept whole, as splitting them leaves a crack along the diagonal
+			static const int MAX_POLYGON_VERTICES = 5;
+
+			struct ScreenPolygon {
+				float	x[MAX_POLYGON_VERTICES];
+				float	y[MAX_POLYGON_VERTICES];
+				float	z[MAX_POLYGON_VERTICES];
+				int		count;
+				int		minY;
+				int		maxY;
+			};
+
+			struct Level {
+				int					width;
+				int					height;
+				std::vector<float>	maxDepth;
+			};
+
+			void AddClipPolygon(const Vector4* vertices, int count);
+			void AddScreenPolygon(const Vector4* vertices, int count);
+			void RasteriseRows(int firstRow, int lastRow);
+			void ReduceRows(int level, int firstRow, int lastRow);
+
+			int						width;
+			int						height;
+			Matrix4					viewProj;
+			std::vector<ScreenPolygon>	polygons;
+			std::vector<Level>		levels;	// levels[0] is the depth buffer itself
+		};
+	}
+}
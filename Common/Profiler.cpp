@@ -0,0 +1,170 @@
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <cstring>
+#include <iostream>
+
+using namespace NCL;
+
+std::mutex							Profiler::threadLock;
+std::vector<Profiler::ThreadEvents*>	Profiler::threads;
+std::vector<Profiler::ScopeHistory>	Profiler::histories;
+unsigned int						Profiler::frameIndex = 0;
+
+static const std::chrono::steady_clock::time_point profilerEpoch = std::chrono::steady_clock::now();
+
+uint64_t Profiler::Now() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profilerEpoch).count();
+}
+
+/*
+Each thread gets its events buffer the first time it profiles anything.
+They're never freed, so that a thread that has finished can still have
+its events exported.
+*/
+Profiler::ThreadEvents* Profiler::GetThreadEvents() {
+	static thread_local ThreadEvents* threadEvents = nullptr;
+	if (!threadEvents) {
+		threadEvents = new ThreadEvents();
+		threadEvents->written	= 0;
+		threadEvents->processed	= 0;
+
+		std::lock_guard<std::mutex> lock(threadLock);
+		threadEvents->threadID = (unsigned int)threads.size();
+		threads.emplace_back(threadEvents);
+	}
+	return threadEvents;
+}
+
+void Profiler::BeginScope(const char* name) {
+	ThreadEvents* t = GetThreadEvents();
+	uint64_t index = t->written.load(std::memory_order_relaxed);
+	Event& e = t->events[index & (EVENTS_PER_THREAD - 1)];
+	e.name = name;
+	e.time = Now();
+	t->written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::EndScope() {
+	ThreadEvents* t = GetThreadEvents();
+	uint64_t index = t->written.load(std::memory_order_relaxed);
+	Event& e = t->events[index & (EVENTS_PER_THREAD - 1)];
+	e.name = nullptr;
+	e.time = Now();
+	t->written.store(index + 1, std::memory_order_release);
+}
+
+Profiler::ScopeHistory& Profiler::GetHistory(const char* name) {
+	for (ScopeHistory& h : histories) {
+		if (h.name == name || strcmp(h.name, name) == 0) {
+			return h;
+		}
+	}
+	ScopeHistory h;
+	h.name = name;
+	memset(h.frameMSec, 0, sizeof(h.frameMSec));
+	memset(h.frameCalls, 0, sizeof(h.frameCalls));
+	histories.emplace_back(h);
+	return histories.back();
+}
+
+/*
+Matches up every begin and end written since the last call, and adds the
+time spent in each scope onto this frame's slot in the scope's history.
+A scope counts towards the frame it ended in.
+*/
+void Profiler::NewFrame() {
+	std::lock_guard<std::mutex> lock(threadLock);
+
+	frameIndex = (frameIndex + 1) % HISTORY_FRAMES;
+	for (ScopeHistory& h : histories) {
+		h.frameMSec[frameIndex]		= 0.0f;
+		h.frameCalls[frameIndex]	= 0;
+	}
+
+	for (ThreadEvents* t : threads) {
+		uint64_t end	= t->written.load(std::memory_order_acquire);
+		uint64_t start	= t->processed;
+		if (end - start > EVENTS_PER_THREAD) { // Wrapped around since we last looked, so some are gone
+			start = end - EVENTS_PER_THREAD;
+			t->openScopes.clear();
+		}
+		for (uint64_t i = start; i < end; ++i) {
+			const Event& e = t->events[i & (EVENTS_PER_THREAD - 1)];
+			if (e.name) {
+				t->openScopes.emplace_back(e);
+				continue;
+			}
+			if (t->openScopes.empty()) {
+				continue;
+			}
+			Event begin = t->openScopes.back();
+			t->openScopes.pop_back();
+
+			ScopeHistory& h = GetHistory(begin.name);
+			h.frameMSec[frameIndex] += (float)((e.time - begin.time) / 1000000.0);
+			h.frameCalls[frameIndex]++;
+		}
+		t->processed = end;
+	}
+}
+
+void Profiler::GetStatistics(std::vector<ScopeStatistics>& out) {
+	std::lock_guard<std::mutex> lock(threadLock);
+
+	out.clear();
+	for (const ScopeHistory& h : histories) {
+		ScopeStatistics s;
+		s.name			= h.name;
+		s.maxMSec		= 0.0f;
+		float total		= 0.0f;
+		uint32_t calls	= 0;
+		for (unsigned int i = 0; i < HISTORY_FRAMES; ++i) {
+			total += h.frameMSec[i];
+			calls += h.frameCalls[i];
+			s.maxMSec = h.frameMSec[i] > s.maxMSec ? h.frameMSec[i] : s.maxMSec;
+		}
+		s.averageMSec	= total / HISTORY_FRAMES;
+		s.callsPerFrame = (float)calls / HISTORY_FRAMES;
+		out.emplace_back(s);
+	}
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filename) {
+	std::ofstream file(filename);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't open " << filename << std::endl;
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(threadLock);
+
+	file << "{\"traceEvents\":[\n";
+	bool first = true;
+	for (ThreadEvents* t : threads) {
+		uint64_t end	= t->written.load(std::memory_order_acquire);
+		uint64_t start	= end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+
+		for (uint64_t i = start; i < end; ++i) {
+			const Event& e = t->events[i & (EVENTS_PER_THREAD - 1)];
+			file << (first ? "" : ",\n");
+			first = false;
+			if (e.name) {
+				file << "{\"name\":\"";
+				for (const char* c = e.name; *c; ++c) {
+					if (*c == '"' || *c == '\\') {
+						file << '\\';
+					}
+					file << *c;
+				}
+				file << "\",\"ph\":\"B\"";
+			}
+			else {
+				file << "{\"ph\":\"E\"";
+			}
+			file << ",\"ts\":" << (e.time / 1000) << "." << (e.time % 1000 / 100)
+				<< ",\"pid\":0,\"tid\":" << t->threadID << "}";
+		}
+	}
+	file << "\n]}\n";
+	return true;
+}
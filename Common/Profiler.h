@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+
+namespace NCL {
+	/*
+	A low overhead hierarchical profiler. Each PROFILE_SCOPE writes a begin
+	event when it's entered and an end event when it's left, with a
+	nanosecond timestamp, into a ring buffer belonging to the current
+	thread - so jobs can be profiled too, without any locking.
+
+	NewFrame walks every thread's new events, pairs the begins and ends back
+	up, and keeps a rolling history of how long each scope took per frame.
+	WriteChromeTrace dumps whatever is still in the ring buffers out as a
+	Chrome trace (load it in chrome://tracing or ui.perfetto.dev).
+
+	Scope names must be string literals (or otherwise live forever), as only
+	the pointer is stored.
+	*/
+	class Profiler {
+	public:
+		struct ScopeStatistics {
+			const char* name;
+			float		averageMSec;	// Per frame, over the history
+			float		maxMSec;
+			float		callsPerFrame;
+		};
+
+		//Call once per frame, while no jobs are running
+		static void NewFrame();
+
+		static void GetStatistics(std::vector<ScopeStatistics>& out);
+
+		static bool WriteChromeTrace(const std::string& filename);
+
+		static void BeginScope(const char* name);
+		static void EndScope();
+
+		static const unsigned int EVENTS_PER_THREAD	= 1 << 16;
+		static const unsigned int HISTORY_FRAMES	= 60;
+
+	protected:
+		struct Event {
+			const char* name;	// nullptr for an end event
+			uint64_t	time;	// Nanoseconds since the profiler started
+		};
+
+		struct ThreadEvents {
+			Event					events[EVENTS_PER_THREAD];
+			std::atomic<uint64_t>	written;
+			uint64_t				processed;
+			unsigned int			threadID;
+			std::vector<Event>		openScopes; // Begins still waiting on their end, for NewFrame
+		};
+
+		struct ScopeHistory {
+			const char* name;
+			float		frameMSec[HISTORY_FRAMES];
+			uint32_t	frameCalls[HISTORY_FRAMES];
+		};
+
+		static ThreadEvents*	GetThreadEvents();
+		static uint64_t			Now();
+		static ScopeHistory&	GetHistory(const char* name);
+
+		static std::mutex					threadLock;
+		static std::vector<ThreadEvents*>	threads;
+		static std::vector<ScopeHistory>	histories;
+		static unsigned int					frameIndex;
+	};
+
+	class ProfileScope {
+	public:
+		ProfileScope(const char* name) {
+			Profiler::BeginScope(name);
+		}
+		~ProfileScope() {
+			Profiler::EndScope();
+		}
+	};
+}
+
+#define PROFILE_SCOPE_JOIN(a, b) a##b
+#define PROFILE_SCOPE_NAME(line) PROFILE_SCOPE_JOIN(profileScope, line)
+#define PROFILE_SCOPE(name) NCL::ProfileScope PROFILE_SCOPE_NAME(__LINE__)(name)
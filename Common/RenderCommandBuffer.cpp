@@ -0,0 +1,80 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "RenderCommandBuffer.h"
+
+#include <cstring>
+
+using namespace NCL;
+using namespace NCL::Rendering;
+
+void RenderCommandBuffer::Reset() {
+	commands.clear();
+	uniforms.clear();
+	uniformData.clear();
+}
+
+void RenderCommandBuffer::SetPipeline(const RenderPipeline& pipeline) {
+	RenderCommand c;
+	c.type		= RenderCommandType::SetPipeline;
+	c.pipeline	= pipeline;
+	commands.emplace_back(c);
+}
+
+void RenderCommandBuffer::BindMesh(MeshGeometry* mesh) {
+	RenderCommand c;
+	c.type	= RenderCommandType::BindMesh;
+	c.mesh	= mesh;
+	commands.emplace_back(c);
+}
+
+void RenderCommandBuffer::BindTexture(const TextureBase* texture, int uniform, int unit) {
+	RenderCommand c;
+	c.type		= RenderCommandType::BindTexture;
+	c.texture	= { texture, uniform, unit };
+	commands.emplace_back(c);
+}
+
+void RenderCommandBuffer::SetUniforms(const UniformValue* values, int count) {
+	RenderCommand c;
+	c.type		= RenderCommandType::SetUniforms;
+	c.uniforms	= { (uint32_t)uniforms.size(), (uint32_t)count };
+	for (int i = 0; i < count; ++i) {
+		size_t size		= GetUniformSize(values[i].type);
+		size_t offset	= uniformData.size();
+		uniformData.resize(offset + size);
+		memcpy(&uniformData[offset], values[i].data, size);
+		uniforms.push_back({ values[i].id, values[i].type, (uint32_t)offset });
+	}
+	commands.emplace_back(c);
+}
+
+void RenderCommandBuffer::Draw(int subLayer) {
+	RenderCommand c;
+	c.type	= RenderCommandType::Draw;
+	c.draw	= { subLayer, 1, 0 };
+	commands.emplace_back(c);
+}
+
+void RenderCommandBuffer::DrawInstanced(int instanceCount, int baseInstance, int subLayer) {
+	RenderCommand c;
+	c.type	= RenderCommandType::DrawInstanced;
+	c.draw	= { subLayer, instanceCount, baseInstance };
+	commands.emplace_back(c);
+}
+
+size_t RenderCommandBuffer::GetUniformSize(UniformType type) {
+	switch (type) {
+		case UniformType::Int:		return sizeof(int);
+		case UniformType::Float:	return sizeof(float);
+		case UniformType::Vector3:	return sizeof(float) * 3;
+		case UniformType::Vector4:	return sizeof(float) * 4;
+		case UniformType::Matrix4:	return sizeof(float) * 16;
+	}
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NCL {
+	class MeshGeometry;
+
+	namespace Rendering {
+		class ShaderBase;
+		class TextureBase;
+
+		enum class BlendMode : uint8_t {
+			Opaque,
+			Alpha
+		};
+
+		enum class CullMode : uint8_t {
+			None,
+			Back,
+			Front
+		};
+
+		struct RenderPipeline {
+			ShaderBase*	shader;
+			BlendMode	blend;
+			CullMode	cull;
+			bool		depthTest;
+		};
+
+		enum class UniformType : uint8_t {
+			Int,
+			Float,
+			Vector3,
+			Vector4,
+			Matrix4
+		};
+
+		/*
+		A uniform to send. The id means whatever the backend's shaders look
+		their uniforms up by - for the GL renderer, it's a ShaderUniform. The
+		data is copied when recorded, so it can point at a temporary.
+		*/
+		struct UniformValue {
+			int			id;
+			UniformType	type;
+			const void*	data;
+		};
+
+		enum class RenderCommandType : uint8_t {
+			SetPipeline,
+			BindMesh,
+			BindTexture,
+			SetUniforms,
+			Draw,
+			DrawInstanced
+		};
+
+		struct RenderCommand {
+			struct TextureBinding {
+				const TextureBase*	texture;
+				int					uniform;
+				int					unit;
+			};
+			struct UniformRange {
+				uint32_t first;
+				uint32_t count;
+			};
+			struct DrawCall {
+				int subLayer;
+				int instanceCount;
+				int baseInstance;
+			};
+
+			RenderCommandType type;
+			union {
+				RenderPipeline	pipeline;
+				MeshGeometry*	mesh;
+				TextureBinding	texture;
+				UniformRange	uniforms;
+				DrawCall		draw;
+			};
+		};
+
+		/*
+		A list of rendering commands, recorded now and replayed later by a
+		renderer's ExecuteCommandBuffer. Recording never touches the graphics
+		API, so any thread can fill a buffer - give each one its own, and
+		replay them in order on the thread that owns the context. It also
+		means the command streams can be built and checked without a window.
+
+		Everything is kept in vectors that are only cleared by Reset, so a
+		buffer that's reused every frame stops allocating once it's grown.
+		*/
+		class RenderCommandBuffer {
+		public:
+			struct RecordedUniform {
+				int			id;
+				UniformType	type;
+				uint32_t	offset;	// Into the uniform data
+			};
+
+			void Reset();
+
+			void SetPipeline(const RenderPipeline& pipeline);
+			void BindMesh(MeshGeometry* mesh);
+			void BindTexture(const TextureBase* texture, int uniform, int unit);
+			void SetUniforms(const UniformValue* values, int count);
+			void Draw(int subLayer = 0);
+			void DrawInstanced(int instanceCount, int baseInstance, int subLayer = 0);
+
+			const std::vector<RenderCommand>& GetCommands() const {
+				return commands;
+			}
+
+			//The first of a SetUniforms command's uniforms.count uniforms
+			const RecordedUniform* GetUniforms(const RenderCommand& command) const {
+				return &uniforms[command.uniforms.first];
+			}
+
+			const void* GetUniformData(const RecordedUniform& uniform) const {
+				return &uniformData[uniform.offset];
+			}
+
+			static size_t GetUniformSize(UniformType type);
+
+		protected:
+			std::vector<RenderCommand>		commands;
+			std::vector<RecordedUniform>	uniforms;
+			std::vector<uint8_t>			uniformData;
+		};
+	}
+}
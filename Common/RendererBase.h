@@ -15,6 +15,8 @@ _-_-_-_-_-_-_-""  ""
 
 namespace NCL {
 	namespace Rendering {
+		class RenderCommandBuffer;
+
 		enum class VerticalSyncState {
 			VSync_ON,
 			VSync_OFF,
@@ -41,6 +43,9 @@ namespace NCL {
 				return false;
 			}
 
+			//Buffers can be recorded on any thread, but are replayed on the renderer's
+			virtual void ExecuteCommandBuffer(const RenderCommandBuffer& buffer) = 0;
+
 		protected:
 			virtual void OnWindowResize(int w, int h) = 0;
 			virtual void OnWindowDetach() {}; //Most renderers won't care about this
@@ -55,14 +55,14 @@ SimpleFont::~SimpleFont()
 	delete		texture;
 }
 
-int SimpleFont::BuildVerticesForString(std::string &text, Vector2&startPos, Vector4&colour, std::vector<Vector3>&positions, std::vector<Vector2>&texCoords, std::vector<Vector4>&colours) {
+int SimpleFont::BuildVerticesForString(const char* text, size_t length, const Vector2&startPos, const Vector4&colour, FrameVector<Vector3>&positions, FrameVector<Vector2>&texCoords, FrameVector<Vector4>&colours) {
 	int vertsWritten = 0;
 
 	int endChar = startChar + numChars;
 
 	float currentX = 0.0f;
 
-	for (size_t i = 0; i < text.length(); ++i) {
+	for (size_t i = 0; i < length; ++i) {
 		int charIndex = (int)text[i];
 
 		if (charIndex < startChar) {
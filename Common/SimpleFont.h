@@ -10,6 +10,7 @@ https://research.ncl.ac.uk/game/
 #include <string>
 #include <vector>
 #include "TextureBase.h"
+#include "FrameAllocator.h"
 
 namespace NCL {
 	namespace Maths {
@@ -24,7 +25,7 @@ namespace NCL {
 			SimpleFont(const std::string&fontName, const std::string&texName);
 			~SimpleFont();
 
-			int BuildVerticesForString(std::string &text, Maths::Vector2&startPos, Maths::Vector4&colour, std::vector<Maths::Vector3>&positions, std::vector<Maths::Vector2>&texCoords, std::vector<Maths::Vector4>&colours);
+			int BuildVerticesForString(const char* text, size_t length, const Maths::Vector2&startPos, const Maths::Vector4&colour, FrameVector<Maths::Vector3>&positions, FrameVector<Maths::Vector2>&texCoords, FrameVector<Maths::Vector4>&colours);
 
 			const TextureBase* GetTexture() const {
 				return texture;
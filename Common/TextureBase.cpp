@@ -4,6 +4,7 @@ using namespace Rendering;
 
 TextureBase::TextureBase()
 {
+	ready = true;
 }
 
 
@@ -1,14 +1,22 @@
 #pragma once
 
 namespace NCL {
+	class AssetManager;
+
 	namespace Rendering {
 		class TextureBase
 		{
 		public:
 			virtual ~TextureBase();
+
+			//False while a streamed texture is still waiting for its data
+			bool IsReady() const { return ready; }
 		protected:
+			friend class NCL::AssetManager;
+
 			TextureBase();
 
+			bool ready;
 		};
 	}
 }
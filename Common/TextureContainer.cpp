@@ -0,0 +1,206 @@
+#include "TextureContainer.h"
+#include "TextureLoader.h"
+#include "MappedFile.h"
+#include "Assets.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace NCL;
+
+namespace {
+	/*
+	A header, a table of levels from largest to smallest, then the data for
+	each level starting on a LEVEL_ALIGNMENT boundary.
+	*/
+	const char		CONTAINER_MAGIC[4]	= { 'N', 'T', 'E', 'X' };
+	const uint32_t	CONTAINER_VERSION	= 1;
+	const uint64_t	LEVEL_ALIGNMENT		= 16;
+	const uint32_t	FLAG_SRGB			= 1 << 0;
+
+	struct ContainerHeader {
+		char		magic[4];
+		uint32_t	version;
+		uint32_t	format;		// TextureFormat
+		uint32_t	flags;
+		uint32_t	levelCount;
+		uint32_t	padding;
+	};
+
+	struct ContainerLevel {
+		uint32_t	width;
+		uint32_t	height;
+		uint64_t	offset;		// From the start of the file
+		uint64_t	size;
+	};
+
+	std::string ContainerName(const std::string& filename) {
+		size_t dot = filename.find_last_of('.');
+		return (dot == std::string::npos ? filename : filename.substr(0, dot)) + ".ntex";
+	}
+}
+
+TextureContainer::TextureContainer() {
+	mappedFile	= nullptr;
+	decodedData = nullptr;
+	Clear();
+}
+
+TextureContainer::~TextureContainer() {
+	Clear();
+	delete mappedFile;
+}
+
+void TextureContainer::Clear() {
+	if (mappedFile) {
+		mappedFile->Close();
+	}
+	free(decodedData);
+	decodedData = nullptr;
+	format		= TextureFormat::RGBA8;
+	sRGB		= false;
+	levelCount	= 0;
+}
+
+bool TextureContainer::LoadFile(const std::string& filename) {
+	Clear();
+	std::string containerPath = Assets::TEXTUREDIR + ContainerName(filename);
+	if (std::ifstream(containerPath) && ReadContainer(containerPath)) {
+		return true;
+	}
+	int width		= 0;
+	int height		= 0;
+	int channels	= 0;
+	int flags		= 0;
+	if (!TextureLoader::LoadTexture(filename, decodedData, width, height, channels, flags) || channels < 1 || channels > 4) {
+		return false;
+	}
+	format			= FormatFromChannels(channels);
+	sRGB			= channels >= 3;
+	levels[0]		= { width, height, decodedData, GetLevelSize(format, width, height) };
+	levelCount		= 1;
+	return true;
+}
+
+/*
+Like binary meshes, nothing is copied - each level just points into the
+mapped file, once it's been checked to lie inside it.
+*/
+bool TextureContainer::ReadContainer(const std::string& path) {
+	if (!mappedFile) {
+		mappedFile = new MappedFile();
+	}
+	if (!mappedFile->Open(path)) {
+		return false;
+	}
+	const char* data = mappedFile->GetData();
+	size_t		size = mappedFile->GetSize();
+
+	ContainerHeader header;
+	if (size < sizeof(header)) {
+		std::cout << __FUNCTION__ << " " << path << " is too small to be a texture container!" << std::endl;
+		mappedFile->Close();
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) != 0 || header.version != CONTAINER_VERSION || header.format > (uint32_t)TextureFormat::BC7 ||
+		header.levelCount == 0 || header.levelCount > MAX_LEVELS ||
+		size < sizeof(header) + header.levelCount * sizeof(ContainerLevel)) {
+		std::cout << __FUNCTION__ << " " << path << " is not a valid texture container!" << std::endl;
+		mappedFile->Close();
+		return false;
+	}
+	format	= (TextureFormat)header.format;
+	sRGB	= (header.flags & FLAG_SRGB) != 0;
+	for (uint32_t i = 0; i < header.levelCount; ++i) {
+		ContainerLevel level;
+		memcpy(&level, data + sizeof(header) + i * sizeof(ContainerLevel), sizeof(level));
+
+		if (level.width == 0 || level.height == 0 || level.size != GetLevelSize(format, level.width, level.height) ||
+			level.offset + level.size > size) {
+			std::cout << __FUNCTION__ << " " << path << " has a bad level " << i << std::endl;
+			mappedFile->Close();
+			levelCount = 0;
+			return false;
+		}
+		levels[i] = { (int)level.width, (int)level.height, data + level.offset, (size_t)level.size };
+	}
+	levelCount = header.levelCount;
+	return true;
+}
+
+void TextureContainer::SetLevels(TextureFormat newFormat, bool newSRGB, const Level* newLevels, int count) {
+	Clear();
+	format		= newFormat;
+	sRGB		= newSRGB;
+	levelCount	= count < MAX_LEVELS ? count : MAX_LEVELS;
+	for (int i = 0; i < levelCount; ++i) {
+		levels[i] = newLevels[i];
+	}
+}
+
+bool TextureContainer::SaveFile(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't open " << path << std::endl;
+		return false;
+	}
+	ContainerHeader header;
+	memcpy(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+	header.version		= CONTAINER_VERSION;
+	header.format		= (uint32_t)format;
+	header.flags		= sRGB ? FLAG_SRGB : 0;
+	header.levelCount	= levelCount;
+	header.padding		= 0;
+
+	ContainerLevel table[MAX_LEVELS] = {};
+	uint64_t offset = sizeof(header) + levelCount * sizeof(ContainerLevel);
+	for (int i = 0; i < levelCount; ++i) {
+		offset = (offset + LEVEL_ALIGNMENT - 1) & ~(LEVEL_ALIGNMENT - 1);
+		table[i].width	= levels[i].width;
+		table[i].height = levels[i].height;
+		table[i].offset = offset;
+		table[i].size	= levels[i].size;
+		offset += levels[i].size;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)table, levelCount * sizeof(ContainerLevel));
+
+	const char	padding[LEVEL_ALIGNMENT] = { 0 };
+	uint64_t	written = sizeof(header) + levelCount * sizeof(ContainerLevel);
+	for (int i = 0; i < levelCount; ++i) {
+		file.write(padding, table[i].offset - written);
+		file.write(levels[i].data, levels[i].size);
+		written = table[i].offset + table[i].size;
+	}
+	return (bool)file;
+}
+
+bool TextureContainer::IsCompressed(TextureFormat format) {
+	return format == TextureFormat::BC1 || format == TextureFormat::BC3 || format == TextureFormat::BC7;
+}
+
+size_t TextureContainer::GetLevelSize(TextureFormat format, int width, int height) {
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	switch (format) {
+		case TextureFormat::R8:		return (size_t)width * height;
+		case TextureFormat::RG8:	return (size_t)width * height * 2;
+		case TextureFormat::RGB8:	return (size_t)width * height * 3;
+		case TextureFormat::RGBA8:	return (size_t)width * height * 4;
+		case TextureFormat::BC1:	return blocks * 8;
+		case TextureFormat::BC3:	return blocks * 16;
+		case TextureFormat::BC7:	return blocks * 16;
+	}
+	return 0;
+}
+
+TextureFormat TextureContainer::FormatFromChannels(int channels) {
+	switch (channels) {
+		case 1: return TextureFormat::R8;
+		case 2: return TextureFormat::RG8;
+		case 3: return TextureFormat::RGB8;
+	}
+	return TextureFormat::RGBA8;
+}
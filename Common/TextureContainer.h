@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace NCL {
+	class MappedFile;
+
+	enum class TextureFormat : uint32_t {
+		R8,
+		RG8,
+		RGB8,
+		RGBA8,
+		BC1,	// 8 bytes per 4x4 block, opaque colour
+		BC3,	// 16 bytes per 4x4 block, colour plus smooth alpha
+		BC7		// 16 bytes per 4x4 block, higher quality colour and alpha
+	};
+
+	/*
+	A texture's pixels, ready to hand to the graphics API as they are - every
+	mip level, in the format it will be stored in on the GPU.
+
+	Images are loaded into one of these either by decoding them through
+	TextureLoader, giving a single uncompressed level, or from a .ntex file
+	written by the TextureConverter tool, which is just mapped into memory:
+	its levels are already generated and block compressed, so there's no
+	decoding at all. If a .ntex has been made for an image, it's used
+	instead automatically.
+	*/
+	class TextureContainer {
+	public:
+		static const int MAX_LEVELS = 16;
+
+		struct Level {
+			int				width;
+			int				height;
+			const char*		data;
+			size_t			size;
+		};
+
+		TextureContainer();
+		~TextureContainer();
+
+		TextureContainer(const TextureContainer&) = delete;
+		TextureContainer& operator=(const TextureContainer&) = delete;
+
+		//Relative to Assets::TEXTUREDIR
+		bool LoadFile(const std::string& filename);
+
+		//Points at levels owned by the caller, who has to keep them alive
+		void SetLevels(TextureFormat format, bool sRGB, const Level* newLevels, int count);
+
+		bool SaveFile(const std::string& path) const;
+
+		TextureFormat	GetFormat()		const { return format;		}
+		bool			IsSRGB()		const { return sRGB;		}
+		int				GetLevelCount() const { return levelCount;	}
+		const Level&	GetLevel(int i) const { return levels[i];	}
+
+		int GetWidth()	const { return levelCount > 0 ? levels[0].width  : 0; }
+		int GetHeight() const { return levelCount > 0 ? levels[0].height : 0; }
+
+		static bool		IsCompressed(TextureFormat format);
+		static size_t	GetLevelSize(TextureFormat format, int width, int height);
+
+		//8-bit formats only - colour images are treated as sRGB
+		static TextureFormat FormatFromChannels(int channels);
+
+	protected:
+		bool ReadContainer(const std::string& path);
+		void Clear();
+
+		TextureFormat	format;
+		bool			sRGB;
+		Level			levels[MAX_LEVELS];
+		int				levelCount;
+
+		MappedFile*		mappedFile;
+		char*			decodedData;
+	};
+}
@@ -16,8 +16,10 @@ using namespace NCL::Rendering;
 using namespace NCL::Maths;
 
 OGLMesh::OGLMesh() {
-	vao			= 0;
-	subCount	= 1;
+	vao				= 0;
+	subCount		= 1;
+	instanceBuffer	= 0;
+	streamCapacity	= 0;
 
 	for (size_t i = 0; i < MAX_BUFFER; ++i) {
 		buffers[i] = 0;
@@ -25,8 +27,10 @@ OGLMesh::OGLMesh() {
 }
 
 OGLMesh::OGLMesh(const std::string&filename) : MeshGeometry(filename){
-	vao		 = 0;
-	subCount = 1;
+	vao				= 0;
+	subCount		= 1;
+	instanceBuffer	= 0;
+	streamCapacity	= 0;
 
 	for (size_t i = 0; i < MAX_BUFFER; ++i) {
 		buffers[i] = 0;
@@ -38,7 +42,13 @@ OGLMesh::~OGLMesh()	{
 	glDeleteBuffers(MAX_BUFFER, buffers);	//Delete our VBOs
 }
 
-void CreateVertexBuffer(GLuint& buffer, int byteCount, char* data) {
+MeshGeometry* OGLMesh::CreateMesh() {
+	OGLMesh* mesh = new OGLMesh();
+	mesh->SetPrimitiveType(GeometryPrimitive::Triangles);
+	return mesh;
+}
+
+void CreateVertexBuffer(GLuint& buffer, int byteCount, const void* data) {
 	glGenBuffers(1, &buffer);
 	glBindBuffer(GL_ARRAY_BUFFER, buffer);
 	glBufferData(GL_ARRAY_BUFFER, byteCount, data, GL_STATIC_DRAW);
@@ -54,45 +64,97 @@ void OGLMesh::BindVertexAttribute(int attribSlot, int buffer, int bindingID, int
 
 void OGLMesh::UploadToGPU() {
 	glGenVertexArrays(1, &vao);
+	instanceBuffer = 0;
 	glBindVertexArray(vao);
 
 	int numVertices = GetVertexCount();
 	int numIndices	= GetIndexCount();
 
-	//Buffer vertex data
-	if (!GetPositionData().empty()) {
-		CreateVertexBuffer(buffers[VERTEX_BUFFER], numVertices * sizeof(Vector3), (char*)GetPositionData().data());
+	//Buffer vertex data - for binary meshes, this comes straight out of the mapped file
+	if (const void* data = GetChunkData(GeometryChunkTypes::VPositions)) {
+		CreateVertexBuffer(buffers[VERTEX_BUFFER], numVertices * sizeof(Vector3), data);
 		BindVertexAttribute(VERTEX_BUFFER, buffers[VERTEX_BUFFER], VERTEX_BUFFER, 3, sizeof(Vector3), 0);
 	}
 
-	if (!GetColourData().empty()) {	//buffer colour data
-		CreateVertexBuffer(buffers[COLOUR_BUFFER], numVertices * sizeof(Vector4), (char*)GetColourData().data());
+	if (const void* data = GetChunkData(GeometryChunkTypes::VColors)) {	//buffer colour data
+		CreateVertexBuffer(buffers[COLOUR_BUFFER], numVertices * sizeof(Vector4), data);
 		BindVertexAttribute(COLOUR_BUFFER, buffers[COLOUR_BUFFER], COLOUR_BUFFER, 4, sizeof(Vector4), 0);
 	}
-	if (!GetTextureCoordData().empty()) {	//Buffer texture data
-		CreateVertexBuffer(buffers[TEXTURE_BUFFER], numVertices * sizeof(Vector2), (char*)GetTextureCoordData().data());
+	if (const void* data = GetChunkData(GeometryChunkTypes::VTex0)) {	//Buffer texture data
+		CreateVertexBuffer(buffers[TEXTURE_BUFFER], numVertices * sizeof(Vector2), data);
 		BindVertexAttribute(TEXTURE_BUFFER, buffers[TEXTURE_BUFFER], TEXTURE_BUFFER, 2, sizeof(Vector2), 0);
 	}
 
-	if (!GetNormalData().empty()) {	//Buffer normal data
-		CreateVertexBuffer(buffers[NORMAL_BUFFER], numVertices * sizeof(Vector3), (char*)GetNormalData().data());
+	if (const void* data = GetChunkData(GeometryChunkTypes::VNormals)) {	//Buffer normal data
+		CreateVertexBuffer(buffers[NORMAL_BUFFER], numVertices * sizeof(Vector3), data);
 		BindVertexAttribute(NORMAL_BUFFER, buffers[NORMAL_BUFFER], NORMAL_BUFFER, 3, sizeof(Vector3), 0);
 	}
 
-	if (!GetTangentData().empty()) {	//Buffer tangent data
-		CreateVertexBuffer(buffers[TANGENT_BUFFER], numVertices * sizeof(Vector3), (char*)GetTangentData().data());
+	if (const void* data = GetChunkData(GeometryChunkTypes::VTangents)) {	//Buffer tangent data
+		CreateVertexBuffer(buffers[TANGENT_BUFFER], numVertices * sizeof(Vector3), data);
 		BindVertexAttribute(TANGENT_BUFFER, buffers[TANGENT_BUFFER], TANGENT_BUFFER, 3, sizeof(Vector3), 0);
 	}
 
-	if (!GetIndexData().empty()) {		//buffer index data
+	if (const void* data = GetChunkData(GeometryChunkTypes::Indices)) {		//buffer index data
 		glGenBuffers(1, &buffers[INDEX_BUFFER]);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[INDEX_BUFFER]);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(GLuint), (int*)GetIndexData().data(), GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(GLuint), data, GL_STATIC_DRAW);
 	}
 
 	glBindVertexArray(0);
 }
 
+void OGLMesh::SetInstanceBuffer(GLuint buffer, int stride, const InstanceAttribute* attributes, int count) {
+	glBindVertexArray(vao);
+	for (int i = 0; i < count; ++i) {
+		glEnableVertexAttribArray(attributes[i].slot);
+		glVertexAttribFormat(attributes[i].slot, attributes[i].elementCount, GL_FLOAT, false, attributes[i].offset);
+		glVertexAttribBinding(attributes[i].slot, INSTANCE_BINDING);
+	}
+	glBindVertexBuffer(INSTANCE_BINDING, buffer, 0, stride);
+	glVertexBindingDivisor(INSTANCE_BINDING, 1);
+	glBindVertexArray(0);
+
+	instanceBuffer = buffer;
+}
+
+/*
+Buffers are only made for the attributes actually streamed in, so any that
+aren't stay disabled. Each is orphaned every time, so the driver never has
+to wait on last frame's draws.
+*/
+void OGLMesh::UpdateStreamedVertices(unsigned int count, const Vector3* positions, const Vector2* texCoords, const Vector4* colours) {
+	const void*	data[]		= { positions, texCoords, colours };
+	MeshBuffer	slots[]		= { VERTEX_BUFFER, TEXTURE_BUFFER, COLOUR_BUFFER };
+	int			elements[]	= { 3, 2, 4 };
+
+	if (vao == 0) {
+		glGenVertexArrays(1, &vao);
+	}
+	if (count > streamCapacity) {
+		streamCapacity = count * 2;
+	}
+	for (int i = 0; i < 3; ++i) {
+		if (!data[i]) {
+			continue;
+		}
+		int		elementSize = elements[i] * sizeof(float);
+		GLuint&	buffer		= buffers[slots[i]];
+		if (buffer == 0) {
+			glGenBuffers(1, &buffer);
+			glBindVertexArray(vao);
+			BindVertexAttribute(slots[i], buffer, slots[i], elements[i], elementSize, 0);
+			glBindVertexArray(0);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferData(GL_ARRAY_BUFFER, streamCapacity * elementSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * elementSize, data[i]);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	mappedVertexCount = count; // What GetVertexCount reports while positions is empty
+}
+
 void OGLMesh::RecalculateNormals() {
 	normals.clear();
 
@@ -8,7 +8,7 @@ https://research.ncl.ac.uk/game/
 */
 #pragma once
 #include "../../Common/MeshGeometry.h"
-#include "glad\glad.h"
+#include "glad/glad.h"
 
 #include <string>
 
@@ -29,6 +29,15 @@ namespace NCL {
 				MAX_BUFFER
 			};
 
+			//Per-instance data comes from a buffer binding after the mesh's own
+			static const int INSTANCE_BINDING = MAX_BUFFER;
+
+			struct InstanceAttribute {
+				int slot;
+				int elementCount;	// Floats
+				int offset;			// Bytes, from the start of each instance
+			};
+
 			friend class OGLRenderer;
 			OGLMesh();
 			OGLMesh(const std::string&filename);
@@ -38,8 +47,29 @@ namespace NCL {
 
 			void UploadToGPU() override;
 
-		protected:
+			//An empty triangle mesh, for the AssetManager to load into and upload
+			static MeshGeometry* CreateMesh();
+
 			GLuint	GetVAO()			const { return vao;			}
+
+			/*
+			Points the given attribute slots at a buffer of per-instance data,
+			advancing once per instance rather than once per vertex. Leaves no
+			vertex array bound, like UploadToGPU.
+			*/
+			void SetInstanceBuffer(GLuint buffer, int stride, const InstanceAttribute* attributes, int count);
+
+			GLuint	GetInstanceBuffer() const { return instanceBuffer; }
+
+			/*
+			For meshes that are rebuilt every frame, such as the debug text and
+			lines. The vertices go straight into the mesh's own buffers, which
+			are kept between calls, and nothing is kept on the CPU side. Any of
+			the arrays can be nullptr.
+			*/
+			void UpdateStreamedVertices(unsigned int count, const Vector3* positions, const Vector2* texCoords, const Vector4* colours);
+
+		protected:
 			int		GetSubMeshCount()	const { return subCount;	}
 
 			void BindVertexAttribute(int attribSlot, int bufferID, int bindingID, int elementCount, int elementSize, int elementOffset);
@@ -51,6 +81,8 @@ namespace NCL {
 			GLuint vao;
 			GLuint oglType;
 			GLuint buffers[MAX_BUFFER];
+			GLuint instanceBuffer;
+			unsigned int streamCapacity;	// Vertices the streamed buffers can hold
 		};
 	}
 }
\ No newline at end of file
@@ -13,17 +13,20 @@ https://research.ncl.ac.uk/game/
 
 #include "../../Common/SimpleFont.h"
 #include "../../Common/TextureLoader.h"
+#include "../../Common/AssetManager.h"
+#include "../../Common/Assets.h"
 
 #include "../../Common/Vector2.h"
 #include "../../Common/Vector3.h"
 
 #include "../../Common/MeshGeometry.h"
+#include "../../Common/RenderCommandBuffer.h"
 
 #ifdef _WIN32
 #include "../../Common/Win32Window.h"
 
-#include "KHR\khrplatform.h"
-#include "glad\glad.h"
+#include "KHR/khrplatform.h"
+#include "glad/glad.h"
 
 #include "GL/GL.h"
 #include "KHR/WGLext.h"
@@ -46,11 +49,20 @@ OGLRenderer::OGLRenderer(Window& w) : RendererBase(w)	{
 	boundMesh	= nullptr;
 	boundShader = nullptr;
 
+	debugShader		= nullptr;
+	font			= nullptr;
+	debugTextMesh	= nullptr;
+	debugLineMesh	= nullptr;
+
 	currentWidth	= (int)w.GetScreenSize().x;
 	currentHeight	= (int)w.GetScreenSize().y;
 
 	if (initState) {
 		TextureLoader::RegisterAPILoadFunction(OGLTexture::RGBATextureFromFilename);
+		AssetManager::RegisterMeshCreateFunction(OGLMesh::CreateMesh);
+		AssetManager::RegisterTextureFunctions(OGLTexture::CreateTexture, OGLTexture::UploadTextureData);
+		AssetManager::RegisterShaderLoadFunction(OGLShader::ShaderFromFilenames);
+		OGLShader::SetProgramCacheDirectory(Assets::DATADIR + "ShaderCache/");
 
 		font = new SimpleFont("PressStart2P.fnt", "PressStart2P.png");
 
@@ -65,14 +77,23 @@ OGLRenderer::OGLRenderer(Window& w) : RendererBase(w)	{
 		}
 		glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
 		debugShader = new OGLShader("debugVert.glsl", "debugFrag.glsl");
+
+		debugTextMesh = new OGLMesh();
+		debugLineMesh = new OGLMesh();
+		debugLineMesh->SetPrimitiveType(GeometryPrimitive::Lines);
 	}
 
 	forceValidDebugState = false;
+	lastFrameCounters	 = { 0, 0 };
+	drawCalls			 = 0;
+	lastFrameDrawCalls	 = 0;
 }
 
 OGLRenderer::~OGLRenderer()	{
 	delete font;
 	delete debugShader;
+	delete debugTextMesh;
+	delete debugLineMesh;
 
 #ifdef _WIN32
 	DestroyWithWin32();
@@ -87,6 +108,12 @@ void OGLRenderer::OnWindowResize(int w, int h)	 {
 void OGLRenderer::BeginFrame()		{
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+	//Meshes and textures made since last frame will have changed the bindings
+	lastFrameCounters	= glState.ResetCounters();
+	lastFrameDrawCalls	= drawCalls;
+	drawCalls			= 0;
+	glState.Invalidate();
+
 	BindShader(nullptr);
 	BindMesh(nullptr);
 }
@@ -102,11 +129,11 @@ void OGLRenderer::EndFrame()		{
 
 void OGLRenderer::BindShader(ShaderBase*s) {
 	if (!s) {
-		glUseProgram(0);
+		glState.UseProgram(0);
 		boundShader = nullptr;
 	}
 	else if (OGLShader* oglShader = dynamic_cast<OGLShader*>(s)) {
-		glUseProgram(oglShader->programID);
+		glState.UseProgram(oglShader->programID);
 		boundShader = oglShader;
 	}
 	else {
@@ -117,14 +144,14 @@ void OGLRenderer::BindShader(ShaderBase*s) {
 
 void OGLRenderer::BindMesh(MeshGeometry*m) {
 	if (!m) {
-		glBindVertexArray(0);
+		glState.BindVertexArray(0);
 		boundMesh = nullptr;
 	}
 	else if (OGLMesh* oglMesh = dynamic_cast<OGLMesh*>(m)) {
 		if (oglMesh->GetVAO() == 0) {
 			std::cout << __FUNCTION__ << " has received invalid mesh?!" << std::endl;
 		}
-		glBindVertexArray(oglMesh->GetVAO());
+		glState.BindVertexArray(oglMesh->GetVAO());
 		boundMesh = oglMesh;
 	}
 	else {
@@ -133,7 +160,7 @@ void OGLRenderer::BindMesh(MeshGeometry*m) {
 	}
 }
 
-void OGLRenderer::DrawBoundMesh(int subLayer, int numInstances) {
+void OGLRenderer::DrawBoundMesh(int subLayer, int numInstances, int baseInstance) {
 	if (!boundMesh) {
 		std::cout << __FUNCTION__ << " has been called without a bound mesh!" << std::endl;
 		return;
@@ -153,23 +180,92 @@ void OGLRenderer::DrawBoundMesh(int subLayer, int numInstances) {
 		case GeometryPrimitive::Patches:		mode = GL_PATCHES;			break;
 	}
 
+	drawCalls++;
+	bool instanced = numInstances != 1 || baseInstance != 0;
+
 	if (boundMesh->GetIndexCount() > 0) {
-		glDrawElements(mode, boundMesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
+		if (instanced) {
+			glDrawElementsInstancedBaseInstance(mode, boundMesh->GetIndexCount(), GL_UNSIGNED_INT, 0, numInstances, baseInstance);
+		}
+		else {
+			glDrawElements(mode, boundMesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
+		}
+	}
+	else if (instanced) {
+		glDrawArraysInstancedBaseInstance(mode, 0, boundMesh->GetVertexCount(), numInstances, baseInstance);
 	}
 	else {
 		glDrawArrays(mode, 0, boundMesh->GetVertexCount());
 	}
 }
 
-void OGLRenderer::BindTextureToShader(const TextureBase*t, const std::string& uniform, int texUnit) const{
-	GLint texID = 0;
+/*
+Uniform ids are ShaderUniform slots, looked up in whichever shader the
+last SetPipeline bound.
+*/
+void OGLRenderer::ExecuteCommandBuffer(const RenderCommandBuffer& buffer) {
+	for (const RenderCommand& c : buffer.GetCommands()) {
+		switch (c.type) {
+			case RenderCommandType::SetPipeline: {
+				BindShader(c.pipeline.shader);
+				glState.SetBlend(c.pipeline.blend == BlendMode::Alpha);
+				glState.SetCullFace(c.pipeline.cull != CullMode::None, c.pipeline.cull == CullMode::Front ? GL_FRONT : GL_BACK);
+				glState.SetDepthTest(c.pipeline.depthTest);
+			}break;
+			case RenderCommandType::BindMesh: {
+				BindMesh(c.mesh);
+			}break;
+			case RenderCommandType::BindTexture: {
+				BindTextureToShader(c.texture.texture, (ShaderUniform)c.texture.uniform, c.texture.unit);
+			}break;
+			case RenderCommandType::SetUniforms: {
+				if (!boundShader) {
+					std::cout << __FUNCTION__ << " has been given uniforms without a bound shader!" << std::endl;
+					break;
+				}
+				const RenderCommandBuffer::RecordedUniform* uniforms = buffer.GetUniforms(c);
+				for (uint32_t i = 0; i < c.uniforms.count; ++i) {
+					const RenderCommandBuffer::RecordedUniform& u = uniforms[i];
+					if (u.id < 0 || u.id >= (int)ShaderUniform::MAX) {
+						continue;
+					}
+					GLint		location	= boundShader->GetUniformLocation((ShaderUniform)u.id);
+					const void* data		= buffer.GetUniformData(u);
+					switch (u.type) {
+						case UniformType::Int:		glUniform1iv(location, 1, (const GLint*)data);					break;
+						case UniformType::Float:	glUniform1fv(location, 1, (const GLfloat*)data);				break;
+						case UniformType::Vector3:	glUniform3fv(location, 1, (const GLfloat*)data);				break;
+						case UniformType::Vector4:	glUniform4fv(location, 1, (const GLfloat*)data);				break;
+						case UniformType::Matrix4:	glUniformMatrix4fv(location, 1, false, (const GLfloat*)data);	break;
+					}
+				}
+			}break;
+			case RenderCommandType::Draw:
+			case RenderCommandType::DrawInstanced: {
+				DrawBoundMesh(c.draw.subLayer, c.draw.instanceCount, c.draw.baseInstance);
+			}break;
+		}
+	}
+}
 
+void OGLRenderer::BindTextureToShader(const TextureBase*t, const std::string& uniform, int texUnit) {
 	if (!boundShader) {
 		std::cout << __FUNCTION__ << " has been called without a bound shader!" << std::endl;
 		return;//Debug message time!
 	}
-	
-	GLuint slot = glGetUniformLocation(boundShader->programID, uniform.c_str());
+	BindTextureToSlot(t, boundShader->GetUniformLocation(uniform), texUnit);
+}
+
+void OGLRenderer::BindTextureToShader(const TextureBase*t, ShaderUniform uniform, int texUnit) {
+	if (!boundShader) {
+		std::cout << __FUNCTION__ << " has been called without a bound shader!" << std::endl;
+		return;
+	}
+	BindTextureToSlot(t, boundShader->GetUniformLocation(uniform), texUnit);
+}
+
+void OGLRenderer::BindTextureToSlot(const TextureBase*t, int slot, int texUnit) {
+	GLint texID = 0;
 
 	if (slot < 0) {
 		return;
@@ -179,13 +275,16 @@ void OGLRenderer::BindTextureToShader(const TextureBase*t, const std::string& un
 		texID = oglTexture->GetObjectID();
 	}
 
-	glActiveTexture(GL_TEXTURE0 + texUnit);
-	glBindTexture(GL_TEXTURE_2D, texID);
+	glState.BindTexture(texUnit, texID);
 
 	glUniform1i(slot, texUnit);
 }
 
 void OGLRenderer::DrawString(const std::string& text, const Vector2&pos, const Vector4& colour) {
+	DrawString(text.c_str(), text.length(), pos, colour);
+}
+
+void OGLRenderer::DrawString(const char* text, size_t length, const Vector2&pos, const Vector4& colour) {
 	DebugString s;
 	s.colour = colour;
 	s.ndcPos = (pos / Vector2((float)currentWidth, (float)currentHeight));
@@ -193,8 +292,8 @@ void OGLRenderer::DrawString(const std::string& text, const Vector2&pos, const V
 	s.ndcPos.x = (s.ndcPos.x * 2.0f) - 1.0f;
 	s.ndcPos.y = (s.ndcPos.y * 2.0f) - 1.0f;
 	s.size = 1.0f;
-	s.text = text;
-	debugStrings.emplace_back(s);
+	s.text.assign(text, length);
+	debugStrings.emplace_back(std::move(s));
 }
 
 void OGLRenderer::DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour) {
@@ -212,12 +311,11 @@ void OGLRenderer::DrawDebugData() {
 	BindShader(debugShader);
 
 	if (forceValidDebugState) {
-		glEnable(GL_BLEND);
-		glDisable(GL_DEPTH_TEST);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glState.SetBlend(true);
+		glState.SetDepthTest(false);
 	}
 
-	int switchLocation = glGetUniformLocation(debugShader->GetProgramID(), "useMatrix");
+	int switchLocation = debugShader->GetUniformLocation(ShaderUniform::UseMatrix);
 
 	glUniform1i(switchLocation, 0);
 	DrawDebugStrings();
@@ -226,39 +324,33 @@ void OGLRenderer::DrawDebugData() {
 	DrawDebugLines();
 
 	if (forceValidDebugState) {
-		glDisable(GL_BLEND);
-		glEnable(GL_DEPTH_TEST);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glState.SetBlend(false);
+		glState.SetDepthTest(true);
 	}
 }
 
 void OGLRenderer::DrawDebugStrings() {
-	vector<Vector3> vertPos;
-	vector<Vector2> vertTex;
-	vector<Vector4> vertColours;
+	FrameVector<Vector3> vertPos;
+	FrameVector<Vector2> vertTex;
+	FrameVector<Vector4> vertColours;
 
 	for (DebugString&s : debugStrings) {
-		font->BuildVerticesForString(s.text, s.ndcPos, s.colour, vertPos, vertTex, vertColours);
+		font->BuildVerticesForString(s.text.c_str(), s.text.length(), s.ndcPos, s.colour, vertPos, vertTex, vertColours);
 	}
 
-	OGLMesh textMesh = OGLMesh();
-
-	textMesh.SetVertexPositions(vertPos);
-	textMesh.SetVertexTextureCoords(vertTex);
-	textMesh.SetVertexColours(vertColours);
+	debugTextMesh->UpdateStreamedVertices((unsigned int)vertPos.size(), vertPos.data(), vertTex.data(), vertColours.data());
+	glState.Invalidate();
 
-	textMesh.UploadToGPU();
-
-	BindMesh(&textMesh);
-	BindTextureToShader(font->GetTexture(), "mainTex", 0);
+	BindMesh(debugTextMesh);
+	BindTextureToShader(font->GetTexture(), ShaderUniform::MainTex, 0);
 	DrawBoundMesh();
 
-	debugStrings.clear();
+	ResetFrameContainer(debugStrings);
 }
 
 void OGLRenderer::DrawDebugLines() {
-	vector<Vector3> vertPos;
-	vector<Vector4> vertCol;
+	FrameVector<Vector3> vertPos;
+	FrameVector<Vector4> vertCol;
 
 	for (DebugLine&s : debugLines) {
 		vertPos.emplace_back(s.start);
@@ -268,19 +360,14 @@ void OGLRenderer::DrawDebugLines() {
 		vertCol.emplace_back(s.colour);
 	}
 
-	OGLMesh lineMesh = OGLMesh();
-
-	lineMesh.SetVertexPositions(vertPos);
-	lineMesh.SetVertexColours(vertCol);
-	lineMesh.SetPrimitiveType(GeometryPrimitive::Lines);
-
-	lineMesh.UploadToGPU();
+	debugLineMesh->UpdateStreamedVertices((unsigned int)vertPos.size(), vertPos.data(), nullptr, vertCol.data());
+	glState.Invalidate();
 
-	BindMesh(&lineMesh);
-	BindTextureToShader(nullptr, "mainTex", 0);
+	BindMesh(debugLineMesh);
+	BindTextureToShader(nullptr, ShaderUniform::MainTex, 0);
 	DrawBoundMesh();
 
-	debugLines.clear();
+	ResetFrameContainer(debugLines);
 }
 
 #ifdef _WIN32
@@ -333,18 +420,19 @@ void OGLRenderer::InitWithWin32(Window& w) {
 		return;
 	}
 	//Now we have a temporary context, we can find out if we support OGL 4.x
-	char* ver = (char*)glGetString(GL_VERSION); // ver must equal "4.1.0" (or greater!)
+	char* ver = (char*)glGetString(GL_VERSION); // ver must equal "4.3.0" (or greater!)
 	int major = ver[0] - '0';		//casts the 'correct' major version integer from our version string
 	int minor = ver[2] - '0';		//casts the 'correct' minor version integer from our version string
 
-	if (major < 3) {					//Graphics hardware does not support OGL 4! Erk...
+	if (major < 4) {					//Graphics hardware does not support OGL 4! Erk...
 		std::cout << __FUNCTION__ << " Device does not support OpenGL 4.x!" << std::endl;
 		wglDeleteContext(tempContext);
 		return;
 	}
 
-	if (major == 4 && minor < 1) {	//Graphics hardware does not support ENOUGH of OGL 4! Erk...
-		std::cout << __FUNCTION__ << " Device does not support OpenGL 4.1!" << std::endl;
+	//Meshes use separate vertex attribute formats and bindings (4.3), and instanced draws need a base instance (4.2)
+	if (major == 4 && minor < 3) {	//Graphics hardware does not support ENOUGH of OGL 4! Erk...
+		std::cout << __FUNCTION__ << " Device does not support OpenGL 4.3!" << std::endl;
 		wglDeleteContext(tempContext);
 		return;
 	}
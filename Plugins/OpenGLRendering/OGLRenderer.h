@@ -11,6 +11,8 @@ https://research.ncl.ac.uk/game/
 
 #include "../../Common/Vector3.h"
 #include "../../Common/Vector4.h"
+#include "../../Common/FrameAllocator.h"
+#include "OGLStateTracker.h"
 
 
 #ifdef _WIN32
@@ -33,6 +35,7 @@ namespace NCL {
 
 		class OGLMesh;
 		class OGLShader;
+		enum class ShaderUniform;
 
 		class SimpleFont;
 
@@ -54,13 +57,25 @@ namespace NCL {
 
 			virtual bool SetVerticalSync(VerticalSyncState s);
 
+			void ExecuteCommandBuffer(const RenderCommandBuffer& buffer) override;
+
 			void DrawString(const std::string& text, const Vector2&pos, const Vector4& colour = Vector4(0.75f, 0.75f, 0.75f,1));
+			void DrawString(const char* text, size_t length, const Vector2&pos, const Vector4& colour = Vector4(0.75f, 0.75f, 0.75f,1));
 			void DrawLine(const Vector3& start, const Vector3& end, const Vector4& colour);
 
 			virtual void SetupDebugMatrix(OGLShader*s) {
 
 			}
 
+			//GL calls issued and skipped as redundant over the last full frame
+			const OGLStateTracker::Counters& GetStateCounters() const {
+				return lastFrameCounters;
+			}
+
+			int GetDrawCallCount() const {
+				return lastFrameDrawCalls;
+			}
+
 		protected:			
 			void BeginFrame()	override;
 			void RenderFrame()	override;
@@ -71,21 +86,28 @@ namespace NCL {
 			void DrawDebugLines();
 
 			void BindShader(ShaderBase*s);
-			void BindTextureToShader(const TextureBase*t, const std::string& uniform, int texUnit) const;
+			void BindTextureToShader(const TextureBase*t, const std::string& uniform, int texUnit);
+			void BindTextureToShader(const TextureBase*t, ShaderUniform uniform, int texUnit);
+			void BindTextureToSlot(const TextureBase*t, int slot, int texUnit);
 			void BindMesh(MeshGeometry*m);
-			void DrawBoundMesh(int subLayer = 0, int numInstances = 1);
+			void DrawBoundMesh(int subLayer = 0, int numInstances = 1, int baseInstance = 0);
 #ifdef _WIN32
 			void InitWithWin32(Window& w);
 			void DestroyWithWin32();
 			HDC		deviceContext;		//...Device context?
 			HGLRC	renderContext;		//Permanent Rendering Context		
 #endif
+			OGLStateTracker				glState;
+			OGLStateTracker::Counters	lastFrameCounters;
+			int							drawCalls;
+			int							lastFrameDrawCalls;
+
 		private:
 			struct DebugString {
 				Maths::Vector4 colour;
 				Maths::Vector2	ndcPos;
 				float			size;
-				std::string		text;
+				FrameString		text;
 			};
 
 			struct DebugLine {
@@ -99,8 +121,10 @@ namespace NCL {
 
 			OGLShader*  debugShader;
 			SimpleFont* font;
-			std::vector<DebugString>	debugStrings;
-			std::vector<DebugLine>		debugLines;
+			OGLMesh*	debugTextMesh;	// Kept between frames, and streamed into
+			OGLMesh*	debugLineMesh;
+			FrameVector<DebugString>	debugStrings;
+			FrameVector<DebugLine>		debugLines;
 
 			bool initState;
 			bool forceValidDebugState;
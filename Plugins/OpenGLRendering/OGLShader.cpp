@@ -8,7 +8,17 @@ https://research.ncl.ac.uk/game/
 */
 #include "OGLShader.h"
 #include "../../Common/Assets.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 using namespace NCL;
 using namespace NCL::Rendering;
@@ -29,14 +39,82 @@ string ShaderNames[ShaderStages::SHADER_MAX] = {
 	"Tess. Eval"
 };
 
+const char* UniformNames[(int)ShaderUniform::MAX] = {
+	"projMatrix",
+	"viewMatrix",
+	"modelMatrix",
+	"shadowMatrix",
+	"mvpMatrix",
+	"viewProjMatrix",
+	"objectColour",
+	"hasVertexColours",
+	"hasTexture",
+	"useMatrix",
+	"lightPos",
+	"lightColour",
+	"lightRadius",
+	"cameraPos",
+	"mainTex",
+	"shadowTex"
+};
+
+std::map<uint64_t, OGLShader::CachedProgram>	OGLShader::programCache;
+string											OGLShader::programCacheDirectory;
+
+namespace {
+	const char		BINARY_MAGIC[4]		= { 'N', 'P', 'R', 'G' };
+	const uint32_t	BINARY_VERSION		= 1;
+
+	struct ProgramBinaryHeader {
+		char		magic[4];
+		uint32_t	version;
+		uint64_t	driverHash;	// Binaries only work on the driver that made them
+		uint32_t	format;		// As given by glGetProgramBinary
+		uint32_t	length;
+	};
+
+	//64 bit FNV-1a
+	const uint64_t HASH_START = 14695981039346656037ull;
+
+	uint64_t Hash(uint64_t hash, const void* data, size_t length) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < length; ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t Hash(uint64_t hash, const char* text) {
+		return Hash(hash, text ? text : "", text ? strlen(text) + 1 : 1);
+	}
+
+	string BinaryFilename(const string& directory, uint64_t hash) {
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+		return directory + name;
+	}
+
+	void MakeDirectory(const string& directory) {
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+}
+
 OGLShader::OGLShader(const string& vertex, const string& fragment, const string& geometry, const string& domain, const string& hull) :
 	ShaderBase(vertex, fragment, geometry, domain, hull) {
 
 	for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
-		shaderIDs[i]	= 0;
 		shaderValid[i]	= 0;
 	}
-	programID = 0;
+	for (int i = 0; i < (int)ShaderUniform::MAX; ++i) {
+		uniformSlots[i] = -1;
+	}
+	programID		= 0;
+	programValid	= GL_FALSE;
+	sourceHash		= 0;
 
 	ReloadShader();
 }
@@ -45,39 +123,185 @@ OGLShader::~OGLShader()	{
 	DeleteIDs();
 }
 
+ShaderBase* OGLShader::ShaderFromFilenames(const string& vertex, const string& fragment) {
+	return new OGLShader(vertex, fragment);
+}
+
+void OGLShader::SetProgramCacheDirectory(const string& directory) {
+	programCacheDirectory = directory;
+}
+
+/*
+The sources are always read, as they're what the program is looked up by,
+but are only compiled if no other shader is using the same program and
+there's no usable binary of it on disk.
+*/
 void OGLShader::ReloadShader() {
 	DeleteIDs();
+
+	string		sources[ShaderStages::SHADER_MAX];
+	uint64_t	hash = HASH_START;
+	for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
+		if (shaderFiles[i].empty()) {
+			continue;
+		}
+		if (!Assets::ReadTextFile(Assets::SHADERDIR + shaderFiles[i], sources[i])) {
+			std::cout << "Can't read " << ShaderNames[i] << " shader " << shaderFiles[i] << std::endl;
+		}
+		hash = Hash(hash, &i, sizeof(i));
+		hash = Hash(hash, sources[i].c_str());
+	}
+	sourceHash = hash;
+
+	auto cached = programCache.find(hash);
+	if (cached != programCache.end()) {
+		cached->second.references++;
+		programID		= cached->second.programID;
+		programValid	= GL_TRUE;
+		for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
+			shaderValid[i] = sources[i].empty() ? 0 : GL_TRUE;
+		}
+		ReflectUniforms();
+		return;
+	}
+
 	programID = glCreateProgram();
-	string fileContents = "";
+	if (LoadProgramBinary(programID, hash)) {
+		programValid = GL_TRUE;
+		for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
+			shaderValid[i] = sources[i].empty() ? 0 : GL_TRUE;
+		}
+		std::cout << "Shader loaded from program cache!" << std::endl;
+	}
+	else {
+		CompileProgram(sources);
+		if (programValid == GL_TRUE) {
+			SaveProgramBinary(programID, hash);
+		}
+	}
+	if (programValid == GL_TRUE) {
+		programCache.insert(std::make_pair(hash, CachedProgram{ programID, 1 }));
+	}
+	ReflectUniforms();
+}
+
+/*
+Array uniforms are reported as "name[0]", so they're stored under just
+"name", which is what glGetUniformLocation would be asked for.
+*/
+void OGLShader::ReflectUniforms() {
+	uniforms.clear();
+	uniformBlocks.clear();
+	for (int i = 0; i < (int)ShaderUniform::MAX; ++i) {
+		uniformSlots[i] = -1;
+	}
+	if (programValid != GL_TRUE) {
+		return;
+	}
+	GLint uniformCount	= 0;
+	GLint maxNameLength	= 0;
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<char> name(maxNameLength > 0 ? maxNameLength : 1);
+	for (GLint i = 0; i < uniformCount; ++i) {
+		GLsizei length	= 0;
+		GLint	size	= 0;
+		GLenum	type	= 0;
+		glGetActiveUniform(programID, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+		GLint location = glGetUniformLocation(programID, name.data());
+		if (location < 0) {
+			continue; // Part of a uniform block
+		}
+		if (length > 3 && strcmp(&name[length - 3], "[0]") == 0) {
+			length -= 3;
+		}
+		uniforms.push_back({ NameID(name.data(), length), location });
+	}
+
+	GLint blockCount = 0;
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+	name.resize(maxNameLength > 0 ? maxNameLength : 1);
+	for (GLint i = 0; i < blockCount; ++i) {
+		GLsizei length = 0;
+		glGetActiveUniformBlockName(programID, i, (GLsizei)name.size(), &length, name.data());
+		uniformBlocks.push_back({ NameID(name.data(), length), i });
+	}
+
+	auto byID = [](const ReflectedName& a, const ReflectedName& b) { return a.nameID < b.nameID; };
+	std::sort(uniforms.begin(), uniforms.end(), byID);
+	std::sort(uniformBlocks.begin(), uniformBlocks.end(), byID);
+
+	for (int i = 0; i < (int)ShaderUniform::MAX; ++i) {
+		uniformSlots[i] = GetUniformLocation(UniformNames[i]);
+	}
+}
+
+GLint OGLShader::GetUniformLocation(const string& name) const {
+	uint32_t nameID = NameID(name.c_str(), name.length());
+	auto i = std::lower_bound(uniforms.begin(), uniforms.end(), nameID,
+		[](const ReflectedName& a, uint32_t id) { return a.nameID < id; });
+	return (i != uniforms.end() && i->nameID == nameID) ? i->location : -1;
+}
+
+GLint OGLShader::GetUniformBlockIndex(const string& name) const {
+	uint32_t nameID = NameID(name.c_str(), name.length());
+	auto i = std::lower_bound(uniformBlocks.begin(), uniformBlocks.end(), nameID,
+		[](const ReflectedName& a, uint32_t id) { return a.nameID < id; });
+	return (i != uniformBlocks.end() && i->nameID == nameID) ? i->location : (GLint)GL_INVALID_INDEX;
+}
+
+//32 bit FNV-1a - a shader only has a handful of uniforms, so collisions aren't a worry
+uint32_t OGLShader::NameID(const char* name, size_t length) {
+	uint32_t id = 2166136261u;
+	for (size_t i = 0; i < length; ++i) {
+		id = (id ^ (unsigned char)name[i]) * 16777619u;
+	}
+	return id;
+}
+
+void OGLShader::CompileProgram(const string* sources) {
+	GLuint shaderIDs[ShaderStages::SHADER_MAX] = { 0 };
+
 	for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
-		if (!shaderFiles[i].empty()) {
-			if (Assets::ReadTextFile(Assets::SHADERDIR + shaderFiles[i], fileContents)) {
-				shaderIDs[i] = glCreateShader(shaderTypes[i]);
-
-				std::cout << "Reading " << ShaderNames[i] << " shader " << shaderFiles[i] << std::endl;
-
-				const char* stringData	 = fileContents.c_str();
-				int			stringLength = (int)fileContents.length();
-				glShaderSource(shaderIDs[i], 1, &stringData, &stringLength);
-				glCompileShader(shaderIDs[i]);
-
-				glGetShaderiv(shaderIDs[i], GL_COMPILE_STATUS, &shaderValid[i]);
-		
-				if (shaderValid[i] != GL_TRUE) {
-					std::cout << ShaderNames[i] << " shader " << " has failed!" << std::endl;
-				}
-				else {
-					glAttachShader(programID, shaderIDs[i]);
-				}
-				PrintCompileLog(shaderIDs[i]);
-			}
+		if (sources[i].empty()) {
+			continue;
 		}
-	}	
+		shaderIDs[i] = glCreateShader(shaderTypes[i]);
+
+		std::cout << "Reading " << ShaderNames[i] << " shader " << shaderFiles[i] << std::endl;
+
+		const char* stringData	 = sources[i].c_str();
+		int			stringLength = (int)sources[i].length();
+		glShaderSource(shaderIDs[i], 1, &stringData, &stringLength);
+		glCompileShader(shaderIDs[i]);
+
+		glGetShaderiv(shaderIDs[i], GL_COMPILE_STATUS, &shaderValid[i]);
+
+		if (shaderValid[i] != GL_TRUE) {
+			std::cout << ShaderNames[i] << " shader " << " has failed!" << std::endl;
+		}
+		else {
+			glAttachShader(programID, shaderIDs[i]);
+		}
+		PrintCompileLog(shaderIDs[i]);
+	}
+	glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(programID);
 	glGetProgramiv(programID, GL_LINK_STATUS, &programValid);
 
 	PrintLinkLog(programID);
 
+	//The program doesn't need them once it's linked
+	for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
+		if (shaderIDs[i]) {
+			glDetachShader(programID, shaderIDs[i]);
+			glDeleteShader(shaderIDs[i]);
+		}
+	}
+
 	if (programValid != GL_TRUE) {
 		std::cout << "This shader has failed!" << std::endl;
 	}
@@ -86,15 +310,89 @@ void OGLShader::ReloadShader() {
 	}
 }
 
+/*
+A binary from a different driver, or one the driver rejects anyway, just
+means compiling from source as normal - it'll be written over afterwards.
+*/
+bool OGLShader::LoadProgramBinary(GLuint program, uint64_t hash) {
+	if (programCacheDirectory.empty()) {
+		return false;
+	}
+	std::ifstream file(BinaryFilename(programCacheDirectory, hash), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	ProgramBinaryHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+		header.version != BINARY_VERSION || header.driverHash != GetDriverHash()) {
+		return false;
+	}
+	std::vector<char> binary(header.length);
+	if (!file.read(binary.data(), binary.size())) {
+		return false;
+	}
+	glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	return linked == GL_TRUE;
+}
+
+void OGLShader::SaveProgramBinary(GLuint program, uint64_t hash) {
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (programCacheDirectory.empty() || formatCount == 0) {
+		return;
+	}
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+	std::vector<char>	binary(length);
+	GLenum				format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	MakeDirectory(programCacheDirectory);
+	std::ofstream file(BinaryFilename(programCacheDirectory, hash), std::ios::binary);
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't write to " << programCacheDirectory << std::endl;
+		return;
+	}
+	ProgramBinaryHeader header;
+	memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	header.version		= BINARY_VERSION;
+	header.driverHash	= GetDriverHash();
+	header.format		= format;
+	header.length		= (uint32_t)length;
+
+	file.write((const char*)&header, sizeof(header));
+	file.write(binary.data(), length);
+}
+
+uint64_t OGLShader::GetDriverHash() {
+	static uint64_t driverHash = 0;
+	if (driverHash == 0) {
+		driverHash = HASH_START;
+		driverHash = Hash(driverHash, (const char*)glGetString(GL_VENDOR));
+		driverHash = Hash(driverHash, (const char*)glGetString(GL_RENDERER));
+		driverHash = Hash(driverHash, (const char*)glGetString(GL_VERSION));
+		driverHash = Hash(driverHash, (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION));
+	}
+	return driverHash;
+}
+
 void	OGLShader::DeleteIDs() {
 	if (!programID) {
 		return;
 	}
-	for (size_t i = 0; i < ShaderStages::SHADER_MAX; ++i) {
-		if (shaderIDs[i]) {
-			glDetachShader(programID, shaderIDs[i]);
-			glDeleteShader(shaderIDs[i]);
+	auto cached = programCache.find(sourceHash);
+	if (cached != programCache.end() && cached->second.programID == programID) {
+		if (--cached->second.references > 0) {
+			programID = 0;
+			return;
 		}
+		programCache.erase(cached);
 	}
 	glDeleteProgram(programID);
 	programID = 0;
@@ -8,10 +8,38 @@ https://research.ncl.ac.uk/game/
 */
 #pragma once
 #include "../../Common/ShaderBase.h"
-#include "glad\glad.h"
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
 
 namespace NCL {
 	namespace Rendering {
+		/*
+		The uniforms the renderers set every frame. Each is looked up once
+		when a shader links, so drawing only ever needs the enum as a slot.
+		*/
+		enum class ShaderUniform {
+			ProjMatrix,
+			ViewMatrix,
+			ModelMatrix,
+			ShadowMatrix,
+			MvpMatrix,
+			ViewProjMatrix,
+			ObjectColour,
+			HasVertexColours,
+			HasTexture,
+			UseMatrix,
+			LightPos,
+			LightColour,
+			LightRadius,
+			CameraPos,
+			MainTex,
+			ShadowTex,
+			MAX
+		};
+
 		class OGLShader : public ShaderBase
 		{
 		public:
@@ -28,17 +56,67 @@ namespace NCL {
 			int GetProgramID() const {
 				return programID;
 			}	
+
+			//-1 if the shader doesn't use it, just like glGetUniformLocation
+			GLint GetUniformLocation(ShaderUniform uniform) const {
+				return uniformSlots[(int)uniform];
+			}
+			GLint GetUniformLocation(const string& name) const;
+			GLint GetUniformBlockIndex(const string& name) const;
 			
+			static ShaderBase* ShaderFromFilenames(const string& vertex, const string& fragment);
+
 			static void	PrintCompileLog(GLuint object);
 			static void	PrintLinkLog(GLuint program);
 
+			/*
+			Linked programs are saved here with glGetProgramBinary, and loaded
+			back instead of compiling the next time the same sources are used
+			on the same driver. An empty directory turns this off.
+			*/
+			static void SetProgramCacheDirectory(const string& directory);
+
 		protected:
 			void	DeleteIDs();
+			void	CompileProgram(const string* sources);
+
+			static bool LoadProgramBinary(GLuint program, uint64_t hash);
+			static void SaveProgramBinary(GLuint program, uint64_t hash);
+			static uint64_t GetDriverHash();
+
+			void ReflectUniforms();
+			static uint32_t NameID(const char* name, size_t length);
+
+			/*
+			Every active uniform and block, found with glGetActiveUniform after
+			linking, kept sorted by name ID so a lookup is a binary search
+			rather than a trip into the driver.
+			*/
+			struct ReflectedName {
+				uint32_t	nameID;
+				GLint		location;	// Or block index
+			};
+			std::vector<ReflectedName>	uniforms;
+			std::vector<ReflectedName>	uniformBlocks;
+			GLint						uniformSlots[(int)ShaderUniform::MAX];
+
+			GLuint		programID;
+			int			shaderValid[ShaderStages::SHADER_MAX];
+			int			programValid;
+			uint64_t	sourceHash;
 
-			GLuint	programID;
-			GLuint	shaderIDs[ShaderStages::SHADER_MAX];
-			int		shaderValid[ShaderStages::SHADER_MAX];
-			int		programValid;
+			/*
+			Shaders with exactly the same source share one program, however
+			many OGLShaders are made from them. Uniforms belong to the program,
+			so they're shared too - which is fine, as the renderer sets them
+			before every draw anyway.
+			*/
+			struct CachedProgram {
+				GLuint	programID;
+				int		references;
+			};
+			static std::map<uint64_t, CachedProgram>	programCache;
+			static string								programCacheDirectory;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "OGLStateTracker.h"
+#include "glad/glad.h"
+
+using namespace NCL;
+using namespace NCL::Rendering;
+
+//No real object or state uses this, so it never matches what's asked for
+const GLuint UNKNOWN_STATE = ~0u;
+
+OGLStateTracker::OGLStateTracker() {
+	counters = { 0, 0 };
+	Invalidate();
+}
+
+void OGLStateTracker::Invalidate() {
+	program			= UNKNOWN_STATE;
+	vao				= UNKNOWN_STATE;
+	activeUnit		= UNKNOWN_STATE;
+	cullEnabled		= UNKNOWN_STATE;
+	cullFace		= UNKNOWN_STATE;
+	depthEnabled	= UNKNOWN_STATE;
+	blendEnabled	= UNKNOWN_STATE;
+	for (int i = 0; i < MAX_TEXTURE_UNITS; ++i) {
+		textures[i] = UNKNOWN_STATE;
+	}
+	for (int i = 0; i < MAX_BUFFER_BINDINGS; ++i) {
+		uniformBuffers[i] = UNKNOWN_STATE;
+	}
+}
+
+bool OGLStateTracker::Changed(GLuint& current, GLuint value) {
+	if (current == value) {
+		counters.elided++;
+		return false;
+	}
+	current = value;
+	counters.issued++;
+	return true;
+}
+
+void OGLStateTracker::UseProgram(GLuint newProgram) {
+	if (Changed(program, newProgram)) {
+		glUseProgram(newProgram);
+	}
+}
+
+void OGLStateTracker::BindVertexArray(GLuint newVAO) {
+	if (Changed(vao, newVAO)) {
+		glBindVertexArray(newVAO);
+	}
+}
+
+//Only the active unit switch is skipped if just the texture is new
+void OGLStateTracker::BindTexture(int unit, GLuint texture) {
+	if (unit < 0 || unit >= MAX_TEXTURE_UNITS) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		activeUnit = UNKNOWN_STATE;
+		counters.issued += 2;
+		return;
+	}
+	if (textures[unit] == texture) {
+		counters.elided += 2;
+		return;
+	}
+	if (Changed(activeUnit, unit)) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+	textures[unit] = texture;
+	counters.issued++;
+	glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void OGLStateTracker::BindUniformBuffer(GLuint index, GLuint buffer) {
+	if (index >= MAX_BUFFER_BINDINGS) {
+		glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+		counters.issued++;
+		return;
+	}
+	if (Changed(uniformBuffers[index], buffer)) {
+		glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+	}
+}
+
+void OGLStateTracker::SetCullFace(bool enabled) {
+	SetCullFace(enabled, GL_BACK);
+}
+
+void OGLStateTracker::SetCullFace(bool enabled, GLenum face) {
+	if (Changed(cullEnabled, enabled ? GL_TRUE : GL_FALSE)) {
+		if (enabled) {
+			glEnable(GL_CULL_FACE);
+		}
+		else {
+			glDisable(GL_CULL_FACE);
+		}
+	}
+	if (enabled && Changed(cullFace, face)) {
+		glCullFace(face);
+	}
+}
+
+void OGLStateTracker::SetDepthTest(bool enabled) {
+	if (Changed(depthEnabled, enabled ? GL_TRUE : GL_FALSE)) {
+		if (enabled) {
+			glEnable(GL_DEPTH_TEST);
+		}
+		else {
+			glDisable(GL_DEPTH_TEST);
+		}
+	}
+}
+
+void OGLStateTracker::SetBlend(bool enabled) {
+	if (Changed(blendEnabled, enabled ? GL_TRUE : GL_FALSE)) {
+		if (enabled) {
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else {
+			glDisable(GL_BLEND);
+		}
+	}
+}
+
+OGLStateTracker::Counters OGLStateTracker::ResetCounters() {
+	Counters last = counters;
+	counters = { 0, 0 };
+	return last;
+}
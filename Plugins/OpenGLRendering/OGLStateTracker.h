@@ -0,0 +1,76 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+
+namespace NCL {
+	namespace Rendering {
+		/*
+		Remembers what the renderer last set the GL context to, so binding the
+		same program, vertex array or texture twice in a row never reaches the
+		driver. Every call is counted as either issued or elided. GL types are
+		left out of the header, as OGLRenderer.h is included by code that
+		never sees glad.
+
+		Anything that changes these bindings without going through here - mesh
+		and texture uploads both do - leaves the tracker out of date, so
+		Invalidate has to be called afterwards. It's cheap: everything is just
+		marked as unknown, and the next call of each kind is always issued.
+		*/
+		class OGLStateTracker {
+		public:
+			static const int MAX_TEXTURE_UNITS		= 16;
+			static const int MAX_BUFFER_BINDINGS	= 16;
+
+			struct Counters {
+				int issued;
+				int elided;
+			};
+
+			OGLStateTracker();
+
+			void Invalidate();
+
+			void UseProgram(unsigned int program);
+			void BindVertexArray(unsigned int vao);
+			void BindTexture(int unit, unsigned int texture);
+			void BindUniformBuffer(unsigned int index, unsigned int buffer);
+
+			void SetCullFace(bool enabled);
+			void SetCullFace(bool enabled, unsigned int face);
+			void SetDepthTest(bool enabled);
+			void SetBlend(bool enabled); //Alpha blending, the only kind used
+
+			unsigned int GetProgram() const {
+				return program;
+			}
+
+			//Zeroes the counters, returning what they were
+			Counters ResetCounters();
+
+			const Counters& GetCounters() const {
+				return counters;
+			}
+
+		protected:
+			bool Changed(unsigned int& current, unsigned int value);
+
+			unsigned int	program;
+			unsigned int	vao;
+			unsigned int	activeUnit;
+			unsigned int	textures[MAX_TEXTURE_UNITS];
+			unsigned int	uniformBuffers[MAX_BUFFER_BINDINGS];
+			unsigned int	cullEnabled;
+			unsigned int	cullFace;
+			unsigned int	depthEnabled;
+			unsigned int	blendEnabled;
+
+			Counters		counters;
+		};
+	}
+}
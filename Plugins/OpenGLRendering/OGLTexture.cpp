@@ -11,6 +11,8 @@ https://research.ncl.ac.uk/game/
 
 #include "../../Common/TextureLoader.h"
 
+#include <iostream>
+
 using namespace NCL;
 using namespace NCL::Rendering;
 
@@ -29,46 +31,79 @@ OGLTexture::~OGLTexture()
 }
 
 TextureBase* OGLTexture::RGBATextureFromData(char* data, int width, int height, int channels) {
-	OGLTexture* tex = new OGLTexture();
+	TextureFormat format = TextureContainer::FormatFromChannels(channels);
 
-	int dataSize = width * height * channels; //This always assumes data is 1 byte per channel
+	TextureContainer::Level level = { width, height, data, TextureContainer::GetLevelSize(format, width, height) };
+	TextureContainer image;
+	image.SetLevels(format, channels >= 3, &level, 1);
 
-	int sourceType = GL_RGB;
-
-	switch (channels) {
-		case 1: sourceType = GL_RED	; break;
+	OGLTexture* tex = new OGLTexture();
+	tex->Upload(image);
+	return tex;
+}
 
-		case 2: sourceType = GL_RG	; break;
-		case 3: sourceType = GL_RGB	; break;
-		case 4: sourceType = GL_RGBA; break;
-		//default:
+TextureBase* OGLTexture::RGBATextureFromFilename(const std::string&name) {
+	TextureContainer image;
+	if (!image.LoadFile(name)) {
+		std::cout << __FUNCTION__ << " can't load " << name << std::endl;
 	}
+	OGLTexture* tex = new OGLTexture();
+	tex->Upload(image);
+	return tex;
+}
 
-	glBindTexture(GL_TEXTURE_2D, tex->texID);
+TextureBase* OGLTexture::CreateTexture() {
+	return new OGLTexture();
+}
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, sourceType, GL_UNSIGNED_BYTE, data);
+void OGLTexture::UploadTextureData(TextureBase* texture, const TextureContainer& image) {
+	((OGLTexture*)texture)->Upload(image);
+}
+
+/*
+Each format gets the smallest sized internal format that holds it, rather
+than everything going into 32-bit floats - colour data is sRGB, so the
+shaders get it back linear. Block compressed levels go up untouched.
+*/
+void OGLTexture::Upload(const TextureContainer& image) {
+	if (image.GetLevelCount() == 0) {
+		return;
+	}
+	bool	sRGB			= image.IsSRGB();
+	GLenum	internalFormat	= GL_RGBA8;
+	GLenum	sourceType		= GL_RGBA;
+
+	switch (image.GetFormat()) {
+		case TextureFormat::R8:		internalFormat = GL_R8;		sourceType = GL_RED;	break;
+		case TextureFormat::RG8:	internalFormat = GL_RG8;	sourceType = GL_RG;		break;
+		case TextureFormat::RGB8:	internalFormat = sRGB ? GL_SRGB8 : GL_RGB8;	sourceType = GL_RGB;	break;
+		case TextureFormat::RGBA8:	internalFormat = sRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;	break;
+		case TextureFormat::BC1:	internalFormat = sRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;			break;
+		case TextureFormat::BC3:	internalFormat = sRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;	break;
+		case TextureFormat::BC7:	internalFormat = sRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;		break;
+	}
+	glBindTexture(GL_TEXTURE_2D, texID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB and single channel rows aren't always a multiple of 4 bytes
+
+	for (int i = 0; i < image.GetLevelCount(); ++i) {
+		const TextureContainer::Level& level = image.GetLevel(i);
+		if (TextureContainer::IsCompressed(image.GetFormat())) {
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, (GLsizei)level.size, level.data);
+		}
+		else {
+			glTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, sourceType, GL_UNSIGNED_BYTE, level.data);
+		}
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	glGenerateMipmap(GL_TEXTURE_2D);
-
+	if (image.GetLevelCount() > 1) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.GetLevelCount() - 1);
+	}
+	else {
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
 	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return tex;
 }
-
-TextureBase* OGLTexture::RGBATextureFromFilename(const std::string&name) {
-	char* texData	= nullptr;
-	int width		= 0;
-	int height		= 0;
-	int channels	= 0;
-	int flags		= 0;
-	TextureLoader::LoadTexture(name, texData, width, height, channels, flags);
-
-	TextureBase* glTex = RGBATextureFromData(texData, width, height, channels);
-
-	free(texData);
-
-	return glTex;
-}
\ No newline at end of file
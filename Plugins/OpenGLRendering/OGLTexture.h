@@ -8,7 +8,8 @@ https://research.ncl.ac.uk/game/
 */
 #pragma once
 #include "../../Common/TextureBase.h"
-#include "glad\glad.h"
+#include "../../Common/TextureContainer.h"
+#include "glad/glad.h"
 
 #include <string>
 
@@ -26,10 +27,16 @@ namespace NCL {
 
 			static TextureBase* RGBATextureFromFilename(const std::string&name);
 
+			//For streamed textures, which are made empty and filled in once their file has been read
+			static TextureBase* CreateTexture();
+			static void UploadTextureData(TextureBase* texture, const TextureContainer& image);
+
 			GLuint GetObjectID() const	{
 				return texID;
 			}
 		protected:						
+			void Upload(const TextureContainer& image);
+
 			GLuint texID;
 		};
 	}